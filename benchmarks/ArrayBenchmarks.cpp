@@ -0,0 +1,483 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/concurrency/ParallelBulk.cpp"
+#include "../src/data_structures/array/ChunkedOrderedArray.cpp"
+#include "../src/data_structures/array/ConcurrentOrderedArray.cpp"
+#include "../src/data_structures/array/DynamicArray.cpp"
+#include "../src/data_structures/array/OrderedArray.cpp"
+#include "../src/data_structures/array/OrderedSetOperations.cpp"
+#include "BenchmarkInputs.cpp"
+
+// Lookups per find benchmark iteration, drawn from the stored keys.
+constexpr size_t probeCount = 1024;
+
+template <typename T>
+std::vector<T> makeProbes(const std::vector<T> &input, size_t count) {
+  std::mt19937_64 random(count);
+  std::vector<T> probes;
+  probes.reserve(count);
+
+  for (size_t i = 0; i < count; ++i) {
+    probes.push_back(input[random() % input.size()]);
+  }
+
+  return probes;
+}
+
+template <typename T>
+void benchmarkDynamicArrayInsertAtEnd(benchmark::State &state,
+                                      Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+
+  for (auto _ : state) {
+    DynamicArray<T> array;
+
+    for (const T &value : input) {
+      array.insert(array.getSize(), value);
+    }
+
+    benchmark::DoNotOptimize(array.begin());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void benchmarkDynamicArrayPushBack(benchmark::State &state,
+                                   Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+
+  for (auto _ : state) {
+    DynamicArray<T> array;
+
+    for (const T &value : input) {
+      array.push_back(value);
+    }
+
+    benchmark::DoNotOptimize(array.begin());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Many short-lived arrays of eight elements each, where allocation
+// dominates; `Array` is DynamicArray with or without inline capacity.
+template <typename Array, typename T>
+void benchmarkSmallArrays(benchmark::State &state, Distribution distribution) {
+  constexpr size_t smallSize = 8;
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+
+  for (auto _ : state) {
+    for (size_t start = 0; start + smallSize <= input.size();
+         start += smallSize) {
+      Array array;
+
+      for (size_t i = start; i < start + smallSize; ++i) {
+        array.push_back(input[i]);
+      }
+
+      benchmark::DoNotOptimize(array.begin());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void benchmarkVectorPushBack(benchmark::State &state,
+                             Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+
+  for (auto _ : state) {
+    std::vector<T> array;
+
+    for (const T &value : input) {
+      array.push_back(value);
+    }
+
+    benchmark::DoNotOptimize(array.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// A value that is never stored, so every find scans the whole array.
+template <typename T>
+void benchmarkDynamicArrayFindMissing(benchmark::State &state,
+                                      Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+  const T missing = KeyMaker<T>::make(UINT32_MAX);
+  DynamicArray<T> array;
+
+  for (const T &value : input) {
+    array.push_back(value);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(array.find(missing));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+/**
+ * Pool shared by the parallel benchmarks: one worker per hardware thread
+ * besides the caller.
+ */
+inline ThreadPool &benchmarkPool() {
+  static ThreadPool pool(ThreadPool::defaultThreadCount() - 1);
+  return pool;
+}
+
+template <typename T>
+void benchmarkDynamicArrayParallelFindMissing(benchmark::State &state,
+                                              Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+  const T missing = KeyMaker<T>::make(UINT32_MAX);
+  DynamicArray<T> array;
+
+  for (const T &value : input) {
+    array.push_back(value);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(parallelFind(array, missing, benchmarkPool()));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void benchmarkVectorFindMissing(benchmark::State &state,
+                                Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+  const T missing = KeyMaker<T>::make(UINT32_MAX);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::find(input.begin(), input.end(), missing));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void benchmarkOrderedArrayInsert(benchmark::State &state,
+                                 Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+
+  for (auto _ : state) {
+    OrderedArray<T> array;
+
+    for (const T &value : input) {
+      array.insert(value);
+    }
+
+    benchmark::DoNotOptimize(array.begin());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void benchmarkOrderedArrayInsertRange(benchmark::State &state,
+                                      Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+
+  for (auto _ : state) {
+    OrderedArray<T> array;
+    array.insertRange(input.begin(), input.end());
+    benchmark::DoNotOptimize(array.begin());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void benchmarkOrderedArrayFind(benchmark::State &state,
+                               Distribution distribution, bool frozen) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+  std::vector<T> probes = makeProbes(input, probeCount);
+  OrderedArray<T> array;
+  array.insertRange(input.begin(), input.end());
+
+  if (frozen) {
+    array.freeze();
+  }
+
+  for (auto _ : state) {
+    for (const T &probe : probes) {
+      benchmark::DoNotOptimize(array.find(probe));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+template <typename T>
+void benchmarkOrderedArrayFindLearned(benchmark::State &state,
+                                      Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+  std::vector<T> probes = makeProbes(input, probeCount);
+  OrderedArray<T> array;
+  array.insertRange(input.begin(), input.end());
+  array.freezeLearned();
+
+  for (auto _ : state) {
+    for (const T &probe : probes) {
+      benchmark::DoNotOptimize(array.find(probe));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * probes.size());
+  state.counters["indexBytes"] =
+      static_cast<double>(array.getLearnedIndexBytes());
+}
+
+// Intersects the first and last two thirds of the input, or `probeCount`
+// keys with the whole input when `galloping` is set.
+template <typename T>
+void benchmarkOrderedArrayIntersection(benchmark::State &state,
+                                       Distribution distribution,
+                                       bool galloping) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+  OrderedArray<T> left;
+  OrderedArray<T> right;
+
+  if (galloping) {
+    std::vector<T> probes = makeProbes(input, probeCount);
+    left.insertRange(probes.begin(), probes.end());
+    right.insertRange(input.begin(), input.end());
+  } else {
+    left.insertRange(input.begin(), input.begin() + input.size() * 2 / 3);
+    right.insertRange(input.begin() + input.size() / 3, input.end());
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(setIntersection(left, right).getSize());
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          (left.getSize() + right.getSize()));
+}
+
+template <typename T>
+void benchmarkChunkedOrderedArrayInsert(benchmark::State &state,
+                                        Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+
+  for (auto _ : state) {
+    ChunkedOrderedArray<T> array;
+
+    for (const T &value : input) {
+      array.insert(value);
+    }
+
+    benchmark::DoNotOptimize(array.getBlockCount());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void benchmarkChunkedOrderedArrayFind(benchmark::State &state,
+                                      Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+  std::vector<T> probes = makeProbes(input, probeCount);
+  ChunkedOrderedArray<T> array;
+  array.insertRange(input.begin(), input.end());
+
+  for (auto _ : state) {
+    for (const T &probe : probes) {
+      benchmark::DoNotOptimize(array.find(probe));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+template <typename T>
+void benchmarkVectorLowerBound(benchmark::State &state,
+                               Distribution distribution) {
+  std::vector<T> input = makeInput<T>(state.range(0), distribution);
+  std::vector<T> probes = makeProbes(input, probeCount);
+  std::sort(input.begin(), input.end());
+
+  for (auto _ : state) {
+    for (const T &probe : probes) {
+      benchmark::DoNotOptimize(
+          std::lower_bound(input.begin(), input.end(), probe));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+// Keys in the table shared by the concurrent lookup benchmarks.
+constexpr size_t concurrentTableSize = 1000000;
+
+const std::vector<int64_t> &concurrentTableKeys() {
+  static const std::vector<int64_t> keys =
+      makeInput<int64_t>(concurrentTableSize, Distribution::Random);
+
+  return keys;
+}
+
+// Baseline for ConcurrentOrderedArray: every lookup takes a shared lock.
+void benchmarkSharedMutexFind(benchmark::State &state) {
+  static std::shared_mutex mutex;
+  static const OrderedArray<int64_t> table = [] {
+    OrderedArray<int64_t> array;
+    array.insertRange(concurrentTableKeys().begin(),
+                      concurrentTableKeys().end());
+    return array;
+  }();
+  std::vector<int64_t> probes = makeProbes(concurrentTableKeys(), probeCount);
+
+  for (auto _ : state) {
+    for (int64_t probe : probes) {
+      std::shared_lock<std::shared_mutex> lock(mutex);
+      benchmark::DoNotOptimize(table.find(probe));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+void benchmarkConcurrentOrderedArrayFind(benchmark::State &state) {
+  static const std::unique_ptr<ConcurrentOrderedArray<int64_t>> table = [] {
+    auto array = std::make_unique<ConcurrentOrderedArray<int64_t>>();
+    array->insertRange(concurrentTableKeys().begin(),
+                       concurrentTableKeys().end());
+    array->publish();
+    return array;
+  }();
+  std::vector<int64_t> probes = makeProbes(concurrentTableKeys(), probeCount);
+  ConcurrentOrderedArray<int64_t>::Reader reader(*table);
+
+  for (auto _ : state) {
+    for (int64_t probe : probes) {
+      benchmark::DoNotOptimize(reader.contains(probe));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+template <typename Function>
+benchmark::internal::Benchmark *
+registerArrayBenchmark(const std::string &operation, const std::string &type,
+                       Distribution distribution, int64_t maxSize,
+                       Function function) {
+  std::string name =
+      operation + "/" + type + "/" + distributionName(distribution);
+
+  return benchmark::RegisterBenchmark(
+             name.c_str(),
+             [distribution, function](benchmark::State &s) {
+               function(s, distribution);
+             })
+      ->RangeMultiplier(10)
+      ->Range(10, maxSize)
+      ->Unit(benchmark::kMicrosecond);
+}
+
+template <typename T> void registerArraySuite(const std::string &type) {
+  int64_t maxSize = maxBenchmarkSize<T>();
+  // Element-by-element ordered inserts are quadratic.
+  int64_t maxOrderedInsertSize = std::min<int64_t>(maxSize, 100000);
+  // Chunked inserts shift one block each, about 500 moves per insert.
+  int64_t maxChunkedInsertSize = std::min<int64_t>(maxSize, 10000000);
+
+  for (Distribution distribution : allDistributions) {
+    registerArrayBenchmark("DynamicArray::insertAtEnd", type, distribution,
+                           maxSize, benchmarkDynamicArrayInsertAtEnd<T>);
+    registerArrayBenchmark("DynamicArray::push_back", type, distribution,
+                           maxSize, benchmarkDynamicArrayPushBack<T>);
+    registerArrayBenchmark("std::vector::push_back", type, distribution,
+                           maxSize, benchmarkVectorPushBack<T>);
+    registerArrayBenchmark("DynamicArray::small8", type, distribution,
+                           maxSize, benchmarkSmallArrays<DynamicArray<T>, T>);
+    registerArrayBenchmark("SmallDynamicArray<16>::small8", type,
+                           distribution, maxSize,
+                           benchmarkSmallArrays<SmallDynamicArray<T, 16>, T>);
+    registerArrayBenchmark("DynamicArray::findMissing", type, distribution,
+                           maxSize, benchmarkDynamicArrayFindMissing<T>);
+    // Wall time: the CPU time of the calling thread misses the workers.
+    registerArrayBenchmark("DynamicArray::findMissing/parallel", type,
+                           distribution, maxSize,
+                           benchmarkDynamicArrayParallelFindMissing<T>)
+        ->UseRealTime();
+    registerArrayBenchmark("std::find/missing", type, distribution, maxSize,
+                           benchmarkVectorFindMissing<T>);
+    registerArrayBenchmark("OrderedArray::insert", type, distribution,
+                           maxOrderedInsertSize,
+                           benchmarkOrderedArrayInsert<T>);
+    registerArrayBenchmark("OrderedArray::insertRange", type, distribution,
+                           maxSize, benchmarkOrderedArrayInsertRange<T>);
+    registerArrayBenchmark("OrderedArray::find", type, distribution, maxSize,
+                           [](benchmark::State &state, Distribution d) {
+                             benchmarkOrderedArrayFind<T>(state, d, false);
+                           });
+    registerArrayBenchmark("OrderedArray::find/frozen", type, distribution,
+                           maxSize,
+                           [](benchmark::State &state, Distribution d) {
+                             benchmarkOrderedArrayFind<T>(state, d, true);
+                           });
+
+    if constexpr (learnedIndexApplies<T, std::less<T>>) {
+      registerArrayBenchmark("OrderedArray::find/learned", type, distribution,
+                             maxSize, benchmarkOrderedArrayFindLearned<T>);
+    }
+
+    registerArrayBenchmark("setIntersection", type, distribution, maxSize,
+                           [](benchmark::State &state, Distribution d) {
+                             benchmarkOrderedArrayIntersection<T>(state, d,
+                                                                  false);
+                           });
+    registerArrayBenchmark("setIntersection/galloping", type, distribution,
+                           maxSize,
+                           [](benchmark::State &state, Distribution d) {
+                             benchmarkOrderedArrayIntersection<T>(state, d,
+                                                                  true);
+                           });
+    registerArrayBenchmark("ChunkedOrderedArray::insert", type, distribution,
+                           maxChunkedInsertSize,
+                           benchmarkChunkedOrderedArrayInsert<T>);
+    registerArrayBenchmark("ChunkedOrderedArray::find", type, distribution,
+                           maxSize, benchmarkChunkedOrderedArrayFind<T>);
+    registerArrayBenchmark("std::lower_bound", type, distribution, maxSize,
+                           benchmarkVectorLowerBound<T>);
+  }
+}
+
+const bool arrayBenchmarksRegistered = [] {
+  registerArraySuite<int32_t>("int32");
+  registerArraySuite<int64_t>("int64");
+  registerArraySuite<double>("double");
+  registerArraySuite<std::string>("string");
+  registerArraySuite<Record<64>>("record64");
+
+  benchmark::RegisterBenchmark("shared_mutex<OrderedArray>::find/int64/random",
+                               benchmarkSharedMutexFind)
+      ->ThreadRange(1, 8)
+      ->UseRealTime()
+      ->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("ConcurrentOrderedArray::find/int64/random",
+                               benchmarkConcurrentOrderedArrayFind)
+      ->ThreadRange(1, 8)
+      ->UseRealTime()
+      ->Unit(benchmark::kMicrosecond);
+
+  return true;
+}();
@@ -0,0 +1,151 @@
+#ifndef BENCHMARK_INPUTS_CPP
+#define BENCHMARK_INPUTS_CPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Input shapes used across the benchmark suites.
+ *
+ * - Random: uniformly distributed keys.
+ * - Sorted: already ascending.
+ * - Reverse: descending.
+ * - FewUnique: keys drawn from 16 distinct values.
+ * - OrganPipe: ascending to the middle, then descending.
+ * - NearlySorted: ascending within a disorder window of 64, with one key in
+ *   1024 moved anywhere.
+ */
+enum class Distribution {
+  Random,
+  Sorted,
+  Reverse,
+  FewUnique,
+  OrganPipe,
+  NearlySorted
+};
+
+const Distribution allDistributions[] = {
+    Distribution::Random,    Distribution::Sorted,
+    Distribution::Reverse,   Distribution::FewUnique,
+    Distribution::OrganPipe, Distribution::NearlySorted};
+
+inline std::string distributionName(Distribution distribution) {
+  switch (distribution) {
+  case Distribution::Random:
+    return "random";
+  case Distribution::Sorted:
+    return "sorted";
+  case Distribution::Reverse:
+    return "reverse";
+  case Distribution::FewUnique:
+    return "few_unique";
+  case Distribution::OrganPipe:
+    return "organ_pipe";
+  case Distribution::NearlySorted:
+    return "nearly_sorted";
+  }
+
+  return "unknown";
+}
+
+/**
+ * Fixed-size record ordered by a 64-bit key, for measuring how element size
+ * affects moves. `Bytes` is the total size, key included.
+ */
+template <size_t Bytes> struct Record {
+  static_assert(Bytes >= sizeof(uint64_t), "Record must hold its key");
+
+  uint64_t key;
+  char payload[Bytes - sizeof(uint64_t)];
+
+  Record() = default;
+  explicit Record(uint64_t key) : key(key), payload() {}
+
+  bool operator<(const Record &other) const { return key < other.key; }
+  bool operator>(const Record &other) const { return key > other.key; }
+  bool operator==(const Record &other) const { return key == other.key; }
+};
+
+template <typename T> struct KeyMaker {
+  static T make(uint64_t key) { return static_cast<T>(key); }
+};
+
+template <size_t Bytes> struct KeyMaker<Record<Bytes>> {
+  static Record<Bytes> make(uint64_t key) { return Record<Bytes>(key); }
+};
+
+template <> struct KeyMaker<std::string> {
+  static std::string make(uint64_t key) {
+    // Zero-padded so that string order matches numeric order.
+    std::string digits = std::to_string(key);
+    return std::string(20 - digits.size(), '0') + digits;
+  }
+};
+
+/**
+ * Keys 0..size-1 (or random keys) arranged in the given distribution.
+ * Deterministic for a given size so runs can be diffed.
+ */
+inline std::vector<uint64_t> makeKeys(size_t size, Distribution distribution) {
+  std::vector<uint64_t> keys(size);
+  std::mt19937_64 random(size);
+
+  for (size_t i = 0; i < size; ++i) {
+    switch (distribution) {
+    case Distribution::Random:
+      keys[i] = random() >> 34; // Fits int32_t without sign issues.
+      break;
+    case Distribution::Sorted:
+      keys[i] = i;
+      break;
+    case Distribution::Reverse:
+      keys[i] = size - i;
+      break;
+    case Distribution::FewUnique:
+      keys[i] = random() % 16;
+      break;
+    case Distribution::OrganPipe:
+      keys[i] = i < size / 2 ? i : size - i;
+      break;
+    case Distribution::NearlySorted:
+      keys[i] = i % 1024 == 1023 ? random() % size : i + random() % 64;
+      break;
+    }
+  }
+
+  return keys;
+}
+
+template <typename T>
+std::vector<T> makeInput(size_t size, Distribution distribution) {
+  std::vector<uint64_t> keys = makeKeys(size, distribution);
+  std::vector<T> input;
+  input.reserve(size);
+
+  for (uint64_t key : keys) {
+    input.push_back(KeyMaker<T>::make(key));
+  }
+
+  return input;
+}
+
+/**
+ * Largest power of ten in [10, 10^8] whose input, plus one working copy,
+ * fits in about 2 GB of `T`.
+ */
+template <typename T> int64_t maxBenchmarkSize() {
+  constexpr int64_t budget = int64_t(1) << 31;
+  int64_t size = 100000000;
+
+  while (size > 10 && size * 2 * static_cast<int64_t>(sizeof(T)) > budget) {
+    size /= 10;
+  }
+
+  return size;
+}
+
+#endif // BENCHMARK_INPUTS_CPP
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/sortings/Argsort.cpp"
+#include "../src/sortings/ParallelSort.cpp"
+#include "../src/sortings/PdqSort.cpp"
+#include "../src/sortings/PowerSort.cpp"
+#include "../src/sortings/RadixSort.cpp"
+#include "../src/sortings/Selection.cpp"
+#include "../src/sortings/SortingNetwork.cpp"
+#include "BenchmarkInputs.cpp"
+
+// Defined in src/sortings/BubbleSort.cpp, which is compiled into MyLib.
+void bubbleSort(std::vector<int> &arr);
+
+/**
+ * Sort a fresh copy of the input on every iteration. The copy is part of the
+ * measured time (pausing the timer costs more than copying small inputs), so
+ * compare algorithms against each other and not against zero.
+ */
+template <typename T, typename Sorter>
+void benchmarkSort(benchmark::State &state, Distribution distribution,
+                   Sorter sorter) {
+  size_t size = static_cast<size_t>(state.range(0));
+  std::vector<T> input = makeInput<T>(size, distribution);
+  std::vector<T> work;
+
+  for (auto _ : state) {
+    work = input;
+    sorter(work);
+    benchmark::DoNotOptimize(work.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T, typename Sorter>
+void registerSort(const std::string &algorithm, const std::string &type,
+                  Distribution distribution, int64_t maxSize, Sorter sorter) {
+  std::string name =
+      algorithm + "/" + type + "/" + distributionName(distribution);
+
+  benchmark::RegisterBenchmark(name.c_str(),
+                               [distribution, sorter](benchmark::State &state) {
+                                 benchmarkSort<T>(state, distribution, sorter);
+                               })
+      ->RangeMultiplier(10)
+      ->Range(10, maxSize)
+      ->Unit(benchmark::kMicrosecond);
+}
+
+/**
+ * Selection against the full sorts: the median, and the first 100 elements
+ * in order, in place or streamed through a TopK.
+ */
+template <typename T>
+void registerSelectionSuite(const std::string &type, Distribution distribution,
+                            int64_t maxSize) {
+  static constexpr size_t k = 100;
+
+  registerSort<T>("std::nth_element/median", type, distribution, maxSize,
+                  [](std::vector<T> &v) {
+                    std::nth_element(v.begin(), v.begin() + v.size() / 2,
+                                     v.end());
+                  });
+  registerSort<T>("nthElement/median", type, distribution, maxSize,
+                  [](std::vector<T> &v) {
+                    nthElement(v.begin(), v.begin() + v.size() / 2, v.end());
+                  });
+  registerSort<T>("std::partial_sort/top100", type, distribution, maxSize,
+                  [](std::vector<T> &v) {
+                    std::partial_sort(v.begin(),
+                                      v.begin() + std::min(k, v.size()),
+                                      v.end());
+                  });
+  registerSort<T>("partialSort/top100", type, distribution, maxSize,
+                  [](std::vector<T> &v) {
+                    partialSort(v.begin(), v.begin() + std::min(k, v.size()),
+                                v.end());
+                  });
+  registerSort<T>("TopK/top100", type, distribution, maxSize,
+                  [](std::vector<T> &v) {
+                    TopK<T> top(k);
+                    top.pushRange(v.begin(), v.end());
+                    benchmark::DoNotOptimize(top.take().data());
+                  });
+}
+
+/**
+ * Base-case kernels: the input cut into consecutive blocks of N elements,
+ * each sorted on its own with insertion sort or the sorting network.
+ */
+template <typename T, size_t N>
+void registerBlockSorts(const std::string &type, Distribution distribution,
+                        int64_t maxSize) {
+  std::string blocks = "/blocks" + std::to_string(N);
+
+  registerSort<T>("insertionSort" + blocks, type, distribution, maxSize,
+                  [](std::vector<T> &v) {
+                    for (size_t i = 0; i + N <= v.size(); i += N) {
+                      insertionSort(v.begin() + i, v.begin() + (i + N));
+                    }
+                  });
+  registerSort<T>("sortN" + blocks, type, distribution, maxSize,
+                  [](std::vector<T> &v) {
+                    for (size_t i = 0; i + N <= v.size(); i += N) {
+                      sortN<N>(v.begin() + i);
+                    }
+                  });
+}
+
+/**
+ * Records sorted by their 8-byte key without moving them on every
+ * comparison: the permutation alone, and the keys sorted apart with the
+ * records then moved once.
+ */
+template <size_t Bytes>
+void registerKeySorts(const std::string &type, Distribution distribution,
+                      int64_t maxSize) {
+  using T = Record<Bytes>;
+  auto keyOf = [](const T &record) { return record.key; };
+
+  registerSort<T>("argsortByKey", type, distribution, maxSize,
+                  [keyOf](std::vector<T> &v) {
+                    std::vector<size_t> order =
+                        argsortByKey(v.begin(), v.end(), keyOf);
+                    benchmark::DoNotOptimize(order.data());
+                  });
+  registerSort<T>("sortByKey", type, distribution, maxSize,
+                  [keyOf](std::vector<T> &v) {
+                    sortByKey(v.begin(), v.end(), keyOf);
+                  });
+}
+
+template <typename T> void registerSortSuite(const std::string &type) {
+  int64_t maxSize = maxBenchmarkSize<T>();
+
+  for (Distribution distribution : allDistributions) {
+    registerSort<T>("std::sort", type, distribution, maxSize,
+                    [](std::vector<T> &v) { std::sort(v.begin(), v.end()); });
+    registerSort<T>("pdqSort", type, distribution, maxSize,
+                    [](std::vector<T> &v) { pdqSort(v.begin(), v.end()); });
+    registerSort<T>("parallelSort", type, distribution, maxSize,
+                    [](std::vector<T> &v) {
+                      parallelSort(v.begin(), v.end(), std::less<>());
+                    });
+    registerSort<T>("std::stable_sort", type, distribution, maxSize,
+                    [](std::vector<T> &v) {
+                      std::stable_sort(v.begin(), v.end());
+                    });
+    registerSort<T>("powerSort", type, distribution, maxSize,
+                    [](std::vector<T> &v) { powerSort(v.begin(), v.end()); });
+
+    registerSelectionSuite<T>(type, distribution, maxSize);
+
+    if constexpr (std::is_arithmetic<T>::value) {
+      registerSort<T>("radixSort", type, distribution, maxSize,
+                      [](std::vector<T> &v) { radixSort(v.begin(), v.end()); });
+      registerSort<T>("msdRadixSort", type, distribution, maxSize,
+                      [](std::vector<T> &v) {
+                        msdRadixSort(v.begin(), v.end());
+                      });
+      registerBlockSorts<T, 8>(type, distribution, maxSize);
+      registerBlockSorts<T, 16>(type, distribution, maxSize);
+      registerBlockSorts<T, 32>(type, distribution, maxSize);
+    }
+
+    if constexpr (std::is_same<T, Record<sizeof(T)>>::value) {
+      registerKeySorts<sizeof(T)>(type, distribution, maxSize);
+    }
+  }
+}
+
+const bool sortBenchmarksRegistered = [] {
+  // Quadratic: capped at 10^4 elements.
+  for (Distribution distribution : allDistributions) {
+    registerSort<int>("bubbleSort", "int32", distribution, 10000,
+                      [](std::vector<int> &v) { bubbleSort(v); });
+  }
+
+  registerSortSuite<int32_t>("int32");
+  registerSortSuite<int64_t>("int64");
+  registerSortSuite<double>("double");
+  registerSortSuite<std::string>("string");
+  registerSortSuite<Record<64>>("record64");
+  registerSortSuite<Record<256>>("record256");
+
+  return true;
+}();
@@ -0,0 +1,366 @@
+#ifndef PARALLEL_BULK_CPP
+#define PARALLEL_BULK_CPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "../data_structures/array/VectorizedSearch.cpp"
+#include "ThreadPool.cpp"
+
+// Arrays below twice this many bytes run the serial kernels; a chunk of
+// less than this much work does not pay for its task.
+constexpr size_t parallelBulkGrainBytes = size_t(1) << 18;
+
+// Chunks per thread taking part (the workers plus the caller), so that a
+// thread slowed down by other work does not hold up the whole pass.
+constexpr size_t parallelBulkChunksPerThread = 4;
+
+// A parallel find checks whether an earlier match was found after scanning
+// this many bytes of its chunk.
+constexpr size_t parallelFindBlockBytes = size_t(1) << 14;
+
+constexpr size_t cacheLineBytes = 64;
+
+/**
+ * Split [0, size) into at most `chunks` consecutive non-empty ranges whose
+ * inner boundaries fall on cache-line boundaries of `data`, so that no two
+ * threads write to the same line. Returns the boundaries, from 0 to `size`.
+ *
+ * @complexity O(chunks)
+ */
+template <typename T>
+std::vector<size_t> parallelChunkBounds(const T *data, size_t size,
+                                        size_t chunks) {
+  // Elements per cache line, and the index of the first element starting
+  // one, when cache lines hold whole elements.
+  size_t step = 1;
+  size_t lead = 0;
+
+  if (cacheLineBytes % sizeof(T) == 0) {
+    size_t misalignment =
+        (cacheLineBytes - reinterpret_cast<uintptr_t>(data) % cacheLineBytes) %
+        cacheLineBytes;
+
+    if (misalignment % sizeof(T) == 0) {
+      step = cacheLineBytes / sizeof(T);
+      lead = misalignment / sizeof(T);
+    }
+  }
+
+  std::vector<size_t> bounds{0};
+
+  for (size_t c = 1; c < chunks; ++c) {
+    size_t bound = size / chunks * c + size % chunks * c / chunks;
+
+    if (bound > lead) {
+      bound = lead + (bound - lead) / step * step;
+    }
+
+    if (bound > bounds.back() && bound < size) {
+      bounds.push_back(bound);
+    }
+  }
+
+  bounds.push_back(size);
+
+  return bounds;
+}
+
+/**
+ * Run `body(chunk, begin, end)` over cache-aligned chunks of [0, size)
+ * on `pool`, with the calling thread taking the first chunk. Arrays below
+ * the grain size, and pools without workers, run as a single chunk on the
+ * calling thread. Returns the number of chunks; exceptions from `body`
+ * propagate after every chunk finished.
+ *
+ * @complexity O(n / p) span for O(n) work
+ */
+template <typename T, typename Body>
+size_t parallelForChunks(const T *data, size_t size, ThreadPool &pool,
+                         Body body) {
+  size_t bytes = size * sizeof(T);
+  size_t threads = pool.getThreadCount() + 1;
+
+  if (threads == 1 || bytes < 2 * parallelBulkGrainBytes) {
+    if (size > 0) {
+      body(size_t(0), size_t(0), size);
+    }
+
+    return size > 0 ? 1 : 0;
+  }
+
+  size_t chunks = std::min(threads * parallelBulkChunksPerThread,
+                           bytes / parallelBulkGrainBytes);
+  std::vector<size_t> bounds = parallelChunkBounds(data, size, chunks);
+  chunks = bounds.size() - 1;
+
+  TaskGroup group(pool);
+
+  // Spawned in index order, so idle workers steal the low chunks first.
+  for (size_t c = 1; c < chunks; ++c) {
+    group.run([&body, &bounds, c] { body(c, bounds[c], bounds[c + 1]); });
+  }
+
+  // If this throws, the group's destructor still waits for the others.
+  body(size_t(0), bounds[0], bounds[1]);
+  group.wait();
+
+  return chunks;
+}
+
+/**
+ * Index of the first element `scan` reports, or `size`. `scan(from, count)`
+ * returns the offset of the first match in [from, from + count), or
+ * `count`.
+ *
+ * Chunks are scanned in blocks; a chunk stops as soon as a match before it
+ * is known, so a match early in the array ends the search almost at once
+ * while the chunks before it still finish to rule out an earlier one.
+ *
+ * @complexity O(n) work
+ */
+template <typename T, typename Scan>
+size_t parallelFindFirst(const T *data, size_t size, ThreadPool &pool,
+                         Scan scan) {
+  std::atomic<size_t> found{size};
+  size_t block = std::max<size_t>(64, parallelFindBlockBytes / sizeof(T));
+
+  parallelForChunks(data, size, pool, [&](size_t, size_t begin, size_t end) {
+    for (size_t from = begin; from < end; from += block) {
+      size_t current = found.load(std::memory_order_relaxed);
+
+      if (current < from) {
+        return;
+      }
+
+      size_t count = std::min(block, end - from);
+      size_t offset = scan(data + from, count);
+
+      if (offset < count) {
+        size_t index = from + offset;
+
+        while (index < current &&
+               !found.compare_exchange_weak(current, index,
+                                            std::memory_order_relaxed)) {
+        }
+
+        return;
+      }
+    }
+  });
+
+  return found.load(std::memory_order_relaxed);
+}
+
+/**
+ * Parallel vectorizedFind: index of the first element equal to `value`, or
+ * `size`.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename T>
+size_t parallelFind(const T *data, size_t size, const T &value,
+                    ThreadPool &pool) {
+  return parallelFindFirst(data, size, pool,
+                           [&value](const T *from, size_t count) {
+                             return vectorizedFind(from, count, value);
+                           });
+}
+
+/**
+ * Parallel vectorizedFindIf: index of the first element satisfying
+ * `predicate`, or `size`. The predicate runs concurrently and must be safe
+ * to call from several threads.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename T, typename Predicate>
+size_t parallelFindIf(const T *data, size_t size, Predicate predicate,
+                      ThreadPool &pool) {
+  return parallelFindFirst(data, size, pool,
+                           [&predicate](const T *from, size_t count) {
+                             return vectorizedFindIf(from, count, predicate);
+                           });
+}
+
+/**
+ * Parallel vectorizedCount: number of elements equal to `value`.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename T>
+size_t parallelCount(const T *data, size_t size, const T &value,
+                     ThreadPool &pool) {
+  std::atomic<size_t> total{0};
+
+  parallelForChunks(data, size, pool, [&](size_t, size_t begin, size_t end) {
+    total.fetch_add(vectorizedCount(data + begin, end - begin, value),
+                    std::memory_order_relaxed);
+  });
+
+  return total.load(std::memory_order_relaxed);
+}
+
+/**
+ * Assign `value` to every element.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename T>
+void parallelFill(T *data, size_t size, const T &value, ThreadPool &pool) {
+  parallelForChunks(data, size, pool, [&](size_t, size_t begin, size_t end) {
+    std::fill(data + begin, data + end, value);
+  });
+}
+
+/**
+ * Replace every element `x` with `fn(x)`. `fn` runs concurrently on
+ * different elements.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename T, typename Function>
+void parallelTransform(T *data, size_t size, Function fn, ThreadPool &pool) {
+  parallelForChunks(data, size, pool, [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      data[i] = fn(data[i]);
+    }
+  });
+}
+
+/**
+ * Call `fn(x)` on every element, concurrently and in no particular order.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename T, typename Function>
+void parallelForEach(const T *data, size_t size, Function fn,
+                     ThreadPool &pool) {
+  parallelForChunks(data, size, pool, [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      fn(data[i]);
+    }
+  });
+}
+
+/**
+ * Return `init` combined with `transformOp(x)` for every element, as
+ * std::transform_reduce: each chunk folds the transformed elements with
+ * `reduceOp`, and the chunk results are combined into `init` in index
+ * order. `reduceOp` takes (R, R) and must be associative (not necessarily
+ * commutative). Floating-point sums can differ from a serial fold in the
+ * last bits, depending on the chunking.
+ *
+ * @complexity O(n) work, O(n / p + p) span
+ */
+template <typename T, typename R, typename ReduceOp, typename TransformOp>
+R parallelTransformReduce(const T *data, size_t size, R init,
+                          ReduceOp reduceOp, TransformOp transformOp,
+                          ThreadPool &pool) {
+  size_t threads = pool.getThreadCount() + 1;
+  std::vector<R> partials(threads * parallelBulkChunksPerThread, init);
+
+  size_t chunks = parallelForChunks(
+      data, size, pool, [&](size_t chunk, size_t begin, size_t end) {
+        R partial = static_cast<R>(transformOp(data[begin]));
+
+        for (size_t i = begin + 1; i < end; ++i) {
+          partial = reduceOp(std::move(partial),
+                             static_cast<R>(transformOp(data[i])));
+        }
+
+        partials[chunk] = std::move(partial);
+      });
+
+  for (size_t c = 0; c < chunks; ++c) {
+    init = reduceOp(std::move(init), std::move(partials[c]));
+  }
+
+  return init;
+}
+
+// Overloads over a whole array: any container whose begin() returns a
+// pointer to getSize() contiguous elements, such as DynamicArray,
+// FixedArray or MappedArray. Searches return the index of the first match
+// or getSize(), as the pointer forms above.
+
+/**
+ * Parallel find over `array`.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename Array, typename T>
+size_t parallelFind(const Array &array, const T &value, ThreadPool &pool) {
+  return parallelFind(array.begin(), array.getSize(), value, pool);
+}
+
+/**
+ * Parallel findIf over `array`. The predicate is called concurrently.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename Array, typename Predicate>
+size_t parallelFindIf(const Array &array, Predicate predicate,
+                      ThreadPool &pool) {
+  return parallelFindIf(array.begin(), array.getSize(), predicate, pool);
+}
+
+/**
+ * Parallel count over `array`.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename Array, typename T>
+size_t parallelCount(const Array &array, const T &value, ThreadPool &pool) {
+  return parallelCount(array.begin(), array.getSize(), value, pool);
+}
+
+/**
+ * Parallel fill of `array`.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename Array, typename T>
+void parallelFill(Array &array, const T &value, ThreadPool &pool) {
+  parallelFill(array.begin(), array.getSize(), value, pool);
+}
+
+/**
+ * Parallel transform of `array`; `fn` is called concurrently.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename Array, typename Function>
+void parallelTransform(Array &array, Function fn, ThreadPool &pool) {
+  parallelTransform(array.begin(), array.getSize(), fn, pool);
+}
+
+/**
+ * Parallel forEach over `array`; `fn` is called concurrently, in no
+ * particular order.
+ *
+ * @complexity O(n) work, O(n / p) span
+ */
+template <typename Array, typename Function>
+void parallelForEach(const Array &array, Function fn, ThreadPool &pool) {
+  parallelForEach(array.begin(), array.getSize(), fn, pool);
+}
+
+/**
+ * Parallel transformReduce over `array`; `reduceOp` must be associative.
+ *
+ * @complexity O(n) work, O(n / p + p) span
+ */
+template <typename Array, typename R, typename ReduceOp, typename TransformOp>
+R parallelTransformReduce(const Array &array, R init, ReduceOp reduceOp,
+                          TransformOp transformOp, ThreadPool &pool) {
+  return parallelTransformReduce(array.begin(), array.getSize(),
+                                 std::move(init), reduceOp, transformOp,
+                                 pool);
+}
+
+#endif // PARALLEL_BULK_CPP
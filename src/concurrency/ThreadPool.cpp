@@ -0,0 +1,288 @@
+#ifndef THREAD_POOL_CPP
+#define THREAD_POOL_CPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * ThreadPool
+ *
+ * A fixed set of worker threads with one task deque per worker:
+ *
+ * 1. **Work stealing**: a worker pushes the tasks it spawns onto its own
+ *    deque and pops them LIFO, which keeps recursive divide-and-conquer work
+ *    cache-hot. Idle workers steal the oldest (largest) task from the front
+ *    of another deque.
+ * 2. **External submissions**: threads outside the pool push onto a shared
+ *    injection deque that every worker also steals from.
+ * 3. **Helping waits**: a thread blocked on a TaskGroup runs pending tasks
+ *    instead of sleeping, so nested fork-join never deadlocks and the calling
+ *    thread counts as an extra worker.
+ *
+ * All algorithms that take a pool accept a caller-owned instance, so a
+ * service can size one pool for its cores and share it instead of
+ * oversubscribing.
+ */
+class ThreadPool {
+private:
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  // One queue per worker, plus the injection queue at the back.
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+  std::vector<std::thread> workers;
+
+  std::mutex sleepMutex;
+  std::condition_variable wakeUp;
+  std::atomic<size_t> queued{0};
+  bool stopping = false;
+
+  static inline thread_local ThreadPool *currentPool = nullptr;
+  static inline thread_local size_t currentQueue = 0;
+
+  /**
+   * Index of the queue the calling thread owns: its worker queue, or the
+   * injection queue for threads outside this pool.
+   *
+   * @complexity O(1)
+   */
+  size_t homeQueue() const {
+    return currentPool == this ? currentQueue : queues.size() - 1;
+  }
+
+  /**
+   * Take a task: newest from the home queue first, otherwise steal the
+   * oldest from the other queues.
+   *
+   * @complexity O(p) for p queues
+   */
+  bool takeTask(size_t home, std::function<void()> &task) {
+    {
+      WorkQueue &own = *queues[home];
+      std::lock_guard<std::mutex> lock(own.mutex);
+
+      if (!own.tasks.empty()) {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+      WorkQueue &victim = *queues[(home + offset) % queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  void workerLoop(size_t index) {
+    currentPool = this;
+    currentQueue = index;
+    std::function<void()> task;
+
+    while (true) {
+      if (takeTask(index, task)) {
+        task();
+        task = nullptr;
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleepMutex);
+      wakeUp.wait(lock, [this] {
+        return stopping || queued.load(std::memory_order_relaxed) > 0;
+      });
+
+      if (stopping && queued.load(std::memory_order_relaxed) == 0) {
+        return;
+      }
+    }
+  }
+
+public:
+  /**
+   * Number of hardware threads, or 1 if it cannot be determined.
+   *
+   * @complexity O(1)
+   */
+  static size_t defaultThreadCount() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  /**
+   * Start `threadCount` worker threads.
+   *
+   * @complexity O(p)
+   */
+  explicit ThreadPool(size_t threadCount = defaultThreadCount()) {
+    for (size_t i = 0; i <= threadCount; ++i) {
+      queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    workers.reserve(threadCount);
+
+    for (size_t i = 0; i < threadCount; ++i) {
+      workers.emplace_back([this, i] { workerLoop(i); });
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * Finish the queued tasks and join the workers.
+   *
+   * @complexity O(p)
+   */
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    for (std::thread &worker : workers) {
+      worker.join();
+    }
+  }
+
+  /**
+   * Return the number of worker threads.
+   *
+   * @complexity O(1)
+   */
+  size_t getThreadCount() const { return workers.size(); }
+
+  /**
+   * Queue a task. Tasks must not throw; use TaskGroup to run fallible work.
+   *
+   * @complexity O(1)
+   */
+  void submit(std::function<void()> task) {
+    // Count the task before publishing it so `queued` never underflows when
+    // a thief takes it straight away.
+    queued.fetch_add(1, std::memory_order_relaxed);
+
+    {
+      WorkQueue &home = *queues[homeQueue()];
+      std::lock_guard<std::mutex> lock(home.mutex);
+      home.tasks.push_back(std::move(task));
+    }
+
+    // Taking the lock orders this notify after any sleeper's predicate check.
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+
+    wakeUp.notify_one();
+  }
+
+  /**
+   * Run one queued task on the calling thread, if there is any.
+   *
+   * @complexity O(p) plus the task itself
+   * @return whether a task was run.
+   */
+  bool runPendingTask() {
+    std::function<void()> task;
+
+    if (!takeTask(homeQueue(), task)) {
+      return false;
+    }
+
+    task();
+    return true;
+  }
+};
+
+/**
+ * TaskGroup
+ *
+ * Fork-join handle over a ThreadPool: `run` spawns tasks, `wait` blocks until
+ * all of them finished, running queued tasks meanwhile, and rethrows the
+ * first exception any of them raised.
+ */
+class TaskGroup {
+private:
+  ThreadPool &pool;
+  std::atomic<size_t> pending{0};
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+  void join() {
+    while (pending.load(std::memory_order_acquire) > 0) {
+      if (!pool.runPendingTask()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+public:
+  explicit TaskGroup(ThreadPool &pool) : pool(pool) {}
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  ~TaskGroup() { join(); }
+
+  /**
+   * Spawn `task` on the pool.
+   *
+   * @complexity O(1)
+   */
+  template <typename Task> void run(Task task) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+
+    pool.submit([this, task = std::move(task)]() mutable {
+      try {
+        task();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+
+      // Last access to the group: once pending drops, wait() may return
+      // and destroy it.
+      pending.fetch_sub(1, std::memory_order_release);
+    });
+  }
+
+  /**
+   * Wait for every spawned task and rethrow the first failure.
+   *
+   * @complexity O(1) plus the time to drain the tasks
+   */
+  void wait() {
+    join();
+
+    if (error) {
+      std::exception_ptr failure = std::move(error);
+      error = nullptr;
+      std::rethrow_exception(failure);
+    }
+  }
+};
+
+#endif // THREAD_POOL_CPP
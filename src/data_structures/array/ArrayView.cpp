@@ -0,0 +1,70 @@
+#ifndef ARRAY_VIEW_CPP
+#define ARRAY_VIEW_CPP
+
+#include <cstddef>
+#include <stdexcept>
+
+/**
+ * ArrayView
+ *
+ * Non-owning, read-only view of a contiguous run of elements, such as a
+ * sorted slice returned by OrderedArray::range. Copying a view is O(1) and
+ * never copies elements; the view is invalidated by anything that
+ * reallocates or shifts the underlying array. Views of constexpr arrays
+ * are constexpr too.
+ */
+template <typename T> class ArrayView {
+private:
+  const T *data;
+  size_t size;
+
+public:
+  /**
+   * Empty view.
+   *
+   * @complexity O(1)
+   */
+  constexpr ArrayView() : data(nullptr), size(0) {}
+
+  /**
+   * View over `size` elements starting at `data`.
+   *
+   * @complexity O(1)
+   */
+  constexpr ArrayView(const T *data, size_t size) : data(data), size(size) {}
+
+  /**
+   * Return size.
+   *
+   * @complexity O(1)
+   */
+  constexpr size_t getSize() const { return size; }
+
+  /**
+   * Whether the view has no elements.
+   *
+   * @complexity O(1)
+   */
+  constexpr bool isEmpty() const { return size == 0; }
+
+  /**
+   * Access an element at a specific index.
+   *
+   * @complexity O(1)
+   */
+  constexpr const T &get(size_t index) const {
+    if (index >= size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    return data[index];
+  }
+
+  // Begin iterator
+  constexpr const T *begin() const { return data; }
+
+  // End iterator
+  constexpr const T *end() const { return data + size; }
+};
+
+#endif // ARRAY_VIEW_CPP
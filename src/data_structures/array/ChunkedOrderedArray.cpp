@@ -0,0 +1,614 @@
+#ifndef CHUNKED_ORDERED_ARRAY_CPP
+#define CHUNKED_ORDERED_ARRAY_CPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../../utils/OperationStats.cpp"
+#include "ArrayView.cpp"
+
+/**
+ * ChunkedOrderedArray
+ *
+ * Sorted container with the lookup API of OrderedArray, stored as a list of
+ * sorted blocks of at most `blockCapacity` elements plus a top-level index
+ * holding the last element of every block, like the leaf layer of a
+ * B+-tree:
+ *
+ * 1. **Insert/remove**: a binary search over the index picks the block, and
+ *    only that block shifts, so an update moves O(B) elements instead of
+ *    O(n). A full block is split in two; a block that drops below a quarter
+ *    of its capacity is merged into a neighbour when they fit together.
+ * 2. **Lookups**: one binary search over the index and one inside the block,
+ *    O(log n) in total.
+ * 3. **Positions**: a Fenwick tree over the block sizes gives the first
+ *    index of a block, and the block holding an index, in O(log(n / B)).
+ *    An update adjusts it in O(log(n / B)); splits and merges rebuild it
+ *    in O(n / B). Lookups only read it, so const access is safe from
+ *    several threads.
+ * 4. **Scans**: iteration walks the blocks in order, and getBlock() exposes
+ *    each block as a contiguous ArrayView.
+ *
+ * With the default B = 1024, an index over 50M keys has about 50K-100K
+ * entries and inserting costs a few hundred moves.
+ *
+ * The order is the `Compare` template parameter, with heterogeneous lookup
+ * for transparent comparators, as in OrderedArray. Blocks and the index are
+ * allocated from `Allocator`; pmr::ChunkedOrderedArray<T> takes a
+ * std::pmr::memory_resource.
+ */
+template <typename T, typename Compare = std::less<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
+class ChunkedOrderedArray : private Stats {
+private:
+  using AllocatorTraits = std::allocator_traits<Allocator>;
+  template <typename U>
+  using Rebind = typename AllocatorTraits::template rebind_alloc<U>;
+  using Block = std::vector<T, Allocator>;
+  using Blocks = std::vector<Block, Rebind<Block>>;
+
+  Allocator allocator;
+  Blocks blocks;
+  std::vector<T, Allocator> blockLast;
+  // Fenwick tree over the block sizes: entry i (1-based) holds the total
+  // size of blocks [i - lowbit(i), i).
+  std::vector<size_t, Rebind<size_t>> blockCounts;
+  size_t size = 0;
+  size_t blockCapacity;
+  Compare comp;
+
+  /**
+   * Whether `a` belongs before `b` in the array's order.
+   *
+   * @complexity O(1)
+   */
+  template <typename A, typename B>
+  bool precedes(const A &a, const B &b) const {
+    this->addComparisons(1);
+
+    return comp(a, b);
+  }
+
+  /**
+   * Index of the block that should hold the lower (`upper` false) or upper
+   * (`upper` true) bound of `value`, or the block count if it lies past the
+   * last element.
+   *
+   * @complexity O(log(n / B))
+   */
+  template <typename K> size_t findBlock(const K &value, bool upper) const {
+    auto order = [this](const auto &a, const auto &b) {
+      return precedes(a, b);
+    };
+
+    return (upper ? std::upper_bound(blockLast.begin(), blockLast.end(), value,
+                                     order)
+                  : std::lower_bound(blockLast.begin(), blockLast.end(), value,
+                                     order)) -
+           blockLast.begin();
+  }
+
+  /**
+   * Position of the bound of `value` inside block `index`.
+   *
+   * @complexity O(log B)
+   */
+  template <typename K>
+  size_t findInBlock(size_t index, const K &value, bool upper) const {
+    auto order = [this](const auto &a, const auto &b) {
+      return precedes(a, b);
+    };
+    const Block &block = blocks[index];
+
+    return (upper ? std::upper_bound(block.begin(), block.end(), value, order)
+                  : std::lower_bound(block.begin(), block.end(), value,
+                                     order)) -
+           block.begin();
+  }
+
+  /**
+   * Global index of the bound of `value`.
+   *
+   * @complexity O(log n)
+   */
+  template <typename K> size_t bound(const K &value, bool upper) const {
+    size_t b = findBlock(value, upper);
+
+    return b == blocks.size() ? size
+                              : startOf(b) + findInBlock(b, value, upper);
+  }
+
+  /**
+   * find for a key of any type the comparator accepts.
+   *
+   * @complexity O(log n)
+   */
+  template <typename K> size_t findKey(const K &value) const {
+    size_t b = findBlock(value, false);
+
+    if (b == blocks.size()) {
+      return npos;
+    }
+
+    size_t offset = findInBlock(b, value, false);
+
+    return !precedes(value, blocks[b][offset]) ? startOf(b) + offset : npos;
+  }
+
+  /**
+   * Index of the first element of block `b`.
+   *
+   * @complexity O(log(n / B))
+   */
+  size_t startOf(size_t b) const {
+    size_t start = 0;
+
+    for (size_t i = b; i > 0; i &= i - 1) {
+      start += blockCounts[i];
+    }
+
+    return start;
+  }
+
+  /**
+   * Block holding the element at `index` (which must be valid), and the
+   * element's offset inside it.
+   *
+   * @complexity O(log(n / B))
+   */
+  std::pair<size_t, size_t> locate(size_t index) const {
+    size_t b = 0;
+    size_t step = 1;
+
+    while (step * 2 <= blocks.size()) {
+      step *= 2;
+    }
+
+    for (; step > 0; step /= 2) {
+      if (b + step <= blocks.size() && blockCounts[b + step] <= index) {
+        b += step;
+        index -= blockCounts[b];
+      }
+    }
+
+    return {b, index};
+  }
+
+  /**
+   * Add `delta` (wrapping, so size_t(-1) subtracts one) to the size of
+   * block `b` in the Fenwick tree.
+   *
+   * @complexity O(log(n / B))
+   */
+  void adjustCount(size_t b, size_t delta) {
+    for (size_t i = b + 1; i <= blocks.size(); i += i & (~i + 1)) {
+      blockCounts[i] += delta;
+    }
+  }
+
+  /**
+   * Rebuild the Fenwick tree after blocks were added or dropped.
+   *
+   * @complexity O(n / B)
+   */
+  void rebuildCounts() {
+    blockCounts.assign(blocks.size() + 1, 0);
+
+    for (size_t i = 1; i <= blocks.size(); ++i) {
+      blockCounts[i] += blocks[i - 1].size();
+      size_t parent = i + (i & (~i + 1));
+
+      if (parent <= blocks.size()) {
+        blockCounts[parent] += blockCounts[i];
+      }
+    }
+  }
+
+  /**
+   * Split block `b` into two halves.
+   *
+   * @complexity O(B)
+   */
+  void split(size_t b) {
+    Block upperHalf(allocator);
+    upperHalf.reserve(blockCapacity);
+
+    Block &block = blocks[b];
+    size_t half = block.size() / 2;
+    upperHalf.assign(std::make_move_iterator(block.begin() + half),
+                     std::make_move_iterator(block.end()));
+    block.erase(block.begin() + half, block.end());
+    this->addMoves(upperHalf.size());
+
+    blocks.insert(blocks.begin() + b + 1, std::move(upperHalf));
+    blockLast.insert(blockLast.begin() + b, blocks[b].back());
+    rebuildCounts();
+  }
+
+  /**
+   * Restore the block invariants after a removal from block `b`, whose
+   * count is already adjusted: empty blocks are dropped and underfull ones
+   * merged with a neighbour.
+   *
+   * @complexity O(B + n / B)
+   */
+  void rebalance(size_t b) {
+    if (blocks[b].empty()) {
+      blocks.erase(blocks.begin() + b);
+      blockLast.erase(blockLast.begin() + b);
+      rebuildCounts();
+      return;
+    }
+
+    blockLast[b] = blocks[b].back();
+
+    if (blocks[b].size() >= blockCapacity / 4 || blocks.size() == 1) {
+      return;
+    }
+
+    // Merge with the smaller neighbour, if both fit into one block.
+    size_t left = b;
+
+    if (b + 1 == blocks.size() ||
+        (b > 0 && blocks[b - 1].size() < blocks[b + 1].size())) {
+      left = b - 1;
+    }
+
+    Block &into = blocks[left];
+    Block &from = blocks[left + 1];
+
+    if (into.size() + from.size() > blockCapacity) {
+      return;
+    }
+
+    into.insert(into.end(), std::make_move_iterator(from.begin()),
+                std::make_move_iterator(from.end()));
+    this->addMoves(from.size());
+
+    blocks.erase(blocks.begin() + left + 1);
+    blockLast.erase(blockLast.begin() + left);
+    rebuildCounts();
+  }
+
+public:
+  /**
+   * Forward iterator over the elements in order, block by block.
+   */
+  class Iterator {
+  private:
+    const Blocks *blocks;
+    size_t block;
+    size_t offset;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    Iterator() : blocks(nullptr), block(0), offset(0) {}
+
+    Iterator(const Blocks *blocks, size_t block)
+        : blocks(blocks), block(block), offset(0) {}
+
+    reference operator*() const { return (*blocks)[block][offset]; }
+    pointer operator->() const { return &(*blocks)[block][offset]; }
+
+    Iterator &operator++() {
+      if (++offset == (*blocks)[block].size()) {
+        ++block;
+        offset = 0;
+      }
+
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return block == other.block && offset == other.offset;
+    }
+
+    bool operator!=(const Iterator &other) const { return !(*this == other); }
+  };
+
+  /**
+   * Index returned by find when nothing matches.
+   */
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /**
+   * Empty array whose blocks hold at most `blockCapacity` elements.
+   *
+   * @complexity O(1)
+   */
+  ChunkedOrderedArray() : ChunkedOrderedArray(1024) {}
+
+  /**
+   * Empty array with blocks of at most `blockCapacity` elements, ordered by
+   * `comp` and allocating from `allocator`.
+   *
+   * @complexity O(1)
+   */
+  explicit ChunkedOrderedArray(size_t blockCapacity,
+                               const Compare &comp = Compare(),
+                               const Allocator &allocator = Allocator())
+      : allocator(allocator), blocks(allocator), blockLast(allocator),
+        blockCounts(1, 0, allocator), blockCapacity(blockCapacity),
+        comp(comp) {
+    if (blockCapacity < 4) {
+      throw std::invalid_argument("Block capacity must be at least 4");
+    }
+  }
+
+  /**
+   * Constructor using an initializer list.
+   *
+   * @complexity O(n log n)
+   */
+  ChunkedOrderedArray(std::initializer_list<T> init,
+                      size_t blockCapacity = 1024,
+                      const Compare &comp = Compare(),
+                      const Allocator &allocator = Allocator())
+      : ChunkedOrderedArray(blockCapacity, comp, allocator) {
+    insertRange(init.begin(), init.end());
+  }
+
+  /**
+   * Return size.
+   *
+   * @complexity O(1)
+   */
+  size_t getSize() const { return size; }
+
+  /**
+   * Return the number of blocks.
+   *
+   * @complexity O(1)
+   */
+  size_t getBlockCount() const { return blocks.size(); }
+
+  /**
+   * Contiguous view of block `b`, invalidated by the next mutation.
+   *
+   * @complexity O(1)
+   */
+  ArrayView<T> getBlock(size_t b) const {
+    if (b >= blocks.size()) {
+      throw std::out_of_range("Block index out of range");
+    }
+
+    return ArrayView<T>(blocks[b].data(), blocks[b].size());
+  }
+
+  /**
+   * Access an element at a specific index.
+   *
+   * @complexity O(log(n / B))
+   */
+  const T &get(size_t index) const {
+    if (index >= size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    auto [b, offset] = locate(index);
+
+    return blocks[b][offset];
+  }
+
+  /**
+   * Binary search over the block index, then inside one block.
+   *
+   * @complexity O(log n)
+   * @return index of the first element equivalent to `value`, or npos if
+   * not found.
+   */
+  size_t find(const T &value) const { return findKey(value); }
+
+  /**
+   * find by any key type the transparent comparator accepts.
+   *
+   * @complexity O(log n)
+   */
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_t find(const K &key) const {
+    return findKey(key);
+  }
+
+  /**
+   * Index of the first element that does not precede `value` in the
+   * array's order, or getSize() if there is none.
+   *
+   * @complexity O(log n)
+   */
+  size_t lowerBound(const T &value) const { return bound(value, false); }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_t lowerBound(const K &key) const {
+    return bound(key, false);
+  }
+
+  /**
+   * Index of the first element that `value` precedes in the array's order,
+   * or getSize() if there is none.
+   *
+   * @complexity O(log n)
+   */
+  size_t upperBound(const T &value) const { return bound(value, true); }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_t upperBound(const K &key) const {
+    return bound(key, true);
+  }
+
+  /**
+   * Half-open index range [first, second) of the elements equivalent to
+   * `value`.
+   *
+   * @complexity O(log n)
+   */
+  std::pair<size_t, size_t> equalRange(const T &value) const {
+    return {bound(value, false), bound(value, true)};
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<size_t, size_t> equalRange(const K &key) const {
+    return {bound(key, false), bound(key, true)};
+  }
+
+  /**
+   * Insert an element after any equal ones, shifting only its block.
+   *
+   * @complexity
+   * - Worst: O(B + n / B) (If the block splits)
+   * - Average: O(B + log n)
+   * - Best: O(log n)
+   */
+  void insert(const T &value) {
+    if (blocks.empty()) {
+      blocks.push_back(Block(allocator));
+      blocks.back().reserve(blockCapacity);
+      blocks.back().push_back(value);
+      blockLast.push_back(value);
+      ++size;
+      rebuildCounts();
+      return;
+    }
+
+    size_t b = std::min(findBlock(value, true), blocks.size() - 1);
+
+    if (blocks[b].size() == blockCapacity) {
+      split(b);
+
+      if (!precedes(value, blockLast[b])) {
+        ++b;
+      }
+    }
+
+    Block &block = blocks[b];
+    size_t offset = findInBlock(b, value, true);
+    this->addMoves(block.size() - offset);
+    block.insert(block.begin() + offset, value);
+
+    blockLast[b] = block.back();
+    ++size;
+    adjustCount(b, 1);
+  }
+
+  /**
+   * Insert every element of [first, last). An empty array is bulk loaded
+   * into blocks filled to three quarters, leaving room for later inserts.
+   *
+   * @complexity
+   * - Worst: O(k (B + log n))
+   * - Average: O(k (B + log n)), O(k log k) into an empty array
+   * - Best: O(k) (Sorted batch into an empty array)
+   */
+  template <typename InputIt> void insertRange(InputIt first, InputIt last) {
+    std::vector<T> batch(first, last);
+
+    if (!blocks.empty()) {
+      for (const T &value : batch) {
+        insert(value);
+      }
+
+      return;
+    }
+
+    auto order = [this](const T &a, const T &b) { return precedes(a, b); };
+
+    if (!std::is_sorted(batch.begin(), batch.end(), order)) {
+      std::sort(batch.begin(), batch.end(), order);
+    }
+
+    size_t fill = std::max<size_t>(1, blockCapacity * 3 / 4);
+
+    for (size_t start = 0; start < batch.size(); start += fill) {
+      size_t end = std::min(batch.size(), start + fill);
+      blocks.push_back(Block(allocator));
+      blocks.back().reserve(blockCapacity);
+      blocks.back().assign(std::make_move_iterator(batch.begin() + start),
+                           std::make_move_iterator(batch.begin() + end));
+      blockLast.push_back(blocks.back().back());
+    }
+
+    size = batch.size();
+    rebuildCounts();
+  }
+
+  /**
+   * Remove an element at a specific index, shifting only its block.
+   *
+   * @complexity
+   * - Worst: O(B + n / B) (If blocks merge)
+   * - Average: O(B + log n)
+   * - Best: O(log n)
+   */
+  void remove(size_t index) {
+    if (index >= size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    auto [b, offset] = locate(index);
+
+    Block &block = blocks[b];
+    this->addMoves(block.size() - 1 - offset);
+    block.erase(block.begin() + offset);
+
+    --size;
+    adjustCount(b, static_cast<size_t>(-1));
+    rebalance(b);
+  }
+
+  /**
+   * Return the operation counters of the Stats policy (all zero for
+   * NoStats).
+   *
+   * @complexity O(1)
+   */
+  const OperationCounts &stats() const { return Stats::stats(); }
+
+  /**
+   * Reset the operation counters.
+   *
+   * @complexity O(1)
+   */
+  void resetStats() { Stats::resetStats(); }
+
+  // Begin iterator
+  Iterator begin() const { return Iterator(&blocks, 0); }
+
+  // End iterator
+  Iterator end() const { return Iterator(&blocks, blocks.size()); }
+};
+
+namespace pmr {
+
+/**
+ * ChunkedOrderedArray allocating from a std::pmr::memory_resource.
+ */
+template <typename T, typename Compare = std::less<T>,
+          typename Stats = NoStats>
+using ChunkedOrderedArray = ::ChunkedOrderedArray<
+    T, Compare, Stats, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
+
+#endif // CHUNKED_ORDERED_ARRAY_CPP
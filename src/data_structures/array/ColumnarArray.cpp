@@ -0,0 +1,305 @@
+#ifndef COLUMNAR_ARRAY_CPP
+#define COLUMNAR_ARRAY_CPP
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../../sortings/Argsort.cpp"
+#include "ArrayView.cpp"
+#include "DynamicArray.cpp"
+
+/**
+ * ColumnarArray
+ *
+ * Struct-of-arrays counterpart of a DynamicArray of records: row i is the
+ * key `getKey(i)` plus one value per payload column, `get<C>(i)`, and each
+ * column is its own DynamicArray.
+ *
+ * Searching and sorting touch only the dense key column, so every cache
+ * line carries as many keys as fit in it instead of one record. `find`
+ * uses the SIMD kernels of DynamicArray::find; `sort` argsorts the keys
+ * alone and then moves each payload element exactly once.
+ *
+ * The binary searches (`lowerBound`, `upperBound`, `binarySearch`) expect
+ * the keys sorted by the same comparator, as after `sort(comp)`; nothing
+ * keeps them sorted across later mutations.
+ *
+ * Rows are appended as a whole: if a column fails to grow, the row is
+ * removed from the columns that already took it.
+ */
+template <typename Key, typename... Columns> class ColumnarArray {
+private:
+  DynamicArray<Key> keys;
+  std::tuple<DynamicArray<Columns>...> columns;
+
+  using ColumnIndices = std::index_sequence_for<Columns...>;
+
+  template <size_t... C>
+  void pushColumns(std::index_sequence<C...>, Key &&key, Columns &&...values) {
+    size_t size = keys.getSize();
+
+    try {
+      keys.push_back(std::move(key));
+      (std::get<C>(columns).push_back(std::move(values)), ...);
+    } catch (...) {
+      truncate(size, ColumnIndices());
+      throw;
+    }
+  }
+
+  // Drop the rows from index `size` on in every column.
+  template <size_t... C>
+  void truncate(size_t size, std::index_sequence<C...>) {
+    keys.removeRange(size, keys.getSize());
+    (std::get<C>(columns).removeRange(size, std::get<C>(columns).getSize()),
+     ...);
+  }
+
+  template <size_t... C>
+  void removeRow(size_t index, std::index_sequence<C...>) {
+    keys.remove(index);
+    (std::get<C>(columns).remove(index), ...);
+  }
+
+  template <size_t... C>
+  void reserveRows(size_t rows, std::index_sequence<C...>) {
+    keys.reserve(rows);
+    (std::get<C>(columns).reserve(rows), ...);
+  }
+
+  template <size_t... C>
+  void permuteColumns(const std::vector<size_t> &order,
+                      std::index_sequence<C...>) {
+    applyPermutation(keys.begin(), keys.end(), order);
+    (applyPermutation(std::get<C>(columns).begin(),
+                      std::get<C>(columns).end(), order),
+     ...);
+  }
+
+  /**
+   * Binary search for the first row whose key does not precede `key`
+   * (`upper` false) or that `key` precedes (`upper` true).
+   *
+   * @complexity O(log n)
+   */
+  template <typename Compare>
+  size_t bound(const Key &key, Compare &comp, bool upper) const {
+    const Key *data = keys.begin();
+    size_t low = 0;
+    size_t high = keys.getSize();
+
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      bool goesRight = upper ? !comp(key, data[mid]) : comp(data[mid], key);
+
+      if (goesRight) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+
+    return low;
+  }
+
+public:
+  /**
+   * Type of payload column C.
+   */
+  template <size_t C>
+  using ColumnType = std::tuple_element_t<C, std::tuple<Columns...>>;
+
+  /**
+   * Number of payload columns.
+   */
+  static constexpr size_t columnCount = sizeof...(Columns);
+
+  /**
+   * Index returned by the search functions when nothing matches.
+   */
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /**
+   * Return the number of rows.
+   *
+   * @complexity O(1)
+   */
+  size_t getSize() const { return keys.getSize(); }
+
+  /**
+   * Whether there are no rows.
+   *
+   * @complexity O(1)
+   */
+  bool isEmpty() const { return keys.getSize() == 0; }
+
+  /**
+   * Ensure room for at least `rows` rows in every column.
+   *
+   * @complexity O(n)
+   */
+  void reserve(size_t rows) { reserveRows(rows, ColumnIndices()); }
+
+  /**
+   * Append a row.
+   *
+   * @complexity
+   * - Worst: O(n) (If the columns have to grow)
+   * - Average: O(1) (Amortized)
+   * - Best: O(1)
+   */
+  void push_back(Key key, Columns... values) {
+    pushColumns(ColumnIndices(), std::move(key), std::move(values)...);
+  }
+
+  /**
+   * Return the key of a row.
+   *
+   * @complexity O(1)
+   */
+  const Key &getKey(size_t index) const { return keys.getAt(index); }
+
+  /**
+   * Set the key of a row.
+   *
+   * @complexity O(1)
+   */
+  void setKey(size_t index, const Key &key) { keys.setAt(index, key); }
+
+  /**
+   * Return the value of column C in a row.
+   *
+   * @complexity O(1)
+   */
+  template <size_t C> const ColumnType<C> &get(size_t index) const {
+    return std::get<C>(columns).getAt(index);
+  }
+
+  /**
+   * Set the value of column C in a row.
+   *
+   * @complexity O(1)
+   */
+  template <size_t C> void set(size_t index, const ColumnType<C> &value) {
+    std::get<C>(columns).setAt(index, value);
+  }
+
+  /**
+   * View of the key column.
+   *
+   * @complexity O(1)
+   */
+  ArrayView<Key> keyView() const {
+    return ArrayView<Key>(keys.begin(), keys.getSize());
+  }
+
+  /**
+   * View of payload column C.
+   *
+   * @complexity O(1)
+   */
+  template <size_t C> ArrayView<ColumnType<C>> column() const {
+    const DynamicArray<ColumnType<C>> &values = std::get<C>(columns);
+
+    return ArrayView<ColumnType<C>>(values.begin(), values.getSize());
+  }
+
+  /**
+   * (Linear) Search for a key, reading only the key column.
+   *
+   * @complexity O(n)
+   * @return index of the first row with that key or npos if not found.
+   */
+  size_t find(const Key &key) const { return keys.find(key); }
+
+  /**
+   * Sort the rows by key under `comp`. The keys are argsorted on their own,
+   * then every column is permuted in one pass.
+   *
+   * Stable.
+   *
+   * @complexity O(n log n), O(n) key-moves and payload-moves per column
+   */
+  template <typename Compare> void sort(Compare comp) {
+    std::vector<size_t> order = argsortByKey(
+        keys.begin(), keys.end(), [](const Key &key) { return key; }, comp);
+    permuteColumns(order, ColumnIndices());
+  }
+
+  void sort() { sort(std::less<>()); }
+
+  /**
+   * Index of the first row whose key does not precede `key`, or getSize()
+   * if there is none. The keys must be sorted by `comp`.
+   *
+   * @complexity O(log n)
+   */
+  template <typename Compare>
+  size_t lowerBound(const Key &key, Compare comp) const {
+    return bound(key, comp, false);
+  }
+
+  size_t lowerBound(const Key &key) const {
+    return lowerBound(key, std::less<>());
+  }
+
+  /**
+   * Index of the first row whose key `key` precedes, or getSize() if there
+   * is none. The keys must be sorted by `comp`.
+   *
+   * @complexity O(log n)
+   */
+  template <typename Compare>
+  size_t upperBound(const Key &key, Compare comp) const {
+    return bound(key, comp, true);
+  }
+
+  size_t upperBound(const Key &key) const {
+    return upperBound(key, std::less<>());
+  }
+
+  /**
+   * Binary search for a key. The keys must be sorted by `comp`.
+   *
+   * @complexity O(log n)
+   * @return index of the first row with an equivalent key, or npos if not
+   * found.
+   */
+  template <typename Compare>
+  size_t binarySearch(const Key &key, Compare comp) const {
+    size_t index = bound(key, comp, false);
+
+    return index < keys.getSize() && !comp(key, keys.begin()[index]) ? index
+                                                                     : npos;
+  }
+
+  size_t binarySearch(const Key &key) const {
+    return binarySearch(key, std::less<>());
+  }
+
+  /**
+   * Remove a row, shifting the following rows in every column.
+   *
+   * @complexity O(n)
+   */
+  void remove(size_t index) {
+    if (index >= keys.getSize()) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    removeRow(index, ColumnIndices());
+  }
+
+  /**
+   * Remove every row.
+   *
+   * @complexity O(n)
+   */
+  void clear() { truncate(0, ColumnIndices()); }
+};
+
+#endif // COLUMNAR_ARRAY_CPP
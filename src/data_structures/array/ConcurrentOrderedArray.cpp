@@ -0,0 +1,642 @@
+#ifndef CONCURRENT_ORDERED_ARRAY_CPP
+#define CONCURRENT_ORDERED_ARRAY_CPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ArrayView.cpp"
+
+// Assumed cache line size, used to keep reader slots and the published
+// pointer off the lines the writer updates.
+constexpr size_t concurrentCacheLineSize = 64;
+
+/**
+ * ConcurrentOrderedArray
+ *
+ * Sorted container for one writer thread and many reader threads. Reads
+ * never take a lock:
+ *
+ * 1. **Snapshots**: the contents are an immutable Snapshot, published
+ *    through an atomic pointer. A reader loads the pointer and searches the
+ *    snapshot like a ChunkedOrderedArray (an index of block maxima, then
+ *    one block).
+ * 2. **Batched writes**: insert() and remove() only queue updates; publish()
+ *    applies the whole batch to a copy of the snapshot and swaps it in.
+ *    Blocks no update touches are shared with the previous snapshot, so a
+ *    publish copies O(n / B) index entries plus the touched blocks.
+ * 3. **Epoch reclamation**: every Reader owns a slot on its own cache line
+ *    and records the global epoch there while it reads. The writer bumps
+ *    the epoch on each publish and frees a replaced snapshot once no slot
+ *    still shows an older epoch, so readers never wait and never write to a
+ *    line another thread writes.
+ *
+ * Readers observe a batch all at once or not at all. Only one thread may
+ * call the writer methods; Readers may be used from any number of threads,
+ * each with its own Reader.
+ */
+template <typename T, typename Compare = std::less<T>>
+class ConcurrentOrderedArray {
+private:
+  using Block = std::vector<T>;
+  using SharedBlock = std::shared_ptr<const Block>;
+
+  struct alignas(concurrentCacheLineSize) ReaderSlot {
+    // Epoch the reader entered at, or 0 while it is not reading.
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<bool> claimed{false};
+  };
+
+  struct Update {
+    T value;
+    bool insert;
+  };
+
+public:
+  class Reader;
+
+  /**
+   * Immutable contents of the array as of one publish().
+   */
+  class Snapshot {
+  private:
+    friend class ConcurrentOrderedArray;
+
+    std::vector<SharedBlock> blocks;
+    std::vector<T> blockLast;
+    std::vector<size_t> blockStart;
+    size_t size = 0;
+    uint64_t version = 0;
+    Compare comp;
+
+    explicit Snapshot(const Compare &comp) : comp(comp) {}
+
+    /**
+     * Index of the block holding the lower or upper bound of `value`, or
+     * the block count if it lies past the last element.
+     *
+     * @complexity O(log(n / B))
+     */
+    template <typename K> size_t findBlock(const K &value, bool upper) const {
+      auto order = [this](const auto &x, const auto &y) { return comp(x, y); };
+
+      return (upper ? std::upper_bound(blockLast.begin(), blockLast.end(),
+                                       value, order)
+                    : std::lower_bound(blockLast.begin(), blockLast.end(),
+                                       value, order)) -
+             blockLast.begin();
+    }
+
+    /**
+     * Global index of the bound of `value`.
+     *
+     * @complexity O(log n)
+     */
+    template <typename K> size_t bound(const K &value, bool upper) const {
+      size_t b = findBlock(value, upper);
+
+      if (b == blocks.size()) {
+        return size;
+      }
+
+      auto order = [this](const auto &x, const auto &y) { return comp(x, y); };
+      const Block &block = *blocks[b];
+
+      return blockStart[b] +
+             ((upper ? std::upper_bound(block.begin(), block.end(), value,
+                                        order)
+                     : std::lower_bound(block.begin(), block.end(), value,
+                                        order)) -
+              block.begin());
+    }
+
+    /**
+     * Append a block, merging it into the previous one when it is small
+     * and both fit.
+     *
+     * @complexity O(B)
+     */
+    void appendBlock(SharedBlock block, size_t blockCapacity) {
+      if (!blocks.empty() && block->size() < blockCapacity / 4 &&
+          blocks.back()->size() + block->size() <= blockCapacity) {
+        Block merged(*blocks.back());
+        merged.insert(merged.end(), block->begin(), block->end());
+        blocks.back() = std::make_shared<const Block>(std::move(merged));
+        return;
+      }
+
+      blocks.push_back(std::move(block));
+    }
+
+    /**
+     * Rebuild the index and block starts once all blocks are in place.
+     *
+     * @complexity O(n / B)
+     */
+    void finish() {
+      blockLast.clear();
+      blockStart.clear();
+      blockLast.reserve(blocks.size());
+      blockStart.reserve(blocks.size());
+      size = 0;
+
+      for (const SharedBlock &block : blocks) {
+        blockLast.push_back(block->back());
+        blockStart.push_back(size);
+        size += block->size();
+      }
+    }
+
+  public:
+    /**
+     * Index returned by find when nothing matches.
+     */
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * Return size.
+     *
+     * @complexity O(1)
+     */
+    size_t getSize() const { return size; }
+
+    /**
+     * Number of publish() calls that led to this snapshot.
+     *
+     * @complexity O(1)
+     */
+    uint64_t getVersion() const { return version; }
+
+    /**
+     * Return the number of blocks.
+     *
+     * @complexity O(1)
+     */
+    size_t getBlockCount() const { return blocks.size(); }
+
+    /**
+     * Contiguous view of block `b`, valid as long as the snapshot.
+     *
+     * @complexity O(1)
+     */
+    ArrayView<T> getBlock(size_t b) const {
+      if (b >= blocks.size()) {
+        throw std::out_of_range("Block index out of range");
+      }
+
+      return ArrayView<T>(blocks[b]->data(), blocks[b]->size());
+    }
+
+    /**
+     * Access an element at a specific index.
+     *
+     * @complexity O(log(n / B))
+     */
+    const T &get(size_t index) const {
+      if (index >= size) {
+        throw std::out_of_range("Index out of range");
+      }
+
+      size_t b = std::upper_bound(blockStart.begin(), blockStart.end(),
+                                  index) -
+                 blockStart.begin() - 1;
+
+      return (*blocks[b])[index - blockStart[b]];
+    }
+
+    /**
+     * Binary search over the block index, then inside one block.
+     *
+     * @complexity O(log n)
+     * @return index of the first element equivalent to `value`, or npos if
+     * not found.
+     */
+    size_t find(const T &value) const { return findKey(value); }
+
+    /**
+     * find by any key type the transparent comparator accepts.
+     *
+     * @complexity O(log n)
+     */
+    template <typename K, typename C = Compare,
+              typename = typename C::is_transparent>
+    size_t find(const K &key) const {
+      return findKey(key);
+    }
+
+    /**
+     * Index of the first element that does not precede `value`, or
+     * getSize() if there is none.
+     *
+     * @complexity O(log n)
+     */
+    size_t lowerBound(const T &value) const { return bound(value, false); }
+
+    template <typename K, typename C = Compare,
+              typename = typename C::is_transparent>
+    size_t lowerBound(const K &key) const {
+      return bound(key, false);
+    }
+
+    /**
+     * Index of the first element that `value` precedes, or getSize() if
+     * there is none.
+     *
+     * @complexity O(log n)
+     */
+    size_t upperBound(const T &value) const { return bound(value, true); }
+
+    template <typename K, typename C = Compare,
+              typename = typename C::is_transparent>
+    size_t upperBound(const K &key) const {
+      return bound(key, true);
+    }
+
+  private:
+    template <typename K> size_t findKey(const K &value) const {
+      size_t index = bound(value, false);
+
+      return index < size && !comp(value, get(index)) ? index : npos;
+    }
+  };
+
+  /**
+   * A reader thread's handle. It claims a slot on construction and gives
+   * it back on destruction; a Reader must not be shared between threads.
+   */
+  class Reader {
+  private:
+    const ConcurrentOrderedArray *owner;
+    ReaderSlot *slot = nullptr;
+
+  public:
+    /**
+     * Claim a reader slot of `owner`.
+     *
+     * @complexity O(maxReaders)
+     */
+    explicit Reader(const ConcurrentOrderedArray &owner) : owner(&owner) {
+      for (size_t i = 0; i < owner.slotCount; ++i) {
+        bool expected = false;
+
+        if (owner.slots[i].claimed.compare_exchange_strong(expected, true)) {
+          slot = &owner.slots[i];
+          return;
+        }
+      }
+
+      throw std::runtime_error("All reader slots are in use");
+    }
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    /**
+     * Give the slot back.
+     *
+     * @complexity O(1)
+     */
+    ~Reader() { slot->claimed.store(false, std::memory_order_release); }
+
+    /**
+     * Call `fn` with the current snapshot, which stays alive until `fn`
+     * returns. Must not be nested on the same Reader.
+     *
+     * @complexity O(1) plus `fn`
+     */
+    template <typename Function>
+    auto read(Function fn) -> decltype(fn(std::declval<const Snapshot &>())) {
+      struct Leave {
+        ReaderSlot *slot;
+        ~Leave() { slot->epoch.store(0, std::memory_order_release); }
+      } leave{slot};
+
+      // Announcing the epoch before loading the pointer is what lets the
+      // writer tell which snapshots this reader may still hold.
+      slot->epoch.store(owner->published.epoch.load());
+
+      return fn(*owner->published.snapshot.load());
+    }
+
+    /**
+     * Whether the current snapshot holds an element equivalent to `key`.
+     *
+     * @complexity O(log n)
+     */
+    template <typename K> bool contains(const K &key) {
+      return read([&key](const Snapshot &snapshot) {
+        return snapshot.find(key) != Snapshot::npos;
+      });
+    }
+
+    /**
+     * Copy the first element equivalent to `key` into `out`.
+     *
+     * @complexity O(log n)
+     * @return whether an element was found.
+     */
+    template <typename K> bool lookup(const K &key, T &out) {
+      return read([&key, &out](const Snapshot &snapshot) {
+        size_t index = snapshot.find(key);
+
+        if (index == Snapshot::npos) {
+          return false;
+        }
+
+        out = snapshot.get(index);
+        return true;
+      });
+    }
+  };
+
+private:
+  // The only state readers load; written once per publish.
+  struct alignas(concurrentCacheLineSize) Published {
+    std::atomic<const Snapshot *> snapshot{nullptr};
+    std::atomic<uint64_t> epoch{1};
+  };
+
+  Published published;
+  std::unique_ptr<ReaderSlot[]> slots;
+  size_t slotCount;
+
+  // Writer-only state.
+  alignas(concurrentCacheLineSize) std::vector<Update> pending;
+  std::vector<std::pair<uint64_t, const Snapshot *>> retired;
+  size_t blockCapacity;
+  Compare comp;
+
+  /**
+   * Drop the last block element of `next` if it is equivalent to `key`.
+   *
+   * @complexity O(B)
+   */
+  void removeLastEmitted(Snapshot &next, const T &key) {
+    if (next.blocks.empty() || comp(next.blocks.back()->back(), key)) {
+      return;
+    }
+
+    Block shrunk(next.blocks.back()->begin(), next.blocks.back()->end() - 1);
+
+    if (shrunk.empty()) {
+      next.blocks.pop_back();
+    } else {
+      next.blocks.back() = std::make_shared<const Block>(std::move(shrunk));
+    }
+  }
+
+  /**
+   * Apply the updates in [first, last), sorted by value, to the elements of
+   * `block`. Equal keys are applied in the order they were queued, and a
+   * remove drops the last element equivalent to its key, which may end the
+   * blocks already emitted to `next` when `block` holds none.
+   *
+   * @complexity O(B + k)
+   */
+  Block mergeBlock(Snapshot &next, const Block &block, size_t first,
+                   size_t last) {
+    Block out;
+    out.reserve(block.size() + (last - first));
+    size_t i = 0;
+
+    for (size_t u = first; u < last; ++u) {
+      T &key = pending[u].value;
+
+      while (i < block.size() && !comp(key, block[i])) {
+        out.push_back(block[i++]);
+      }
+
+      if (pending[u].insert) {
+        out.push_back(std::move(key));
+      } else if (out.empty()) {
+        removeLastEmitted(next, key);
+      } else if (!comp(out.back(), key)) {
+        out.pop_back();
+      }
+    }
+
+    out.insert(out.end(), block.begin() + i, block.end());
+
+    return out;
+  }
+
+  /**
+   * Append a rebuilt block to `next`, split into equal parts of at most
+   * blockCapacity elements.
+   *
+   * @complexity O(B)
+   */
+  void appendMerged(Snapshot &next, Block &&merged) {
+    if (merged.empty()) {
+      return;
+    }
+
+    if (merged.size() <= blockCapacity) {
+      next.appendBlock(std::make_shared<const Block>(std::move(merged)),
+                       blockCapacity);
+      return;
+    }
+
+    size_t parts = (merged.size() + blockCapacity - 1) / blockCapacity;
+
+    for (size_t p = 0; p < parts; ++p) {
+      auto from = merged.begin() + merged.size() * p / parts;
+      auto to = merged.begin() + merged.size() * (p + 1) / parts;
+      next.blocks.push_back(std::make_shared<const Block>(
+          std::make_move_iterator(from), std::make_move_iterator(to)));
+    }
+  }
+
+  /**
+   * Smallest epoch a reader is currently inside, or UINT64_MAX if none is.
+   *
+   * @complexity O(maxReaders)
+   */
+  uint64_t oldestActiveEpoch() const {
+    uint64_t oldest = UINT64_MAX;
+
+    for (size_t i = 0; i < slotCount; ++i) {
+      uint64_t epoch = slots[i].epoch.load();
+
+      if (epoch != 0) {
+        oldest = std::min(oldest, epoch);
+      }
+    }
+
+    return oldest;
+  }
+
+public:
+  /**
+   * Empty array for up to `maxReaders` simultaneous Readers, with blocks
+   * of at most `blockCapacity` elements.
+   *
+   * @complexity O(maxReaders)
+   */
+  explicit ConcurrentOrderedArray(size_t maxReaders = 64,
+                                  size_t blockCapacity = 1024,
+                                  const Compare &comp = Compare())
+      : slots(new ReaderSlot[maxReaders]), slotCount(maxReaders),
+        blockCapacity(blockCapacity), comp(comp) {
+    if (blockCapacity < 4) {
+      throw std::invalid_argument("Block capacity must be at least 4");
+    }
+
+    published.snapshot.store(new Snapshot(comp));
+  }
+
+  ConcurrentOrderedArray(const ConcurrentOrderedArray &) = delete;
+  ConcurrentOrderedArray &operator=(const ConcurrentOrderedArray &) = delete;
+
+  /**
+   * Free every snapshot. No Reader may outlive the array.
+   *
+   * @complexity O(n / B + retired snapshots)
+   */
+  ~ConcurrentOrderedArray() {
+    delete published.snapshot.load();
+
+    for (const auto &entry : retired) {
+      delete entry.second;
+    }
+  }
+
+  /**
+   * The latest published snapshot, for the writer thread. Valid until its
+   * next publish().
+   *
+   * @complexity O(1)
+   */
+  const Snapshot &current() const { return *published.snapshot.load(); }
+
+  /**
+   * Queue an insertion for the next publish().
+   *
+   * @complexity O(1) amortized
+   */
+  void insert(const T &value) { pending.push_back(Update{value, true}); }
+
+  /**
+   * Queue insertions of every element in [first, last).
+   *
+   * @complexity O(k) amortized
+   */
+  template <typename InputIt> void insertRange(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  /**
+   * Queue the removal of one element equivalent to `value`, if the array
+   * holds one when the batch is applied.
+   *
+   * @complexity O(1) amortized
+   */
+  void remove(const T &value) { pending.push_back(Update{value, false}); }
+
+  /**
+   * Return the number of queued updates.
+   *
+   * @complexity O(1)
+   */
+  size_t getPendingCount() const { return pending.size(); }
+
+  /**
+   * Apply the queued updates to a new snapshot, make it visible to readers
+   * and retire the previous one. Blocks without updates are shared.
+   *
+   * @complexity O(k log k + n / B + B * touched blocks)
+   * @return the version of the published snapshot.
+   */
+  uint64_t publish() {
+    const Snapshot *previous = published.snapshot.load();
+
+    if (pending.empty()) {
+      return previous->version;
+    }
+
+    std::stable_sort(pending.begin(), pending.end(),
+                     [this](const Update &a, const Update &b) {
+                       return comp(a.value, b.value);
+                     });
+
+    std::unique_ptr<Snapshot> next(new Snapshot(comp));
+    next->version = previous->version + 1;
+    next->blocks.reserve(previous->blocks.size() + 1);
+
+    if (previous->blocks.empty()) {
+      appendMerged(*next, mergeBlock(*next, Block(), 0, pending.size()));
+    }
+
+    // Each update goes to the first block whose last element it precedes,
+    // the rest to the last block, so the block also holds the last element
+    // equivalent to it unless that one ends an earlier block.
+    size_t u = 0;
+
+    for (size_t b = 0; b < previous->blocks.size(); ++b) {
+      bool lastBlock = b + 1 == previous->blocks.size();
+      size_t end = u;
+
+      while (end < pending.size() &&
+             (lastBlock || comp(pending[end].value, previous->blockLast[b]))) {
+        ++end;
+      }
+
+      if (end == u) {
+        next->appendBlock(previous->blocks[b], blockCapacity);
+      } else {
+        appendMerged(*next,
+                     mergeBlock(*next, *previous->blocks[b], u, end));
+        u = end;
+      }
+    }
+
+    next->finish();
+    pending.clear();
+
+    published.snapshot.store(next.release());
+    retired.emplace_back(published.epoch.fetch_add(1) + 1, previous);
+    reclaim();
+
+    return published.snapshot.load()->version;
+  }
+
+  /**
+   * Free the retired snapshots no reader can still hold.
+   *
+   * @complexity O(maxReaders + retired snapshots)
+   * @return the number of snapshots freed.
+   */
+  size_t reclaim() {
+    uint64_t oldest = oldestActiveEpoch();
+    auto keep = std::partition(retired.begin(), retired.end(),
+                               [oldest](const auto &entry) {
+                                 return entry.first > oldest;
+                               });
+
+    for (auto it = keep; it != retired.end(); ++it) {
+      delete it->second;
+    }
+
+    size_t freed = retired.end() - keep;
+    retired.erase(keep, retired.end());
+
+    return freed;
+  }
+
+  /**
+   * Return the number of replaced snapshots waiting for readers to leave.
+   *
+   * @complexity O(1)
+   */
+  size_t getRetiredCount() const { return retired.size(); }
+};
+
+#endif // CONCURRENT_ORDERED_ARRAY_CPP
@@ -1,6 +1,40 @@
+#ifndef DYNAMIC_ARRAY_CPP
+#define DYNAMIC_ARRAY_CPP
+
 #include <algorithm>
+#include <cstring>
 #include <initializer_list>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../utils/OperationStats.cpp"
+#include "VectorizedSearch.cpp"
+
+// Smallest heap capacity, so that arrays spilling from no or tiny inline
+// storage skip the 1, 2, 4 reallocation steps.
+constexpr size_t dynamicArrayMinHeapCapacity = 4;
+
+/**
+ * Uninitialized storage for the first N elements of a DynamicArray. The
+ * N = 0 specialization is empty and takes no space.
+ */
+template <typename T, size_t N> struct DynamicArrayInlineBuffer {
+  alignas(T) unsigned char inlineBytes[N * sizeof(T)];
+
+  T *inlineData() { return reinterpret_cast<T *>(inlineBytes); }
+  const T *inlineData() const {
+    return reinterpret_cast<const T *>(inlineBytes);
+  }
+};
+
+template <typename T> struct DynamicArrayInlineBuffer<T, 0> {
+  T *inlineData() { return nullptr; }
+  const T *inlineData() const { return nullptr; }
+};
 
 /**
  * DynamicArray
@@ -31,15 +65,78 @@
  *    - Fixed-size Array: Generally faster for access and insertion when the
  * size is known and fixed.
  *
+ * Storage is allocated uninitialized through std::allocator_traits, so only
+ * the first `size` slots hold live objects. Growing never default-constructs
+ * the new buffer and T does not need to be default-constructible.
+ *
+ * The `Stats` policy counts comparisons, shifted elements and reallocations.
+ * The default NoStats compiles away; CountingStats exposes them via stats().
+ *
+ * `InlineCapacity` elements are stored inside the object itself, like a
+ * small_vector: arrays that never outgrow it never touch the heap, and the
+ * elements spill into an allocation only once it is exceeded. With the
+ * default of 0, a default-constructed array still allocates nothing until
+ * the first insertion. SmallDynamicArray<T, N> is the shorthand.
+ *
+ * Heap buffers come from `Allocator`. pmr::DynamicArray<T> uses
+ * std::pmr::polymorphic_allocator, so arrays built during a request can
+ * draw from a monotonic_buffer_resource or a pool and be released with it.
+ *
  */
-template <typename T> class DynamicArray {
+template <typename T, typename Stats = NoStats, size_t InlineCapacity = 0,
+          typename Allocator = std::allocator<T>>
+class DynamicArray : private Stats,
+                     private DynamicArrayInlineBuffer<T, InlineCapacity> {
 private:
+  static_assert(std::is_same<typename Allocator::value_type, T>::value,
+                "Allocator::value_type must be T");
+
+  using AllocatorTraits = std::allocator_traits<Allocator>;
+  using InlineBuffer = DynamicArrayInlineBuffer<T, InlineCapacity>;
+
+  // Inline elements cannot be stolen, so moving them is only as noexcept
+  // as T's move constructor.
+  static constexpr bool nothrowInlineMove =
+      InlineCapacity == 0 || std::is_nothrow_move_constructible<T>::value;
+
+  Allocator allocator;
   T *data;
   size_t size;
   size_t capacity;
+  double growthFactor = 2.0;
+
+  /**
+   * Move `count` live elements from `from` into the uninitialized buffer `to`
+   * and end their lifetime in `from`. Trivially copyable types are relocated
+   * with a single memcpy.
+   *
+   * @complexity O(n)
+   */
+  static void relocate(T *from, size_t count, T *to) {
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      if (count > 0) {
+        std::memcpy(static_cast<void *>(to), from, count * sizeof(T));
+      }
+    } else {
+      std::uninitialized_move(from, from + count, to);
+      std::destroy(from, from + count);
+    }
+  }
 
   /**
-   * Resize the array to a new capacity.
+   * Free the heap buffer, if the elements live in one.
+   *
+   * @complexity O(1)
+   */
+  void release() {
+    if (data != this->inlineData()) {
+      AllocatorTraits::deallocate(allocator, data, capacity);
+    }
+  }
+
+  /**
+   * Resize the array to a new capacity. Capacities that fit the inline
+   * storage move the elements back into it.
    *
    * @complexity
    * - Worst: O(n)
@@ -47,56 +144,309 @@ private:
    * - Best: O(n)
    */
   void resize(size_t new_capacity) {
-    T *new_data = new T[new_capacity];
+    bool toInline = new_capacity <= InlineCapacity;
+    T *new_data = toInline ? this->inlineData()
+                           : AllocatorTraits::allocate(allocator, new_capacity);
 
-    for (size_t i = 0; i < size; ++i) {
-      new_data[i] = std::move(data[i]);
+    if (new_data == data) {
+      return;
+    }
+
+    try {
+      relocate(data, size, new_data);
+    } catch (...) {
+      if (!toInline) {
+        AllocatorTraits::deallocate(allocator, new_data, new_capacity);
+      }
+
+      throw;
     }
 
-    delete[] data;
+    release();
     data = new_data;
-    capacity = new_capacity;
+    capacity = toInline ? InlineCapacity : new_capacity;
+    this->addReallocation();
+  }
+
+  /**
+   * Capacity to grow to when at least `required` slots are needed.
+   *
+   * @complexity O(1)
+   */
+  size_t grownCapacity(size_t required) const {
+    size_t grown = static_cast<size_t>(capacity * growthFactor);
+
+    return std::max({grown, required, dynamicArrayMinHeapCapacity});
+  }
+
+  /**
+   * Destroy every element, keeping the storage.
+   *
+   * @complexity O(n)
+   */
+  void destroyElements() {
+    std::destroy(data, data + size);
+    size = 0;
+  }
+
+  /**
+   * Free the heap buffer of an empty array and fall back to the inline
+   * storage.
+   *
+   * @complexity O(1)
+   */
+  void resetStorage() {
+    release();
+    data = this->inlineData();
+    capacity = InlineCapacity;
+  }
+
+  /**
+   * Construct `count` elements from `first` into this empty array, growing
+   * to exactly `count` slots if needed.
+   *
+   * @complexity O(n)
+   */
+  template <typename InputIt> void constructFrom(InputIt first, size_t count) {
+    if (count > capacity) {
+      resetStorage();
+      data = AllocatorTraits::allocate(allocator, count);
+      capacity = count;
+    }
+
+    std::uninitialized_copy_n(first, count, data);
+    size = count;
+  }
+
+  /**
+   * Take the elements of `other` into this empty array, whose allocator
+   * must be able to free `other`'s buffer. A heap buffer changes owner in
+   * O(1); inline elements are moved one by one.
+   *
+   * @complexity O(1), O(N) for inline elements
+   */
+  void takeFrom(DynamicArray &other) noexcept(nothrowInlineMove) {
+    if (other.data != other.inlineData()) {
+      resetStorage();
+      data = std::exchange(other.data, other.inlineData());
+      capacity = std::exchange(other.capacity, InlineCapacity);
+      size = std::exchange(other.size, 0);
+      return;
+    }
+
+    relocate(other.data, other.size, data);
+    size = std::exchange(other.size, 0);
   }
 
 public:
   /**
-   * Default constructor.
+   * Default constructor. Allocates nothing.
    *
    * @complexity O(1)
    */
-  DynamicArray() : size(0), capacity(1) { data = new T[capacity]; }
+  DynamicArray() : DynamicArray(Allocator()) {}
 
   /**
-   * Constructor using an initializer list.
+   * Empty array whose heap buffers come from `allocator`. Allocates
+   * nothing.
+   *
+   * @complexity O(1)
+   */
+  explicit DynamicArray(const Allocator &allocator)
+      : allocator(allocator), data(this->inlineData()), size(0),
+        capacity(InlineCapacity) {}
+
+  /**
+   * Constructor using an initializer list. Lists that fit the inline
+   * storage are kept there.
    *
    * @complexity O(n)
    */
-  DynamicArray(std::initializer_list<T> init)
-      : size(init.size()), capacity(init.size() * 2) {
-    data = new T[capacity];
-    std::copy(init.begin(), init.end(), data);
+  DynamicArray(std::initializer_list<T> init,
+               const Allocator &allocator = Allocator())
+      : allocator(allocator), data(this->inlineData()), size(init.size()),
+        capacity(InlineCapacity) {
+    if (size > InlineCapacity) {
+      capacity = size * 2;
+      data = AllocatorTraits::allocate(this->allocator, capacity);
+    }
+
+    try {
+      std::uninitialized_copy(init.begin(), init.end(), data);
+    } catch (...) {
+      release();
+      throw;
+    }
   }
 
   /**
    * Destructor.
    *
-   * @complexity O(1)
+   * @complexity O(n)
    */
-  ~DynamicArray() { delete[] data; }
+  ~DynamicArray() {
+    std::destroy(data, data + size);
+    release();
+  }
+
+  /**
+   * Deep copy. The copy's capacity is its size (or the inline capacity).
+   *
+   * @complexity O(n)
+   */
+  DynamicArray(const DynamicArray &other)
+      : Stats(other), InlineBuffer(),
+        allocator(AllocatorTraits::select_on_container_copy_construction(
+            other.allocator)),
+        data(this->inlineData()), size(0), capacity(InlineCapacity),
+        growthFactor(other.growthFactor) {
+    try {
+      constructFrom(other.data, other.size);
+    } catch (...) {
+      release();
+      throw;
+    }
+  }
+
+  /**
+   * Take over the buffer of `other`, leaving it empty.
+   *
+   * @complexity O(1), O(N) if `other` holds its elements inline
+   */
+  DynamicArray(DynamicArray &&other) noexcept(nothrowInlineMove)
+      : Stats(other), InlineBuffer(), allocator(std::move(other.allocator)),
+        data(this->inlineData()), size(0), capacity(InlineCapacity),
+        growthFactor(other.growthFactor) {
+    takeFrom(other);
+  }
+
+  /**
+   * Replace the elements with copies of those of `other`, reusing the
+   * buffer when it is large enough.
+   *
+   * @complexity O(n + m)
+   */
+  DynamicArray &operator=(const DynamicArray &other) {
+    if (this == &other) {
+      return *this;
+    }
+
+    destroyElements();
+
+    if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::
+                      value) {
+      if (allocator != other.allocator) {
+        resetStorage();
+      }
+
+      allocator = other.allocator;
+    }
+
+    constructFrom(other.data, other.size);
+    Stats::operator=(other);
+    growthFactor = other.growthFactor;
+
+    return *this;
+  }
+
+  /**
+   * Take over the buffer of `other`, leaving it empty. With allocators
+   * that neither propagate nor compare equal the elements are moved one by
+   * one instead, as std::vector does.
+   *
+   * @complexity O(n) to destroy the old elements, otherwise O(1)
+   */
+  DynamicArray &operator=(DynamicArray &&other) noexcept(
+      nothrowInlineMove &&
+      (AllocatorTraits::propagate_on_container_move_assignment::value ||
+       AllocatorTraits::is_always_equal::value)) {
+    if (this == &other) {
+      return *this;
+    }
+
+    destroyElements();
+
+    if constexpr (AllocatorTraits::propagate_on_container_move_assignment::
+                      value) {
+      resetStorage();
+      allocator = std::move(other.allocator);
+      takeFrom(other);
+    } else if (allocator == other.allocator) {
+      takeFrom(other);
+    } else {
+      constructFrom(std::make_move_iterator(other.data), other.size);
+      other.destroyElements();
+    }
+
+    Stats::operator=(other);
+    growthFactor = other.growthFactor;
+
+    return *this;
+  }
+
+  /**
+   * Exchange the contents of two arrays. Heap buffers are swapped in O(1);
+   * inline elements are moved.
+   *
+   * @complexity O(1), O(N) if either array holds its elements inline
+   */
+  void swap(DynamicArray &other) noexcept(nothrowInlineMove) {
+    if (this == &other) {
+      return;
+    }
+
+    if (data == this->inlineData() || other.data == other.inlineData()) {
+      DynamicArray held(std::move(other));
+      other = std::move(*this);
+      *this = std::move(held);
+      return;
+    }
+
+    if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+      std::swap(allocator, other.allocator);
+    }
+
+    std::swap(static_cast<Stats &>(*this), static_cast<Stats &>(other));
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+    std::swap(capacity, other.capacity);
+    std::swap(growthFactor, other.growthFactor);
+  }
+
+  friend void swap(DynamicArray &a, DynamicArray &b) noexcept(
+      noexcept(a.swap(b))) {
+    a.swap(b);
+  }
 
   /**
    * Return size.
    *
    * @complexity O(1)
    */
-  size_t getSize() { return size; }
+  size_t getSize() const { return size; }
 
   /**
    * Return Capacity.
    *
    * @complexity O(1)
    */
-  size_t getCapacity() { return capacity; }
+  size_t getCapacity() const { return capacity; }
+
+  /**
+   * Return a copy of the allocator.
+   *
+   * @complexity O(1)
+   */
+  Allocator getAllocator() const { return allocator; }
+
+  /**
+   * Whether the elements are currently stored inline, inside the object.
+   *
+   * @complexity O(1)
+   */
+  bool isInline() const {
+    return InlineCapacity > 0 && data == this->inlineData();
+  }
 
   /**
    * Access an element at a specific index.
@@ -124,27 +474,194 @@ public:
     data[index] = value;
   }
 
+  /**
+   * Index returned by the search functions when nothing matches.
+   */
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
   /**
    * (Linear) Search for a value in the array.
    *
+   * 4- and 8-byte arithmetic types compare a whole SIMD register of
+   * elements per step (AVX2 or SSE2, depending on the target).
+   *
    * @complexity
    * - Worst: O(n) (If the value is at the last index or not present)
    * - Average: O(n)
    * - Best: O(1) (If the value is at the first index)
+   * @return index of the first match or npos if not found.
    */
-  int find(const T &value) const {
-    for (size_t i = 0; i < size; ++i) {
-      if (data[i] == value) {
-        return i;
-      }
+  size_t find(const T &value) const {
+    size_t index = vectorizedFind(data, size, value);
+    this->addComparisons(index == size ? size : index + 1);
+
+    return index == size ? npos : index;
+  }
+
+  /**
+   * Count the elements equal to a value.
+   *
+   * @complexity O(n)
+   */
+  size_t count(const T &value) const {
+    this->addComparisons(size);
+
+    return vectorizedCount(data, size, value);
+  }
+
+  /**
+   * Collect the indices of all elements equal to a value, in order.
+   *
+   * @complexity O(n)
+   */
+  std::vector<size_t> findAll(const T &value) const {
+    std::vector<size_t> indices;
+    vectorizedFindAll(data, size, value, indices);
+    this->addComparisons(size);
+
+    return indices;
+  }
+
+  /**
+   * Search for the first element satisfying a predicate.
+   *
+   * The predicate is evaluated in branch-free blocks so simple comparisons
+   * vectorize; it must be side-effect free, as it may also run on elements
+   * after the first match.
+   *
+   * @complexity
+   * - Worst: O(n)
+   * - Average: O(n)
+   * - Best: O(1)
+   * @return index of the first match or npos if not found.
+   */
+  template <typename Predicate> size_t findIf(Predicate predicate) const {
+    size_t index = vectorizedFindIf(data, size, predicate);
+
+    return index == size ? npos : index;
+  }
+
+  /**
+   * Append a copy of an element.
+   *
+   * @complexity
+   * - Worst: O(n) (If the array has to grow)
+   * - Average: O(1) (Amortized)
+   * - Best: O(1)
+   */
+  void push_back(const T &value) { emplace_back(value); }
+
+  /**
+   * Append an element by moving it.
+   *
+   * @complexity
+   * - Worst: O(n) (If the array has to grow)
+   * - Average: O(1) (Amortized)
+   * - Best: O(1)
+   */
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  /**
+   * Construct an element in place at the end of the array.
+   *
+   * When the array is full the new element is constructed in the grown
+   * buffer before the old elements are relocated, so `args` may refer to
+   * elements of this array.
+   *
+   * @complexity
+   * - Worst: O(n) (If the array has to grow)
+   * - Average: O(1) (Amortized)
+   * - Best: O(1)
+   */
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    if (size < capacity) {
+      AllocatorTraits::construct(allocator, data + size,
+                                 std::forward<Args>(args)...);
+      return data[size++];
     }
 
-    return -1;
+    size_t new_capacity = grownCapacity(size + 1);
+    T *new_data = AllocatorTraits::allocate(allocator, new_capacity);
+
+    try {
+      AllocatorTraits::construct(allocator, new_data + size,
+                                 std::forward<Args>(args)...);
+    } catch (...) {
+      AllocatorTraits::deallocate(allocator, new_data, new_capacity);
+      throw;
+    }
+
+    try {
+      relocate(data, size, new_data);
+    } catch (...) {
+      AllocatorTraits::destroy(allocator, new_data + size);
+      AllocatorTraits::deallocate(allocator, new_data, new_capacity);
+      throw;
+    }
+
+    release();
+    data = new_data;
+    capacity = new_capacity;
+    this->addReallocation();
+
+    return data[size++];
+  }
+
+  /**
+   * Ensure room for at least `new_capacity` elements without reallocating.
+   *
+   * @complexity
+   * - Worst: O(n)
+   * - Average: O(n)
+   * - Best: O(1) (If the capacity is already large enough)
+   */
+  void reserve(size_t new_capacity) {
+    if (new_capacity > capacity) {
+      resize(new_capacity);
+    }
+  }
+
+  /**
+   * Release unused capacity, moving the elements back inline if they fit.
+   *
+   * @complexity
+   * - Worst: O(n)
+   * - Average: O(n)
+   * - Best: O(1) (If the array is already full)
+   */
+  void shrink_to_fit() {
+    if (capacity > size) {
+      resize(size);
+    }
+  }
+
+  /**
+   * Return the factor the capacity is multiplied by when the array grows.
+   *
+   * @complexity O(1)
+   */
+  double getGrowthFactor() const { return growthFactor; }
+
+  /**
+   * Set the growth factor, e.g. 1.5 to save memory or 2 for fewer
+   * reallocations.
+   *
+   * @complexity O(1)
+   */
+  void setGrowthFactor(double factor) {
+    if (!(factor > 1.0)) {
+      throw std::invalid_argument("Growth factor must be greater than 1");
+    }
+
+    growthFactor = factor;
   }
 
   /**
    * Insert an element at a specific index.
    *
+   * `value` is copied before any element moves, so it may refer to an
+   * element of this array.
+   *
    * @complexity
    * - Worst: O(n)
    * - Average: O(n)
@@ -155,16 +672,30 @@ public:
       throw std::out_of_range("Index out of range");
     }
 
-    if (index >= capacity) {
-      resize(capacity * 2);
+    if (index == size) {
+      emplace_back(value);
+      return;
     }
 
-    for (size_t i = size; i > index; --i) {
-      data[i] = std::move(data[i - 1]);
+    T item(value);
+
+    if (size >= capacity) {
+      resize(grownCapacity(size + 1));
     }
 
-    data[index] = value;
+    this->addMoves(size - index);
+
+    // The slot past the end is raw storage: construct it from the last
+    // element, then shift the rest of the tail with move assignment.
+    AllocatorTraits::construct(allocator, data + size,
+                               std::move(data[size - 1]));
     ++size;
+
+    for (size_t i = size - 2; i > index; --i) {
+      data[i] = std::move(data[i - 1]);
+    }
+
+    data[index] = std::move(item);
   }
 
   /**
@@ -184,9 +715,139 @@ public:
       data[i] = std::move(data[i + 1]);
     }
 
+    this->addMoves(size - 1 - index);
+
     --size;
+    AllocatorTraits::destroy(allocator, data + size);
+  }
+
+  /**
+   * Remove the elements at indices [first, last), shifting the tail once.
+   *
+   * @complexity
+   * - Worst: O(n)
+   * - Average: O(n)
+   * - Best: O(1) (If the range ends at the last element)
+   */
+  void removeRange(size_t first, size_t last) {
+    if (first > last || last > size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    if (first == last) {
+      return;
+    }
+
+    std::move(data + last, data + size, data + first);
+    this->addMoves(size - last);
+
+    size_t newSize = size - (last - first);
+    std::destroy(data + newSize, data + size);
+    size = newSize;
+  }
+
+  /**
+   * Remove every element satisfying `predicate` in one compacting pass,
+   * keeping the order of the others.
+   *
+   * @complexity O(n)
+   * @return number of removed elements.
+   */
+  template <typename Predicate> size_t removeIf(Predicate predicate) {
+    size_t kept = 0;
+
+    for (size_t i = 0; i < size; ++i) {
+      if (predicate(static_cast<const T &>(data[i]))) {
+        continue;
+      }
+
+      if (kept != i) {
+        data[kept] = std::move(data[i]);
+        this->addMoves(1);
+      }
+
+      ++kept;
+    }
+
+    size_t removed = size - kept;
+    std::destroy(data + kept, data + size);
+    size = kept;
+
+    return removed;
   }
 
+  /**
+   * Assign `value` to every element.
+   *
+   * @complexity O(n)
+   */
+  void fill(const T &value) { std::fill(data, data + size, value); }
+
+  /**
+   * Replace every element `x` with `fn(x)`, in order.
+   *
+   * @complexity O(n)
+   */
+  template <typename Function> void transform(Function fn) {
+    for (size_t i = 0; i < size; ++i) {
+      data[i] = fn(data[i]);
+    }
+  }
+
+  /**
+   * Fold the elements into `init` with `op`, from first to last.
+   *
+   * @complexity O(n)
+   */
+  template <typename R, typename Op> R reduce(R init, Op op) const {
+    for (size_t i = 0; i < size; ++i) {
+      init = op(std::move(init), data[i]);
+    }
+
+    return init;
+  }
+
+  /**
+   * Return `init` combined with `transformOp(x)` for every element, from
+   * first to last, as std::transform_reduce. `reduceOp` takes (R, R).
+   *
+   * @complexity O(n)
+   */
+  template <typename R, typename ReduceOp, typename TransformOp>
+  R transformReduce(R init, ReduceOp reduceOp, TransformOp transformOp) const {
+    for (size_t i = 0; i < size; ++i) {
+      init = reduceOp(std::move(init), static_cast<R>(transformOp(data[i])));
+    }
+
+    return init;
+  }
+
+  /**
+   * Call `fn(x)` on every element, in order.
+   *
+   * @complexity O(n)
+   */
+  template <typename Function> void forEach(Function fn) const {
+    for (size_t i = 0; i < size; ++i) {
+      fn(data[i]);
+    }
+  }
+
+  /**
+   * Return the operation counters of the Stats policy (all zero for
+   * NoStats).
+   *
+   * @complexity O(1)
+   */
+  const OperationCounts &stats() const { return Stats::stats(); }
+
+  /**
+   * Reset the operation counters.
+   *
+   * @complexity O(1)
+   */
+  void resetStats() { Stats::resetStats(); }
+
   // Begin iterator
   T *begin() { return data; }
 
@@ -199,3 +860,22 @@ public:
   // Const end iterator
   const T *end() const { return data + size; }
 };
+
+/**
+ * DynamicArray storing up to N elements inline before it allocates.
+ */
+template <typename T, size_t N, typename Stats = NoStats>
+using SmallDynamicArray = DynamicArray<T, Stats, N>;
+
+namespace pmr {
+
+/**
+ * DynamicArray allocating from a std::pmr::memory_resource.
+ */
+template <typename T, typename Stats = NoStats, size_t InlineCapacity = 0>
+using DynamicArray = ::DynamicArray<T, Stats, InlineCapacity,
+                                    std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
+
+#endif // DYNAMIC_ARRAY_CPP
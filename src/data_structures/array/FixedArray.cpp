@@ -0,0 +1,213 @@
+#ifndef FIXED_ARRAY_CPP
+#define FIXED_ARRAY_CPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "ArrayView.cpp"
+
+/**
+ * FixedArray
+ *
+ * DynamicArray with its capacity fixed at compile time: the elements live
+ * inside the object, so there is no allocation, no growth and no pointer
+ * to fix up when it is copied. Every operation is constexpr (in C++17), so
+ * a table filled by a constexpr function can be stored in a constexpr
+ * variable and lands in read-only data, ready to use with no
+ * initialization at startup.
+ *
+ * All Capacity slots are always constructed, so T must be default
+ * constructible (and a literal type for constant evaluation); past the
+ * size they hold default values. Operations that would exceed the
+ * capacity throw std::length_error, which during constant evaluation is a
+ * compile error.
+ */
+template <typename T, size_t Capacity> class FixedArray {
+private:
+  T data[Capacity > 0 ? Capacity : 1]{};
+  size_t size = 0;
+
+public:
+  /**
+   * Index returned by find when nothing matches.
+   */
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /**
+   * Empty array.
+   *
+   * @complexity O(1)
+   */
+  constexpr FixedArray() = default;
+
+  /**
+   * Constructor using an initializer list.
+   *
+   * @complexity O(n)
+   */
+  constexpr FixedArray(std::initializer_list<T> init) {
+    for (const T &value : init) {
+      push_back(value);
+    }
+  }
+
+  /**
+   * Return size.
+   *
+   * @complexity O(1)
+   */
+  constexpr size_t getSize() const { return size; }
+
+  /**
+   * Return Capacity.
+   *
+   * @complexity O(1)
+   */
+  static constexpr size_t getCapacity() { return Capacity; }
+
+  /**
+   * Whether the array has no elements.
+   *
+   * @complexity O(1)
+   */
+  constexpr bool isEmpty() const { return size == 0; }
+
+  /**
+   * Whether the array holds Capacity elements.
+   *
+   * @complexity O(1)
+   */
+  constexpr bool isFull() const { return size == Capacity; }
+
+  /**
+   * Access an element at a specific index.
+   *
+   * @complexity O(1)
+   */
+  constexpr const T &getAt(size_t index) const {
+    if (index >= size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    return data[index];
+  }
+
+  /**
+   * Set the element at a specific index.
+   *
+   * @complexity O(1)
+   */
+  constexpr void setAt(size_t index, const T &value) {
+    if (index >= size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    data[index] = value;
+  }
+
+  /**
+   * (Linear) Search for a value in the array.
+   *
+   * @complexity O(n)
+   * @return index of the first match or npos if not found.
+   */
+  constexpr size_t find(const T &value) const {
+    for (size_t i = 0; i < size; ++i) {
+      if (data[i] == value) {
+        return i;
+      }
+    }
+
+    return npos;
+  }
+
+  /**
+   * Add an element to the end of the array.
+   *
+   * @complexity O(1)
+   */
+  constexpr void push_back(const T &value) {
+    if (size == Capacity) {
+      throw std::length_error("FixedArray is full");
+    }
+
+    data[size++] = value;
+  }
+
+  constexpr void push_back(T &&value) {
+    if (size == Capacity) {
+      throw std::length_error("FixedArray is full");
+    }
+
+    data[size++] = std::move(value);
+  }
+
+  /**
+   * Insert an element at a specific index, shifting the rest right.
+   *
+   * @complexity O(n)
+   */
+  constexpr void insert(size_t index, const T &value) {
+    if (index > size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    if (size == Capacity) {
+      throw std::length_error("FixedArray is full");
+    }
+
+    for (size_t i = size; i > index; --i) {
+      data[i] = std::move(data[i - 1]);
+    }
+
+    data[index] = value;
+    ++size;
+  }
+
+  /**
+   * Remove the element at a specific index, shifting the rest left.
+   *
+   * @complexity O(n)
+   */
+  constexpr void remove(size_t index) {
+    if (index >= size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    for (size_t i = index; i + 1 < size; ++i) {
+      data[i] = std::move(data[i + 1]);
+    }
+
+    data[--size] = T();
+  }
+
+  /**
+   * Remove every element.
+   *
+   * @complexity O(n)
+   */
+  constexpr void clear() {
+    while (size > 0) {
+      data[--size] = T();
+    }
+  }
+
+  /**
+   * View of every element.
+   *
+   * @complexity O(1)
+   */
+  constexpr ArrayView<T> view() const { return ArrayView<T>(data, size); }
+
+  // Begin iterator
+  constexpr T *begin() { return data; }
+  constexpr const T *begin() const { return data; }
+
+  // End iterator
+  constexpr T *end() { return data + size; }
+  constexpr const T *end() const { return data + size; }
+};
+
+#endif // FIXED_ARRAY_CPP
@@ -0,0 +1,320 @@
+#ifndef FIXED_ORDERED_ARRAY_CPP
+#define FIXED_ORDERED_ARRAY_CPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "../../sortings/HeapSort.cpp"
+#include "ArrayView.cpp"
+
+/**
+ * FixedOrderedArray
+ *
+ * OrderedArray with its capacity fixed at compile time and the elements
+ * stored inside the object. Every operation is constexpr (in C++17), so a
+ * lookup table can be built and sorted during compilation:
+ *
+ *   constexpr FixedOrderedArray<int, 4> primes{7, 2, 5, 3};
+ *   static_assert(primes.contains(5));
+ *
+ * A constexpr table is stored in read-only data: lookups are plain binary
+ * searches with no initialization cost at startup and no heap.
+ *
+ * Bulk construction sorts with heapSort, which is constexpr in C++17 and
+ * keeps compile-time work at O(n log n). All Capacity slots are always
+ * constructed, so T must be default constructible (and a literal type for
+ * constant evaluation, as must `Compare`). Exceeding the capacity throws
+ * std::length_error, a compile error during constant evaluation.
+ *
+ * Lookups match elements equivalent to the key under `Compare`; a
+ * transparent comparator enables heterogeneous lookup, as in OrderedArray.
+ */
+template <typename T, size_t Capacity, typename Compare = std::less<T>>
+class FixedOrderedArray {
+private:
+  T data[Capacity > 0 ? Capacity : 1]{};
+  size_t size = 0;
+  Compare comp{};
+
+  /**
+   * Binary search for the first index whose element does not precede
+   * `value` (`upper` false) or that `value` precedes (`upper` true).
+   *
+   * @complexity O(log n)
+   */
+  template <typename K>
+  constexpr size_t bound(const K &value, bool upper) const {
+    size_t low = 0;
+    size_t high = size;
+
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      bool goesRight =
+          upper ? !comp(value, data[mid]) : comp(data[mid], value);
+
+      if (goesRight) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+
+    return low;
+  }
+
+  /**
+   * find for a key of any type the comparator accepts.
+   *
+   * @complexity O(log n)
+   */
+  template <typename K> constexpr size_t findKey(const K &value) const {
+    size_t index = bound(value, false);
+
+    return index < size && !comp(value, data[index]) ? index : npos;
+  }
+
+  /**
+   * Append a value without restoring the order.
+   *
+   * @complexity O(1)
+   */
+  constexpr void append(const T &value) {
+    if (size == Capacity) {
+      throw std::length_error("FixedOrderedArray is full");
+    }
+
+    data[size++] = value;
+  }
+
+public:
+  /**
+   * Index returned by find when nothing matches.
+   */
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /**
+   * Empty array.
+   *
+   * @complexity O(1)
+   */
+  constexpr FixedOrderedArray() = default;
+
+  /**
+   * Empty array ordered by `comp`.
+   *
+   * @complexity O(1)
+   */
+  explicit constexpr FixedOrderedArray(const Compare &comp) : comp(comp) {}
+
+  /**
+   * Constructor using an initializer list, in any order.
+   *
+   * @complexity O(n log n)
+   */
+  constexpr FixedOrderedArray(std::initializer_list<T> init,
+                              const Compare &comp = Compare())
+      : comp(comp) {
+    insertRange(init.begin(), init.end());
+  }
+
+  /**
+   * Return size.
+   *
+   * @complexity O(1)
+   */
+  constexpr size_t getSize() const { return size; }
+
+  /**
+   * Return Capacity.
+   *
+   * @complexity O(1)
+   */
+  static constexpr size_t getCapacity() { return Capacity; }
+
+  /**
+   * Whether the array has no elements.
+   *
+   * @complexity O(1)
+   */
+  constexpr bool isEmpty() const { return size == 0; }
+
+  /**
+   * Whether the array holds Capacity elements.
+   *
+   * @complexity O(1)
+   */
+  constexpr bool isFull() const { return size == Capacity; }
+
+  /**
+   * Return the comparator.
+   *
+   * @complexity O(1)
+   */
+  constexpr const Compare &getCompare() const { return comp; }
+
+  /**
+   * Access an element at a specific index.
+   *
+   * @complexity O(1)
+   */
+  constexpr const T &get(size_t index) const {
+    if (index >= size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    return data[index];
+  }
+
+  /**
+   * Binary search for `value`.
+   *
+   * @complexity O(log n)
+   * @return index of the first element equivalent to `value`, or npos if
+   * not found.
+   */
+  constexpr size_t find(const T &value) const { return findKey(value); }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  constexpr size_t find(const K &key) const {
+    return findKey(key);
+  }
+
+  /**
+   * Whether an element equivalent to `value` is present.
+   *
+   * @complexity O(log n)
+   */
+  constexpr bool contains(const T &value) const {
+    return findKey(value) != npos;
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  constexpr bool contains(const K &key) const {
+    return findKey(key) != npos;
+  }
+
+  /**
+   * Index of the first element that does not precede `value`, or getSize()
+   * if there is none.
+   *
+   * @complexity O(log n)
+   */
+  constexpr size_t lowerBound(const T &value) const {
+    return bound(value, false);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  constexpr size_t lowerBound(const K &key) const {
+    return bound(key, false);
+  }
+
+  /**
+   * Index of the first element that `value` precedes, or getSize() if
+   * there is none.
+   *
+   * @complexity O(log n)
+   */
+  constexpr size_t upperBound(const T &value) const {
+    return bound(value, true);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  constexpr size_t upperBound(const K &key) const {
+    return bound(key, true);
+  }
+
+  /**
+   * View of the elements from `from` (inclusive) up to `to` (exclusive) in
+   * the array's order.
+   *
+   * @complexity O(log n)
+   */
+  constexpr ArrayView<T> range(const T &from, const T &to) const {
+    size_t first = bound(from, false);
+    size_t last = bound(to, false);
+
+    return ArrayView<T>(data + first, last > first ? last - first : 0);
+  }
+
+  /**
+   * Insert an element while maintaining order; it goes after the elements
+   * equivalent to it.
+   *
+   * @complexity O(n)
+   */
+  constexpr void insert(const T &value) {
+    size_t index = bound(value, true);
+    append(value);
+
+    for (size_t i = size - 1; i > index; --i) {
+      data[i] = std::move(data[i - 1]);
+    }
+
+    data[index] = value;
+  }
+
+  /**
+   * Insert the elements of [first, last), in any order: they are appended
+   * and the whole array is sorted once.
+   *
+   * @complexity O((n + k) log(n + k))
+   */
+  template <typename InputIt>
+  constexpr void insertRange(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      append(*first);
+    }
+
+    heapSort(data, data + size, comp);
+  }
+
+  /**
+   * Remove the element at a specific index.
+   *
+   * @complexity O(n)
+   */
+  constexpr void remove(size_t index) {
+    if (index >= size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    for (size_t i = index; i + 1 < size; ++i) {
+      data[i] = std::move(data[i + 1]);
+    }
+
+    data[--size] = T();
+  }
+
+  /**
+   * Remove every element.
+   *
+   * @complexity O(n)
+   */
+  constexpr void clear() {
+    while (size > 0) {
+      data[--size] = T();
+    }
+  }
+
+  /**
+   * View of every element.
+   *
+   * @complexity O(1)
+   */
+  constexpr ArrayView<T> view() const { return ArrayView<T>(data, size); }
+
+  // Begin iterator
+  constexpr const T *begin() const { return data; }
+
+  // End iterator
+  constexpr const T *end() const { return data + size; }
+};
+
+#endif // FIXED_ORDERED_ARRAY_CPP
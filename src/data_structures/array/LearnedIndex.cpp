@@ -0,0 +1,381 @@
+#ifndef LEARNED_INDEX_CPP
+#define LEARNED_INDEX_CPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Maximum distance between the position a segment predicts for a stored
+// key and the key's actual position; the final search window spans about
+// twice this many elements.
+constexpr size_t learnedIndexEpsilon = 16;
+
+// Error bound of the segments indexing the segments of the level below.
+constexpr size_t learnedIndexLevelEpsilon = 4;
+
+// Levels are stacked until the top one has at most this many segments,
+// which are then binary searched.
+constexpr size_t learnedIndexRootSegments = 64;
+
+/**
+ * Whether LearnedIndex can index keys of type T ordered by Compare: the
+ * model maps arithmetic keys to positions, so the order must be the
+ * ascending numeric one.
+ */
+template <typename T, typename Compare>
+constexpr bool learnedIndexApplies =
+    std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+    (std::is_same<Compare, std::less<T>>::value ||
+     std::is_same<Compare, std::less<>>::value);
+
+/**
+ * `to - from` as a double, for `from <= to`. Integral differences are taken
+ * in the unsigned type first, so they are exact even where the signed
+ * subtraction would overflow.
+ */
+template <typename T> double learnedKeyDistance(const T &from, const T &to) {
+  if constexpr (std::is_floating_point<T>::value) {
+    return static_cast<double>(to) - static_cast<double>(from);
+  } else {
+    using Unsigned = std::make_unsigned_t<T>;
+
+    return static_cast<double>(static_cast<Unsigned>(
+        static_cast<Unsigned>(to) - static_cast<Unsigned>(from)));
+  }
+}
+
+/**
+ * LearnedIndex
+ *
+ * A piecewise-linear model of a sorted array of numeric keys, in the style
+ * of the PGM index: each segment stores its first key, the position of
+ * that key and a slope, and predicts the position of every distinct key it
+ * covers to within `epsilon`. A lookup finds the segment, evaluates the
+ * line and binary searches only the 2 * epsilon + 3 elements around the
+ * prediction, which is one or two cache lines of the array instead of the
+ * log2(n) scattered probes of a full binary search.
+ *
+ * Segments are cut greedily in one pass (the shrinking cone): starting at a
+ * key, the range of slopes that keeps every following key within epsilon
+ * narrows until it is empty, and the next segment starts at that key.
+ * Near-uniform keys such as timestamps or sequential IDs need a handful of
+ * segments; when there are many, the first keys of the segments are
+ * indexed the same way, level by level, until the top level has at most
+ * learnedIndexRootSegments.
+ *
+ * Each segment takes a key, a double and a size_t, so the index is a few
+ * percent of the array at most, and usually far less.
+ *
+ * Duplicates are modelled by their first position; a bound that falls
+ * outside the window, as after a long run of repeated keys, is found by
+ * galloping outward from it, so results are exact for any sorted input.
+ * NaN keys are not supported.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class LearnedIndex {
+private:
+  using AllocatorTraits = std::allocator_traits<Allocator>;
+  template <typename U>
+  using Rebind = typename AllocatorTraits::template rebind_alloc<U>;
+
+  // Segments of every level, lowest level first: level l occupies
+  // [levels[l], levels[l + 1]). keys holds the first key of each segment
+  // and starts its position in the level below (the array for level 0).
+  std::vector<T, Allocator> keys;
+  std::vector<double, Rebind<double>> slopes;
+  std::vector<size_t, Rebind<size_t>> starts;
+  std::vector<size_t, Rebind<size_t>> levels;
+  size_t epsilon = learnedIndexEpsilon;
+
+  /**
+   * Index of the first element of [low, high) that `goesRight` rejects, or
+   * `high`. Branchless: the window is small and probed in a fixed number
+   * of steps.
+   *
+   * @complexity O(log(high - low))
+   */
+  template <typename GoesRight>
+  static size_t searchRange(const T *data, size_t low, size_t high,
+                            GoesRight goesRight) {
+    if (low == high) {
+      return low;
+    }
+
+    const T *base = data + low;
+    size_t length = high - low;
+
+    while (length > 1) {
+      size_t half = length / 2;
+      base = goesRight(base[half]) ? base + half : base;
+      length -= half;
+    }
+
+    return static_cast<size_t>(base - data) + goesRight(*base);
+  }
+
+  /**
+   * Bound of `key` in `data[0, size)`, searched in the window of `slack`
+   * elements around `guess` and galloping outward if it lies beyond.
+   *
+   * @complexity O(log slack), O(log d) if the bound is d elements outside
+   */
+  template <typename GoesRight>
+  static size_t windowBound(const T *data, size_t size, size_t guess,
+                            size_t slack, GoesRight goesRight) {
+    size_t low = guess > slack + 1 ? guess - slack - 1 : 0;
+    size_t high = std::min(size, guess + slack + 2);
+    size_t result = searchRange(data, low, high, goesRight);
+
+    if (result == high && high < size) {
+      size_t step = 1;
+      low = high;
+
+      while (high < size && goesRight(data[high])) {
+        low = high + 1;
+        high = std::min(size, high + step);
+        step *= 2;
+      }
+
+      return searchRange(data, low, high, goesRight);
+    }
+
+    if (result == low && low > 0 && !goesRight(data[low - 1])) {
+      size_t step = 1;
+      high = low - 1;
+      low = high;
+
+      while (low > 0 && !goesRight(data[low - 1])) {
+        high = low - 1;
+        low -= std::min(low, step);
+        step *= 2;
+      }
+
+      return searchRange(data, low, high, goesRight);
+    }
+
+    return result;
+  }
+
+  /**
+   * Position that segment `segment` predicts for `key` in the level below,
+   * clamped to the part of it the segment covers. `levelEnd` ends the
+   * segment's level and `belowSize` is the size of the level below.
+   *
+   * @complexity O(1)
+   */
+  size_t predict(size_t segment, size_t levelEnd, const T &key,
+                 size_t belowSize) const {
+    size_t start = starts[segment];
+    size_t next = segment + 1 < levelEnd ? starts[segment + 1] : belowSize;
+
+    if (!(keys[segment] < key)) {
+      return start;
+    }
+
+    double offset = slopes[segment] * learnedKeyDistance(keys[segment], key);
+
+    return offset < static_cast<double>(next - start)
+               ? start + static_cast<size_t>(offset)
+               : next;
+  }
+
+  /**
+   * Append the segments covering the sorted keys `source[0, count)` with
+   * error bound `bound`. Repeated keys are fitted at their first position.
+   *
+   * @complexity O(count)
+   */
+  void appendLevel(const T *source, size_t count, size_t bound) {
+    double tolerance = static_cast<double>(bound);
+    size_t first = 0;
+
+    while (first < count) {
+      const T &origin = source[first];
+      double low = 0;
+      double high = std::numeric_limits<double>::infinity();
+      size_t next = first + 1;
+
+      for (; next < count; ++next) {
+        if (!(source[next - 1] < source[next])) {
+          continue;
+        }
+
+        double distance = learnedKeyDistance(origin, source[next]);
+        double rise = static_cast<double>(next - first);
+        double minSlope = (rise - tolerance) / distance;
+        double maxSlope = (rise + tolerance) / distance;
+
+        if (minSlope > high || maxSlope < low) {
+          break;
+        }
+
+        low = std::max(low, minSlope);
+        high = std::min(high, maxSlope);
+      }
+
+      keys.push_back(origin);
+      slopes.push_back(high == std::numeric_limits<double>::infinity()
+                           ? 0
+                           : (low + high) / 2);
+      starts.push_back(first);
+      first = next;
+    }
+  }
+
+public:
+  /**
+   * Empty index allocating from `allocator`.
+   *
+   * @complexity O(1)
+   */
+  explicit LearnedIndex(const Allocator &allocator = Allocator())
+      : keys(allocator), slopes(allocator), starts(allocator),
+        levels(allocator) {}
+
+  /**
+   * Copy of `other` allocating from `allocator`.
+   *
+   * @complexity O(s) for s segments
+   */
+  LearnedIndex(const LearnedIndex &other, const Allocator &allocator)
+      : keys(other.keys, allocator), slopes(other.slopes, allocator),
+        starts(other.starts, allocator), levels(other.levels, allocator),
+        epsilon(other.epsilon) {}
+
+  LearnedIndex(const LearnedIndex &) = default;
+  LearnedIndex(LearnedIndex &&) noexcept = default;
+  LearnedIndex &operator=(const LearnedIndex &) = default;
+  LearnedIndex &operator=(LearnedIndex &&) = default;
+
+  /**
+   * Build the model of `data[0, size)`, which must be sorted ascending,
+   * replacing any previous one.
+   *
+   * @complexity O(n)
+   */
+  void build(const T *data, size_t size, size_t errorBound) {
+    clear();
+    epsilon = errorBound;
+
+    if (size == 0) {
+      return;
+    }
+
+    levels.push_back(0);
+    appendLevel(data, size, epsilon);
+    levels.push_back(keys.size());
+
+    while (levels.back() - levels[levels.size() - 2] >
+           learnedIndexRootSegments) {
+      // Copied out, since appending may reallocate the keys being read.
+      std::vector<T> below(keys.begin() + levels[levels.size() - 2],
+                           keys.end());
+      appendLevel(below.data(), below.size(), learnedIndexLevelEpsilon);
+      levels.push_back(keys.size());
+    }
+  }
+
+  /**
+   * Index of the first element of `data[0, size)` that does not precede
+   * `key` (`upper` false) or that `key` precedes (`upper` true). `data`
+   * must be the array the index was built on; `less` compares its
+   * elements, so the caller can count those comparisons.
+   *
+   * @complexity O(levels * log epsilon), O(log n) at worst
+   */
+  template <typename Less>
+  size_t bound(const T *data, size_t size, const T &key, bool upper,
+               Less less) const {
+    size_t level = levels.size() - 2;
+    size_t begin = levels[level];
+    size_t end = levels[level + 1];
+    auto rootRight = [&key](const T &k) { return !(key < k); };
+    size_t segment = searchRange(keys.data(), begin, end, rootRight);
+    segment = segment > begin ? segment - 1 : begin;
+
+    for (; level > 0; --level) {
+      size_t below = levels[level - 1];
+      size_t guess = predict(segment, end, key, begin - below);
+      size_t found = windowBound(keys.data() + below, begin - below, guess,
+                                 learnedIndexLevelEpsilon, rootRight);
+      segment = below + (found > 0 ? found - 1 : 0);
+      end = begin;
+      begin = below;
+    }
+
+    size_t guess = predict(segment, end, key, size);
+
+    if (upper) {
+      return windowBound(data, size, guess, epsilon,
+                         [&](const T &e) { return !less(key, e); });
+    }
+
+    return windowBound(data, size, guess, epsilon,
+                       [&](const T &e) { return less(e, key); });
+  }
+
+  /**
+   * Whether no model is built.
+   *
+   * @complexity O(1)
+   */
+  bool isEmpty() const { return levels.empty(); }
+
+  /**
+   * Number of segments over all levels.
+   *
+   * @complexity O(1)
+   */
+  size_t getSegmentCount() const { return keys.size(); }
+
+  /**
+   * Number of levels, 1 when a single level indexes the array.
+   *
+   * @complexity O(1)
+   */
+  size_t getLevelCount() const {
+    return levels.empty() ? 0 : levels.size() - 1;
+  }
+
+  /**
+   * Bytes held by the segments.
+   *
+   * @complexity O(1)
+   */
+  size_t getMemoryBytes() const {
+    return keys.size() * (sizeof(T) + sizeof(double) + sizeof(size_t)) +
+           levels.size() * sizeof(size_t);
+  }
+
+  /**
+   * Drop the model and release its memory.
+   *
+   * @complexity O(1)
+   */
+  void clear() {
+    decltype(keys)(keys.get_allocator()).swap(keys);
+    decltype(slopes)(slopes.get_allocator()).swap(slopes);
+    decltype(starts)(starts.get_allocator()).swap(starts);
+    decltype(levels)(levels.get_allocator()).swap(levels);
+  }
+
+  /**
+   * Exchange two indices.
+   *
+   * @complexity O(1)
+   */
+  void swap(LearnedIndex &other) noexcept {
+    keys.swap(other.keys);
+    slopes.swap(other.slopes);
+    starts.swap(other.starts);
+    levels.swap(other.levels);
+    std::swap(epsilon, other.epsilon);
+  }
+};
+
+#endif // LEARNED_INDEX_CPP
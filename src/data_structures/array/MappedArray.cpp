@@ -0,0 +1,468 @@
+#ifndef MAPPED_ARRAY_CPP
+#define MAPPED_ARRAY_CPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ArrayView.cpp"
+#include "DynamicArray.cpp"
+#include "OrderedArray.cpp"
+#include "VectorizedSearch.cpp"
+
+constexpr char arrayFileMagic[8] = {'A', 'L', 'G', 'O', 'A', 'R', 'R', '\0'};
+// Version 2 stores the order of ordered files in the header.
+constexpr uint32_t arrayFileVersion = 2;
+// Written in host byte order; a file from a host of the other endianness
+// reads it back byte-swapped and is rejected.
+constexpr uint32_t arrayFileByteOrder = 0x01020304;
+
+// Flag bit set for files saved from an OrderedArray, whose header names
+// their order.
+constexpr uint32_t arrayFileOrdered = 1;
+
+// Order tags stored in the header. Tags from arrayFileFirstCustomOrder on
+// are left to comparators that callers register with ArrayFileOrder.
+constexpr uint32_t arrayFileNoOrder = 0;
+constexpr uint32_t arrayFileAscending = 1;
+constexpr uint32_t arrayFileDescending = 2;
+constexpr uint32_t arrayFileFirstCustomOrder = 256;
+
+/**
+ * Order tag recorded for arrays sorted by `Compare`, so that a mapped file
+ * is only searched with the order it was saved in. std::less and
+ * std::greater are tagged; for any other comparator, specialize this with
+ * a `value` of arrayFileFirstCustomOrder or more that is unique to it.
+ */
+template <typename Compare> struct ArrayFileOrder {};
+
+template <typename T> struct ArrayFileOrder<std::less<T>> {
+  static constexpr uint32_t value = arrayFileAscending;
+};
+
+template <typename T> struct ArrayFileOrder<std::greater<T>> {
+  static constexpr uint32_t value = arrayFileDescending;
+};
+
+/**
+ * Whether ArrayFileOrder has a tag for `Compare`.
+ */
+template <typename Compare, typename = void>
+constexpr bool hasArrayFileOrder = false;
+
+template <typename Compare>
+constexpr bool hasArrayFileOrder<
+    Compare, std::void_t<decltype(ArrayFileOrder<Compare>::value)>> = true;
+
+/**
+ * Header of the flat array file format, followed directly by `count` raw
+ * elements. It is 64 bytes long, so the elements start at an offset aligned
+ * for any T whose alignment is at most 64.
+ */
+struct ArrayFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t elementSize;
+  uint64_t elementAlignment;
+  uint64_t count;
+  uint32_t flags;
+  uint32_t order;
+  uint8_t padding[16];
+};
+
+static_assert(sizeof(ArrayFileHeader) == 64, "ArrayFileHeader must be 64 B");
+
+/**
+ * Move the finished file `temporary` over `path` durably: the file is
+ * flushed to disk before the rename and its directory after it, so a crash
+ * leaves either the old file or the complete new one. The temporary file
+ * is removed if it cannot be synced or renamed.
+ *
+ * @complexity O(1), plus the time to write back the file
+ */
+inline void replaceArrayFile(const std::string &temporary,
+                             const std::string &path) {
+  int fd = open(temporary.c_str(), O_RDONLY);
+  bool synced = fd >= 0 && fsync(fd) == 0;
+
+  if (fd >= 0) {
+    close(fd);
+  }
+
+  if (!synced) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("Cannot sync " + temporary);
+  }
+
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("Cannot rename " + temporary + " to " + path);
+  }
+
+  size_t slash = path.find_last_of('/');
+  std::string directory = slash == std::string::npos ? "."
+                          : slash == 0               ? "/"
+                                                     : path.substr(0, slash);
+  int directoryFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  synced = directoryFd >= 0 && fsync(directoryFd) == 0;
+
+  if (directoryFd >= 0) {
+    close(directoryFd);
+  }
+
+  if (!synced) {
+    throw std::runtime_error("Cannot sync " + directory);
+  }
+}
+
+/**
+ * Write `count` elements to `path` in the flat array format, with the
+ * order tag `order` (arrayFileNoOrder unless `flags` has arrayFileOrdered).
+ * The file is
+ * written next to its destination and renamed over it (see
+ * replaceArrayFile), so readers never see a partial file.
+ *
+ * @complexity O(n)
+ */
+template <typename T>
+void saveArrayFile(const std::string &path, const T *data, size_t count,
+                   uint32_t flags, uint32_t order = arrayFileNoOrder) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable types can be saved as raw bytes");
+  static_assert(alignof(T) <= sizeof(ArrayFileHeader),
+                "Element alignment exceeds the header size");
+
+  ArrayFileHeader header{};
+  std::memcpy(header.magic, arrayFileMagic, sizeof(header.magic));
+  header.version = arrayFileVersion;
+  header.byteOrder = arrayFileByteOrder;
+  header.elementSize = sizeof(T);
+  header.elementAlignment = alignof(T);
+  header.count = count;
+  header.flags = flags;
+  header.order = order;
+
+  std::string temporary = path + ".tmp";
+
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(data), count * sizeof(T));
+
+    if (!out.flush()) {
+      std::remove(temporary.c_str());
+      throw std::runtime_error("Cannot write " + temporary);
+    }
+  }
+
+  replaceArrayFile(temporary, path);
+}
+
+/**
+ * Save the elements of a DynamicArray in the flat array format.
+ *
+ * @complexity O(n)
+ */
+template <typename T, typename Stats, size_t InlineCapacity,
+          typename Allocator>
+void saveArray(const std::string &path,
+               const DynamicArray<T, Stats, InlineCapacity, Allocator> &array) {
+  saveArrayFile(path, array.begin(), array.getSize(), 0);
+}
+
+/**
+ * Save the live elements of an OrderedArray in the flat array format,
+ * marked as ordered and tagged with its order so that the mapped view can
+ * binary search it. Tombstoned slots are left out.
+ *
+ * @complexity O(n)
+ */
+template <typename T, typename Compare, typename Stats, typename Allocator>
+void saveArray(const std::string &path,
+               const OrderedArray<T, Compare, Stats, Allocator> &array) {
+  static_assert(hasArrayFileOrder<Compare>,
+                "Specialize ArrayFileOrder to give this comparator a tag");
+  constexpr uint32_t order = ArrayFileOrder<Compare>::value;
+
+  if (array.getRemovedCount() == 0) {
+    ArrayView<T> all = array.view();
+    saveArrayFile(path, all.begin(), all.getSize(), arrayFileOrdered, order);
+    return;
+  }
+
+  std::vector<T> live;
+  live.reserve(array.getSize());
+  array.forEach([&live](const T &value) { live.push_back(value); });
+  saveArrayFile(path, live.data(), live.size(), arrayFileOrdered, order);
+}
+
+/**
+ * MappedArray
+ *
+ * Read-only, zero-copy view of an array file mapped with mmap. Opening
+ * validates the header and maps the file; nothing is deserialized, so the
+ * cost is independent of the element count and pages are loaded on first
+ * touch (and shared between processes mapping the same file).
+ *
+ * `find` binary searches files saved from an OrderedArray with `Compare`,
+ * and scans the others. An ordered file saved with another order (its
+ * ArrayFileOrder tag differs from that of `Compare`) is rejected on
+ * opening. Copy-on-write is explicit: copyTo() materializes the elements
+ * into an owned DynamicArray or OrderedArray that can then be modified,
+ * while the mapping stays untouched.
+ */
+template <typename T, typename Compare = std::less<T>> class MappedArray {
+private:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable types can be mapped");
+  static_assert(hasArrayFileOrder<Compare>,
+                "Specialize ArrayFileOrder to give this comparator a tag");
+
+  void *mapping = nullptr;
+  size_t mappedBytes = 0;
+  const T *data = nullptr;
+  size_t size = 0;
+  uint32_t flags = 0;
+
+  /**
+   * Release the mapping, if any.
+   *
+   * @complexity O(1)
+   */
+  void unmap() {
+    if (mapping != nullptr) {
+      munmap(mapping, mappedBytes);
+      mapping = nullptr;
+    }
+  }
+
+  /**
+   * Check that the header describes a file of this format, version and
+   * element type whose elements fit in `fileBytes`, and that an ordered
+   * file is sorted by `Compare`.
+   *
+   * @complexity O(1)
+   */
+  static void validate(const ArrayFileHeader &header, size_t fileBytes,
+                       const std::string &path) {
+    if (std::memcmp(header.magic, arrayFileMagic, sizeof(header.magic)) != 0) {
+      throw std::runtime_error(path + " is not an array file");
+    }
+
+    if (header.byteOrder != arrayFileByteOrder) {
+      throw std::runtime_error(path + " was written with another byte order");
+    }
+
+    if (header.version != arrayFileVersion) {
+      throw std::runtime_error(path + " has unsupported version " +
+                               std::to_string(header.version));
+    }
+
+    if (header.elementSize != sizeof(T) ||
+        header.elementAlignment != alignof(T)) {
+      throw std::runtime_error(path + " holds elements of another type");
+    }
+
+    if (header.count > (fileBytes - sizeof(header)) / sizeof(T)) {
+      throw std::runtime_error(path + " is truncated");
+    }
+
+    if ((header.flags & arrayFileOrdered) != 0 &&
+        header.order != ArrayFileOrder<Compare>::value) {
+      throw std::runtime_error(path + " is sorted in another order");
+    }
+  }
+
+public:
+  /**
+   * Index returned by find when nothing matches.
+   */
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /**
+   * Map the array file at `path`.
+   *
+   * @complexity O(1)
+   */
+  explicit MappedArray(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+      throw std::runtime_error("Cannot open " + path);
+    }
+
+    struct stat status;
+
+    if (fstat(fd, &status) != 0 ||
+        static_cast<size_t>(status.st_size) < sizeof(ArrayFileHeader)) {
+      close(fd);
+      throw std::runtime_error(path + " is not an array file");
+    }
+
+    mappedBytes = static_cast<size_t>(status.st_size);
+    mapping = mmap(nullptr, mappedBytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+      mapping = nullptr;
+      throw std::runtime_error("Cannot map " + path);
+    }
+
+    ArrayFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+
+    try {
+      validate(header, mappedBytes, path);
+    } catch (...) {
+      unmap();
+      throw;
+    }
+
+    data = reinterpret_cast<const T *>(static_cast<const char *>(mapping) +
+                                       sizeof(header));
+    size = header.count;
+    flags = header.flags;
+  }
+
+  MappedArray(const MappedArray &) = delete;
+  MappedArray &operator=(const MappedArray &) = delete;
+
+  /**
+   * Take over the mapping of `other`, leaving it empty.
+   *
+   * @complexity O(1)
+   */
+  MappedArray(MappedArray &&other) noexcept
+      : mapping(std::exchange(other.mapping, nullptr)),
+        mappedBytes(std::exchange(other.mappedBytes, 0)),
+        data(std::exchange(other.data, nullptr)),
+        size(std::exchange(other.size, 0)),
+        flags(std::exchange(other.flags, 0)) {}
+
+  MappedArray &operator=(MappedArray &&other) noexcept {
+    if (this != &other) {
+      unmap();
+      mapping = std::exchange(other.mapping, nullptr);
+      mappedBytes = std::exchange(other.mappedBytes, 0);
+      data = std::exchange(other.data, nullptr);
+      size = std::exchange(other.size, 0);
+      flags = std::exchange(other.flags, 0);
+    }
+
+    return *this;
+  }
+
+  /**
+   * Unmap the file.
+   *
+   * @complexity O(1)
+   */
+  ~MappedArray() { unmap(); }
+
+  /**
+   * Return size.
+   *
+   * @complexity O(1)
+   */
+  size_t getSize() const { return size; }
+
+  /**
+   * Whether the file was saved from an OrderedArray.
+   *
+   * @complexity O(1)
+   */
+  bool isOrdered() const { return (flags & arrayFileOrdered) != 0; }
+
+  /**
+   * Flag bits of the file header, such as arrayFileOrdered.
+   *
+   * @complexity O(1)
+   */
+  uint32_t getFlags() const { return flags; }
+
+  /**
+   * Access an element at a specific index.
+   *
+   * @complexity O(1)
+   */
+  const T &get(size_t index) const {
+    if (index >= size) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    return data[index];
+  }
+
+  /**
+   * Find the first element equal to `value`: binary search (for an
+   * equivalent element) in ordered files, a vectorized scan otherwise.
+   *
+   * @complexity O(log n) if ordered, O(n) otherwise
+   * @return index of the first match, or npos if not found.
+   */
+  size_t find(const T &value) const {
+    if (!isOrdered()) {
+      size_t index = vectorizedFind(data, size, value);
+      return index < size ? index : npos;
+    }
+
+    Compare comp;
+    const T *match = std::lower_bound(data, data + size, value, comp);
+
+    return match != data + size && !comp(value, *match) ? match - data : npos;
+  }
+
+  /**
+   * View of every element, valid while the mapping lives.
+   *
+   * @complexity O(1)
+   */
+  ArrayView<T> view() const { return ArrayView<T>(data, size); }
+
+  /**
+   * Append the elements to an owned DynamicArray.
+   *
+   * @complexity O(n)
+   */
+  template <typename Stats, size_t InlineCapacity, typename Allocator>
+  void copyTo(DynamicArray<T, Stats, InlineCapacity, Allocator> &array) const {
+    array.reserve(array.getSize() + size);
+
+    for (size_t i = 0; i < size; ++i) {
+      array.push_back(data[i]);
+    }
+  }
+
+  /**
+   * Insert the elements into an owned OrderedArray. An empty target with
+   * the file's order takes them with a single sorted-batch merge.
+   *
+   * @complexity O(n + k) if the orders match, O(n + k log k) otherwise
+   */
+  template <typename OtherCompare, typename Stats, typename Allocator>
+  void copyTo(OrderedArray<T, OtherCompare, Stats, Allocator> &array) const {
+    array.insertMany(data, size);
+  }
+
+  // Begin iterator
+  const T *begin() const { return data; }
+
+  // End iterator
+  const T *end() const { return data + size; }
+};
+
+#endif // MAPPED_ARRAY_CPP
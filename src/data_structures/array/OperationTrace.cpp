@@ -0,0 +1,541 @@
+#ifndef OPERATION_TRACE_CPP
+#define OPERATION_TRACE_CPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../sortings/Selection.cpp"
+#include "ArrayView.cpp"
+#include "MappedArray.cpp"
+
+// Flag bit set in the header of array files holding TraceEvents; see
+// arrayFileOrdered for the other bit.
+constexpr uint32_t arrayFileTrace = 2;
+
+// TraceWriter appends events in batches of this many.
+constexpr size_t traceWriterBuffer = 4096;
+
+/**
+ * Operations a TracedArray records. `Begin` is always the first event of a
+ * trace and describes its key type (see traceKeyType).
+ */
+enum class TraceOp : uint8_t {
+  Begin,
+  Insert,
+  Find,
+  LowerBound,
+  Remove,
+  PushBack,
+  InsertAt,
+  GetAt,
+  SetAt,
+};
+
+/**
+ * One recorded operation, 24 bytes. `key` holds the bits of the key or
+ * value argument, zero-extended; `index` the position argument, if any.
+ */
+struct TraceEvent {
+  uint64_t timestamp; // Nanoseconds since the trace started
+  uint64_t key;
+  uint32_t index;
+  TraceOp op;
+  uint8_t padding[3];
+};
+
+static_assert(sizeof(TraceEvent) == 24, "TraceEvent must be 24 bytes");
+
+/**
+ * Name of an operation, as in the TracedArray call.
+ *
+ * @complexity O(1)
+ */
+inline const char *traceOpName(TraceOp op) {
+  switch (op) {
+  case TraceOp::Begin:
+    return "begin";
+  case TraceOp::Insert:
+    return "insert";
+  case TraceOp::Find:
+    return "find";
+  case TraceOp::LowerBound:
+    return "lowerBound";
+  case TraceOp::Remove:
+    return "remove";
+  case TraceOp::PushBack:
+    return "push_back";
+  case TraceOp::InsertAt:
+    return "insert at";
+  case TraceOp::GetAt:
+    return "get";
+  case TraceOp::SetAt:
+    return "setAt";
+  }
+
+  return "unknown";
+}
+
+/**
+ * Kinds of key a trace can hold.
+ */
+enum class TraceKeyKind : uint8_t { Unsigned = 1, Signed, Floating };
+
+/**
+ * Key type descriptor stored in the Begin event: the kind in the second
+ * byte, the size in bytes in the first.
+ */
+template <typename T> constexpr uint64_t traceKeyType() {
+  static_assert(std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64_t),
+                "Only arithmetic keys of up to 8 bytes can be traced");
+
+  TraceKeyKind kind = std::is_floating_point<T>::value ? TraceKeyKind::Floating
+                      : std::is_signed<T>::value       ? TraceKeyKind::Signed
+                                                       : TraceKeyKind::Unsigned;
+
+  return static_cast<uint64_t>(kind) << 8 | sizeof(T);
+}
+
+/**
+ * Bits of a key for TraceEvent::key.
+ *
+ * @complexity O(1)
+ */
+template <typename T> uint64_t traceKeyBits(const T &key) {
+  uint64_t bits = 0;
+  std::memcpy(&bits, &key, sizeof(T));
+
+  return bits;
+}
+
+/**
+ * Key of type T stored in TraceEvent::key.
+ *
+ * @complexity O(1)
+ */
+template <typename T> T traceKey(const TraceEvent &event) {
+  T key;
+  std::memcpy(&key, &event.key, sizeof(T));
+
+  return key;
+}
+
+/**
+ * TraceWriter
+ *
+ * Appends TraceEvents to a trace file, an array file (see MappedArray.cpp)
+ * of events that can be mapped back with MappedArray<TraceEvent>. Events
+ * are buffered and written in batches; the file is written next to its
+ * destination and renamed over it by finish(), so a reader never sees a
+ * partial trace.
+ *
+ * Timestamps are taken from std::chrono::steady_clock, relative to the
+ * construction of the writer.
+ */
+class TraceWriter {
+private:
+  std::string path;
+  std::string temporary;
+  std::ofstream out;
+  std::vector<TraceEvent> buffer;
+  std::chrono::steady_clock::time_point start;
+  uint64_t keyType;
+  uint64_t count = 0;
+  bool finished = false;
+
+  void flushBuffer() {
+    out.write(reinterpret_cast<const char *>(buffer.data()),
+              buffer.size() * sizeof(TraceEvent));
+    count += buffer.size();
+    buffer.clear();
+
+    if (!out) {
+      throw std::runtime_error("Cannot write " + temporary);
+    }
+  }
+
+public:
+  /**
+   * Start a trace at `path` for keys described by `keyType`, as returned
+   * by traceKeyType.
+   *
+   * @complexity O(1)
+   */
+  TraceWriter(const std::string &path, uint64_t keyType)
+      : path(path), temporary(path + ".tmp"),
+        out(temporary, std::ios::binary | std::ios::trunc),
+        start(std::chrono::steady_clock::now()), keyType(keyType) {
+    if (!out) {
+      throw std::runtime_error("Cannot create " + temporary);
+    }
+
+    ArrayFileHeader header{};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    buffer.reserve(traceWriterBuffer);
+    record(TraceOp::Begin, keyType, 0);
+  }
+
+  TraceWriter(const TraceWriter &) = delete;
+  TraceWriter &operator=(const TraceWriter &) = delete;
+
+  /**
+   * Finish the trace if finish() was not called; errors are dropped, and
+   * the partial file removed.
+   *
+   * @complexity O(b) for b buffered events
+   */
+  ~TraceWriter() {
+    if (!finished) {
+      try {
+        finish();
+      } catch (...) {
+        std::remove(temporary.c_str());
+      }
+    }
+  }
+
+  /**
+   * Return the key type descriptor the trace was started with.
+   *
+   * @complexity O(1)
+   */
+  uint64_t getKeyType() const { return keyType; }
+
+  /**
+   * Return the number of events recorded so far, including Begin.
+   *
+   * @complexity O(1)
+   */
+  uint64_t getCount() const { return count + buffer.size(); }
+
+  /**
+   * Throw if an event with index `index` could not be recorded: the trace
+   * is finished or the index does not fit in 32 bits.
+   *
+   * @complexity O(1)
+   */
+  void checkRecordable(size_t index) const {
+    if (finished) {
+      throw std::runtime_error("Trace is already finished");
+    }
+
+    if (index > UINT32_MAX) {
+      throw std::out_of_range("Traced index exceeds 32 bits");
+    }
+  }
+
+  /**
+   * Append an event stamped with the current time.
+   *
+   * @complexity O(1) (Amortized)
+   */
+  void record(TraceOp op, uint64_t key, size_t index) {
+    checkRecordable(index);
+
+    TraceEvent event{};
+    event.timestamp = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+    event.key = key;
+    event.index = static_cast<uint32_t>(index);
+    event.op = op;
+    buffer.push_back(event);
+
+    if (buffer.size() == traceWriterBuffer) {
+      flushBuffer();
+    }
+  }
+
+  /**
+   * Write the remaining events and the header, and move the trace to its
+   * path with replaceArrayFile.
+   *
+   * @complexity O(b) for b buffered events
+   */
+  void finish() {
+    if (finished) {
+      return;
+    }
+
+    finished = true;
+    flushBuffer();
+
+    ArrayFileHeader header{};
+    std::memcpy(header.magic, arrayFileMagic, sizeof(header.magic));
+    header.version = arrayFileVersion;
+    header.byteOrder = arrayFileByteOrder;
+    header.elementSize = sizeof(TraceEvent);
+    header.elementAlignment = alignof(TraceEvent);
+    header.count = count;
+    header.flags = arrayFileTrace;
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.close();
+
+    if (!out) {
+      std::remove(temporary.c_str());
+      throw std::runtime_error("Cannot write " + temporary);
+    }
+
+    replaceArrayFile(temporary, path);
+  }
+};
+
+/**
+ * Whether `Container` has push_back, so that TracedArray records its
+ * starting elements as PushBack rather than Insert events.
+ */
+template <typename Container, typename T, typename = void>
+constexpr bool traceAppends = false;
+
+template <typename Container, typename T>
+constexpr bool traceAppends<
+    Container, T,
+    std::void_t<decltype(std::declval<Container &>().push_back(
+        std::declval<const T &>()))>> = true;
+
+/**
+ * TracedArray
+ *
+ * Opt-in wrapper recording every operation on `Container` to a
+ * TraceWriter: it forwards the DynamicArray calls (push_back, insert at an
+ * index, getAt, setAt) and the OrderedArray ones (insert, find,
+ * lowerBound, get), and both kinds of remove. Only the calls the wrapped
+ * container has are usable.
+ *
+ * A trace replays from empty containers: the elements the container is
+ * constructed with are recorded first, as PushBack events in order for
+ * containers with push_back and as Insert events otherwise. An event is
+ * recorded once its call returns, so a call that throws leaves none.
+ *
+ * Each call costs a clock read and a 24-byte append on top of the
+ * operation itself. Elements must be arithmetic and at most 8 bytes.
+ */
+template <typename Container> class TracedArray {
+private:
+  using T = std::decay_t<decltype(*std::declval<const Container &>().begin())>;
+
+  Container container;
+  TraceWriter &writer;
+
+  /**
+   * Run `call` and record the event once it returns. The index is checked
+   * first, so an event the trace cannot hold fails before the container
+   * changes.
+   *
+   * @complexity O(1) plus `call`
+   */
+  template <typename Call>
+  decltype(auto) traced(TraceOp op, uint64_t key, size_t index,
+                        Call call) const {
+    writer.checkRecordable(index);
+
+    if constexpr (std::is_void<decltype(call())>::value) {
+      call();
+      writer.record(op, key, index);
+    } else {
+      decltype(auto) result = call();
+      writer.record(op, key, index);
+      return result;
+    }
+  }
+
+public:
+  /**
+   * Wrap a container built from `args`, recording to `writer`, which must
+   * have been started with traceKeyType<T>(). The container's starting
+   * elements are recorded first.
+   *
+   * @complexity Same as the wrapped constructor, plus O(n)
+   */
+  template <typename... Args>
+  explicit TracedArray(TraceWriter &writer, Args &&...args)
+      : container(std::forward<Args>(args)...), writer(writer) {
+    if (writer.getKeyType() != traceKeyType<T>()) {
+      throw std::invalid_argument("Trace was started for another key type");
+    }
+
+    TraceOp op = traceAppends<Container, T> ? TraceOp::PushBack
+                                            : TraceOp::Insert;
+
+    for (const T &value : container) {
+      writer.record(op, traceKeyBits(value), 0);
+    }
+  }
+
+  /**
+   * The wrapped container, for calls that are not traced.
+   *
+   * @complexity O(1)
+   */
+  const Container &getContainer() const { return container; }
+
+  /**
+   * Return size.
+   *
+   * @complexity O(1)
+   */
+  size_t getSize() const { return container.getSize(); }
+
+  // Ordered containers: insert by value, binary searches, get.
+
+  void insert(const T &value) {
+    traced(TraceOp::Insert, traceKeyBits(value), 0,
+           [&] { container.insert(value); });
+  }
+
+  size_t find(const T &value) const {
+    return traced(TraceOp::Find, traceKeyBits(value), 0,
+                  [&] { return container.find(value); });
+  }
+
+  size_t lowerBound(const T &value) const {
+    return traced(TraceOp::LowerBound, traceKeyBits(value), 0,
+                  [&] { return container.lowerBound(value); });
+  }
+
+  const T &get(size_t index) const {
+    return traced(TraceOp::GetAt, 0, index,
+                  [&]() -> const T & { return container.get(index); });
+  }
+
+  // DynamicArray: positional access.
+
+  void push_back(const T &value) {
+    traced(TraceOp::PushBack, traceKeyBits(value), 0,
+           [&] { container.push_back(value); });
+  }
+
+  void insert(size_t index, const T &value) {
+    traced(TraceOp::InsertAt, traceKeyBits(value), index,
+           [&] { container.insert(index, value); });
+  }
+
+  const T &getAt(size_t index) const {
+    return traced(TraceOp::GetAt, 0, index,
+                  [&]() -> const T & { return container.getAt(index); });
+  }
+
+  void setAt(size_t index, const T &value) {
+    traced(TraceOp::SetAt, traceKeyBits(value), index,
+           [&] { container.setAt(index, value); });
+  }
+
+  // Both.
+
+  void remove(size_t index) {
+    traced(TraceOp::Remove, 0, index, [&] { container.remove(index); });
+  }
+};
+
+/**
+ * Outcome of replaying a trace: the time for the whole run, latency
+ * percentiles of single operations, and a checksum of every result (found
+ * indices and read values) so that runs on different containers can be
+ * checked for agreement.
+ */
+struct ReplayResult {
+  size_t operations = 0;
+  double seconds = 0;
+  uint64_t checksum = 0;
+  uint64_t p50 = 0; // Nanoseconds, as are the other percentiles
+  uint64_t p90 = 0;
+  uint64_t p99 = 0;
+  uint64_t p999 = 0;
+  uint64_t max = 0;
+};
+
+/**
+ * Value at quantile `q` of `samples`, which is reordered.
+ *
+ * @complexity O(n)
+ */
+inline uint64_t replayPercentile(std::vector<uint64_t> &samples, double q) {
+  if (samples.empty()) {
+    return 0;
+  }
+
+  size_t rank = static_cast<size_t>(q * static_cast<double>(samples.size()));
+  auto nth = samples.begin() + std::min(rank, samples.size() - 1);
+  nthElement(samples.begin(), nth, samples.end());
+
+  return *nth;
+}
+
+/**
+ * Replay `events` (without their Begin event) through `apply`, which
+ * performs one event on the container under test and returns its result
+ * (0 for mutations). Each `makeContainer()` call returns a fresh
+ * container.
+ *
+ * The trace runs twice on fresh containers: once untimed per operation for
+ * the throughput, and once timing every operation for the percentiles, so
+ * that the clock reads do not count against the throughput.
+ *
+ * @complexity O(n) operations
+ */
+template <typename MakeContainer, typename Apply>
+ReplayResult replayTrace(ArrayView<TraceEvent> events,
+                         MakeContainer makeContainer, Apply apply) {
+  using Clock = std::chrono::steady_clock;
+
+  ReplayResult result;
+  result.operations = events.getSize();
+
+  {
+    auto container = makeContainer();
+    uint64_t checksum = 0;
+    Clock::time_point begin = Clock::now();
+
+    for (const TraceEvent &event : events) {
+      checksum = checksum * 31 + apply(container, event);
+    }
+
+    result.seconds =
+        std::chrono::duration<double>(Clock::now() - begin).count();
+    result.checksum = checksum;
+  }
+
+  std::vector<uint64_t> latencies;
+  latencies.reserve(events.getSize());
+
+  {
+    auto container = makeContainer();
+    uint64_t checksum = 0;
+
+    for (const TraceEvent &event : events) {
+      Clock::time_point begin = Clock::now();
+      checksum = checksum * 31 + apply(container, event);
+      latencies.push_back(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                               begin)
+              .count()));
+    }
+
+    if (checksum != result.checksum) {
+      throw std::runtime_error("Replay is not deterministic");
+    }
+  }
+
+  result.p50 = replayPercentile(latencies, 0.5);
+  result.p90 = replayPercentile(latencies, 0.9);
+  result.p99 = replayPercentile(latencies, 0.99);
+  result.p999 = replayPercentile(latencies, 0.999);
+  result.max = latencies.empty()
+                   ? 0
+                   : *std::max_element(latencies.begin(), latencies.end());
+
+  return result;
+}
+
+#endif // OPERATION_TRACE_CPP
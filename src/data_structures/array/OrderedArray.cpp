@@ -1,5 +1,23 @@
+#ifndef ORDERED_ARRAY_CPP
+#define ORDERED_ARRAY_CPP
+
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../utils/BitScan.cpp"
+#include "../../utils/OperationStats.cpp"
+#include "ArrayView.cpp"
+#include "LearnedIndex.cpp"
 
 /**
  * OrderedArray
@@ -9,7 +27,8 @@
  * Differences from a regular array:
  *
  * 1. **Sorted State**:
- *    - OrderedArray: Maintains a sorted order (ascending or descending).
+ *    - OrderedArray: Maintains the order of `Compare` (std::less by default,
+ * std::greater for descending).
  *    - Regular Array: No guaranteed order; elements can be in any sequence.
  *
  * 2. **Search Efficiency**:
@@ -23,13 +42,101 @@
  *    - Regular Array: Simple appending is O(1) if space is available, but can
  * be O(n) if resizing is needed.
  *
+ * Storage is allocated uninitialized through std::allocator_traits, so only
+ * the first `size` slots hold live objects. Growing never default-constructs
+ * the new buffer and T does not need to be default-constructible.
+ *
+ * For read-mostly use, freeze() builds a search copy in Eytzinger (BFS)
+ * order. Its hot top levels share a few cache lines and the search descends
+ * branchlessly with prefetching, so `find` is much faster than binary search
+ * once the array outgrows the caches. Any mutation drops the frozen copy.
+ *
+ * For numeric keys in ascending order, freezeLearned() instead fits a
+ * piecewise-linear model of the keys (see LearnedIndex.cpp) that predicts
+ * where a key sits to within a few elements. It adds a few percent of
+ * memory rather than a second copy, and on near-uniform keys such as
+ * timestamps a lookup touches one or two cache lines of the array.
+ *
+ * The ordering is the `Compare` template parameter, so it is inlined into
+ * every search loop. A transparent comparator (one declaring
+ * `is_transparent`) enables heterogeneous lookup: records ordered by a key
+ * field can be searched by the key alone, without building a temporary T.
+ * Lookups match elements equivalent to the key under `Compare`.
+ *
+ * The `Stats` policy counts comparisons, shifted elements and reallocations.
+ * The default NoStats compiles away; CountingStats exposes them via stats().
+ *
+ * The element buffer, the frozen layout and the tombstone bitmap all come
+ * from `Allocator`; pmr::OrderedArray<T> takes a std::pmr::memory_resource.
+ *
+ * With enableTombstones(), `remove` only marks the slot in a bitmap and the
+ * frozen layout survives. Marked slots are invisible: getSize() counts the
+ * live elements, indices (of `get`, `find`, the bounds and `remove`) are
+ * positions among them, and iteration skips the marked slots. A count of
+ * marks per 512 slots converts between indices and slots in O(log n). The
+ * marks are compacted away in one pass once they exceed a fraction of the
+ * array, before the next insertion, or on an explicit compact().
+ *
  */
-template <typename T> class OrderedArray {
+template <typename T, typename Compare = std::less<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
+class OrderedArray : private Stats {
 private:
+  static_assert(std::is_same<typename Allocator::value_type, T>::value,
+                "Allocator::value_type must be T");
+
+  using AllocatorTraits = std::allocator_traits<Allocator>;
+  template <typename U>
+  using Rebind = typename AllocatorTraits::template rebind_alloc<U>;
+
+  Allocator allocator;
   T *data;
   size_t size;
   size_t capacity;
-  bool isAscending;
+  Compare comp;
+  std::vector<T, Allocator> eytzinger;
+  std::vector<size_t, Rebind<size_t>> eytzingerRank;
+  LearnedIndex<T, Allocator> learned;
+  bool useTombstones = false;
+  double tombstoneThreshold = 0.25;
+  std::vector<uint64_t, Rebind<uint64_t>> tombstones;
+  // Tombstoned slots before each group of tombstoneGroupWords bitmap words.
+  std::vector<size_t, Rebind<size_t>> removedBefore;
+  size_t removedCount = 0;
+
+  static constexpr size_t tombstoneGroupWords = 8;
+  static constexpr size_t tombstoneGroupSlots = 64 * tombstoneGroupWords;
+
+  /**
+   * Move `count` live elements from `from` into the uninitialized buffer `to`
+   * and end their lifetime in `from`. Trivially copyable types are relocated
+   * with a single memcpy.
+   *
+   * @complexity O(n)
+   */
+  static void relocate(T *from, size_t count, T *to) {
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      if (count > 0) {
+        std::memcpy(static_cast<void *>(to), from, count * sizeof(T));
+      }
+    } else {
+      std::uninitialized_move(from, from + count, to);
+      std::destroy(from, from + count);
+    }
+  }
+
+  /**
+   * Free the buffer of an empty array. Moved-from arrays have none.
+   *
+   * @complexity O(1)
+   */
+  void release() {
+    if (data != nullptr) {
+      AllocatorTraits::deallocate(allocator, data, capacity);
+      data = nullptr;
+      capacity = 0;
+    }
+  }
 
   /**
    * Resize the array to a new capacity.
@@ -40,169 +147,1347 @@ private:
    * - Best: O(n)
    */
   void resize(size_t newCapacity) {
-    T *newData = new T[newCapacity];
+    T *newData = AllocatorTraits::allocate(allocator, newCapacity);
 
-    for (size_t i = 0; i < size; ++i) {
-      newData[i] = std::move(data[i]);
+    try {
+      relocate(data, size, newData);
+    } catch (...) {
+      AllocatorTraits::deallocate(allocator, newData, newCapacity);
+      throw;
+    }
+
+    if (data != nullptr) {
+      AllocatorTraits::deallocate(allocator, data, capacity);
     }
 
-    delete[] data;
     data = newData;
     capacity = newCapacity;
+    this->addReallocation();
+  }
+
+  /**
+   * Whether `a` belongs before `b` in the array's order.
+   *
+   * @complexity O(1)
+   */
+  template <typename A, typename B>
+  bool precedes(const A &a, const B &b) const {
+    this->addComparisons(1);
+
+    return comp(a, b);
   }
 
   /**
-   * Perform binary search to find the appropriate index for insertion.
+   * Binary search for the first index whose element does not precede
+   * `value` (`upper` false) or that `value` precedes (`upper` true).
    *
    * @complexity
    * - Worst: O(log n)
    * - Average: O(log n)
-   * - Best: O(1)
+   * - Best: O(log n)
    */
-  int binarySearch(const T &value, bool isInsertion) const {
+  template <typename K> size_t flatBound(const K &value, bool upper) const {
     size_t left = 0;
-    size_t right = size - 1;
+    size_t right = size;
 
-    while (left <= right) {
+    while (left < right) {
       size_t mid = left + (right - left) / 2;
+      bool goesRight =
+          upper ? !precedes(value, data[mid]) : precedes(data[mid], value);
 
-      if (data[mid] == value) {
-        return mid;
-      } else if ((isAscending && data[mid] < value) ||
-                 (!isAscending && data[mid] > value)) {
+      if (goesRight) {
         left = mid + 1;
       } else {
-        right = mid - 1;
+        right = mid;
       }
     }
 
-    return isInsertion ? left : -1;
+    return left;
   }
 
-public:
   /**
-   * Default constructor with ascending order.
+   * Walk the Eytzinger layout down to a leaf. `goesRight(node)` decides each
+   * step, so the lower/upper choice is made once per search rather than per
+   * step.
    *
-   * @complexity O(1)
+   * @complexity O(log n)
    */
-  OrderedArray(bool ascending = true)
-      : size(0), capacity(1), isAscending(ascending) {
-    data = new T[capacity];
+  template <typename GoesRight>
+  size_t eytzingerDescend(GoesRight goesRight) const {
+    // Descendants four levels down sit 16 nodes apart; prefetch the cache
+    // line where they start (clamped to stay inside the layout).
+    constexpr size_t prefetchStride = 16;
+    const size_t count = eytzinger.size();
+    const T *nodes = eytzinger.data();
+    size_t k = 1;
+
+    while (k <= count) {
+      prefetchRead(nodes + std::min(k * prefetchStride, count) - 1);
+      k = 2 * k + goesRight(nodes[k - 1]);
+      this->addComparisons(1);
+    }
+
+    return k;
   }
 
   /**
-   * Constructor using an initializer list.
+   * flatBound over the Eytzinger layout built by freeze().
    *
-   * @complexity O(n log n)
+   * Node k (1-based) has children 2k and 2k + 1. Every step is a
+   * comparison folded into the next index, so there is no branch to
+   * mispredict, and the node several levels below is prefetched.
+   *
+   * @complexity
+   * - Worst: O(log n)
+   * - Average: O(log n)
+   * - Best: O(log n)
    */
-  OrderedArray(std::initializer_list<T> init, bool ascending = true)
-      : size(init.size()), capacity(init.size() * 2), isAscending(ascending) {
-    data = new T[capacity];
-    std::copy(init.begin(), init.end(), data);
-    std::sort(data, data + size, [this](const T &a, const T &b) {
-      return isAscending ? a < b : a > b;
-    });
+  template <typename K>
+  size_t eytzingerBound(const K &value, bool upper) const {
+    size_t k;
+
+    if (upper) {
+      k = eytzingerDescend([&](const T &n) { return !comp(value, n); });
+    } else {
+      k = eytzingerDescend([&](const T &n) { return comp(n, value); });
+    }
+
+    // Undo the trailing right turns plus the final left turn to get the
+    // first node where the search went left.
+    k >>= countTrailingZeros(static_cast<uint64_t>(~k)) + 1;
+
+    return k == 0 ? size : eytzingerRank[k - 1];
   }
 
   /**
-   * Destructor.
+   * flatBound through the model built by freezeLearned(): the segment
+   * predicts the position and only a window of a few elements around it
+   * is searched.
+   *
+   * @complexity
+   * - Worst: O(log n)
+   * - Average: O(log epsilon) per level
+   * - Best: O(log epsilon)
+   */
+  size_t learnedBound(const T &value, bool upper) const {
+    return learned.bound(data, size, value, upper,
+                         [this](const T &a, const T &b) {
+                           return precedes(a, b);
+                         });
+  }
+
+  /**
+   * Bound search on whichever layout is active. Heterogeneous keys skip the
+   * learned model, which only evaluates keys of type T.
+   *
+   * @complexity O(log n)
+   */
+  template <typename K> size_t bound(const K &value, bool upper) const {
+    if constexpr (std::is_same<K, T>::value &&
+                  learnedIndexApplies<T, Compare>) {
+      if (!learned.isEmpty()) {
+        return learnedBound(value, upper);
+      }
+    }
+
+    return eytzinger.empty() ? flatBound(value, upper)
+                             : eytzingerBound(value, upper);
+  }
+
+  /**
+   * Lower bounds of `count` keys, searched in groups that advance in
+   * lockstep. All searches in a group share the same remaining length, so
+   * each step is one branchless comparison per key, and both cache lines
+   * the next step may touch are prefetched for every key before any of them
+   * is read. The misses of the whole group overlap instead of forming one
+   * dependent chain per key.
+   *
+   * @complexity O(k log n)
+   */
+  void batchedLowerBound(const T *keys, size_t count, size_t *out) const {
+    constexpr size_t groupSize = 16;
+    const T *base[groupSize];
+
+    for (size_t start = 0; start < count; start += groupSize) {
+      size_t group = std::min(groupSize, count - start);
+      const T *groupKeys = keys + start;
+
+      for (size_t g = 0; g < group; ++g) {
+        base[g] = data;
+      }
+
+      size_t length = size;
+
+      while (length > 1) {
+        size_t half = length / 2;
+        size_t nextHalf = (length - half) / 2;
+
+        for (size_t g = 0; g < group; ++g) {
+          prefetchRead(base[g] + nextHalf);
+          prefetchRead(base[g] + half + nextHalf);
+        }
+
+        for (size_t g = 0; g < group; ++g) {
+          base[g] += comp(base[g][half - 1], groupKeys[g]) ? half : 0;
+        }
+
+        this->addComparisons(group);
+        length -= half;
+      }
+
+      for (size_t g = 0; g < group; ++g) {
+        out[start + g] =
+            (base[g] - data) + (comp(*base[g], groupKeys[g]) ? 1 : 0);
+      }
+
+      this->addComparisons(group);
+    }
+  }
+
+  /**
+   * Lower bound of `value` among the indices from `from` on, found by
+   * galloping (doubling steps) from `from` and then searching the last
+   * step. Costs O(log d) when the answer is d positions away.
+   *
+   * @complexity O(log d)
+   */
+  size_t gallopingLowerBound(size_t from, const T &value) const {
+    size_t step = 1;
+    size_t low = from;
+    size_t high = from;
+
+    while (high < size && precedes(data[high], value)) {
+      low = high + 1;
+      high = from + step;
+      step *= 2;
+    }
+
+    high = std::min(high, size);
+
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+
+      if (precedes(data[mid], value)) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+
+    return low;
+  }
+
+  /**
+   * Whether the element at `index` exists and is equivalent to `value`,
+   * which it does not precede.
    *
    * @complexity O(1)
    */
-  ~OrderedArray() { delete[] data; }
+  template <typename K> bool matches(size_t index, const K &value) const {
+    return index < size && !precedes(value, data[index]);
+  }
 
   /**
-   * Return size.
+   * Whether the slot `slot` is tombstoned.
    *
    * @complexity O(1)
    */
-  size_t getSize() const { return size; }
+  bool isTombstoned(size_t slot) const {
+    return slot / 64 < tombstones.size() &&
+           ((tombstones[slot / 64] >> (slot % 64)) & 1) != 0;
+  }
 
   /**
-   * Return Capacity.
+   * Index among the live elements of the first live slot at or after
+   * `slot`, for any `slot` up to `size`.
    *
    * @complexity O(1)
    */
-  size_t getCapacity() const { return capacity; }
+  size_t liveIndexOf(size_t slot) const {
+    if (removedCount == 0) {
+      return slot;
+    }
+
+    size_t group = slot / tombstoneGroupSlots;
+
+    if (group >= removedBefore.size()) {
+      return slot - removedCount;
+    }
+
+    size_t removed = removedBefore[group];
+    size_t word = group * tombstoneGroupWords;
+
+    for (; word < slot / 64; ++word) {
+      removed += popCount(tombstones[word]);
+    }
+
+    if (slot % 64 != 0) {
+      removed += popCount(tombstones[word] &
+                          ((uint64_t(1) << (slot % 64)) - 1));
+    }
+
+    return slot - removed;
+  }
 
   /**
+   * Slot of the live element at `index`, or `size` for index getSize().
    *
-   * Access an element at a specific index.
+   * @complexity O(log n)
+   */
+  size_t slotOf(size_t index) const {
+    if (removedCount == 0) {
+      return index;
+    }
+
+    if (index >= size - removedCount) {
+      return size;
+    }
+
+    // Last group starting with at most `index` live slots before it.
+    size_t low = 0;
+    size_t high = removedBefore.size();
+
+    while (high - low > 1) {
+      size_t mid = low + (high - low) / 2;
+
+      if (mid * tombstoneGroupSlots - removedBefore[mid] <= index) {
+        low = mid;
+      } else {
+        high = mid;
+      }
+    }
+
+    size_t remaining = index - (low * tombstoneGroupSlots - removedBefore[low]);
+    size_t word = low * tombstoneGroupWords;
+
+    for (;; ++word) {
+      uint64_t live = ~tombstones[word];
+      size_t count = popCount(live);
+
+      if (remaining < count) {
+        for (; remaining > 0; --remaining) {
+          live &= live - 1;
+        }
+
+        return word * 64 + countTrailingZeros(live);
+      }
+
+      remaining -= count;
+    }
+  }
+
+  /**
+   * Mark the live slot `slot` as removed.
    *
-   * @complexity O(1)
+   * @complexity O(n / 512)
    */
+  void markRemoved(size_t slot) {
+    if (tombstones.size() * 64 < size) {
+      tombstones.resize((size + 63) / 64, 0);
+      removedBefore.resize(
+          (tombstones.size() + tombstoneGroupWords - 1) / tombstoneGroupWords,
+          removedCount);
+    }
 
-  const T &get(size_t index) const {
-    if (index >= size) {
-      throw std::out_of_range("Index out of range");
+    tombstones[slot / 64] |= uint64_t(1) << (slot % 64);
+    ++removedCount;
+
+    for (size_t group = slot / tombstoneGroupSlots + 1;
+         group < removedBefore.size(); ++group) {
+      ++removedBefore[group];
+    }
+  }
+
+  /**
+   * View of the slots [first, last), which must hold no tombstones.
+   *
+   * @complexity O(1)
+   */
+  ArrayView<T> contiguousView(size_t first, size_t last) const {
+    if (removedCount > 0 &&
+        liveIndexOf(last) - liveIndexOf(first) != last - first) {
+      throw std::logic_error("View spans removed elements; compact() first");
     }
 
-    return data[index];
+    return ArrayView<T>(data + first, last - first);
   }
 
   /**
-   * Perform binary search on the ordered array.
+   * Bound search returning an index among the live elements.
    *
-   * @complexity
-   * - Worst: O(log n)
-   * - Average: O(log n)
-   * - Best: O(1)
-   * @return index of the found element or -1 if not found.
+   * @complexity O(log n)
    */
-  int find(const T &value) const { return binarySearch(value, false); }
+  template <typename K> size_t liveBound(const K &value, bool upper) const {
+    return liveIndexOf(bound(value, upper));
+  }
 
   /**
-   * Insert an element while maintaining order using binary search.
+   * Skip removed copies of `value` starting at the bound `index`.
    *
-   * @complexity
-   * - Worst: O(n)
-   * - Average: O(n)
-   * - Best: O(1)
+   * @complexity O(1) without tombstones, O(r) over r removed equal copies
+   * @return index of the first live element equivalent to `value`, or npos.
    */
-  void insert(const T &value) {
-    if (size >= capacity) {
-      resize(capacity * 2);
+  template <typename K>
+  size_t firstLiveMatch(size_t index, const K &value) const {
+    while (matches(index, value)) {
+      if (!isTombstoned(index)) {
+        return index;
+      }
+
+      ++index;
     }
 
-    int index = binarySearch(value, true);
+    return npos;
+  }
 
-    for (size_t i = size; i > index; --i) {
-      data[i] = std::move(data[i - 1]);
+  /**
+   * Remove, in one pass, every tombstoned slot and every index for which
+   * `removeIndex(i)` holds, moving each survivor at most once. The relative
+   * order is kept, so the array stays sorted.
+   *
+   * @complexity O(n)
+   */
+  template <typename RemoveIndex> size_t compactWhere(RemoveIndex removeIndex) {
+    size_t write = 0;
+
+    for (size_t read = 0; read < size; ++read) {
+      if (isTombstoned(read) || removeIndex(read)) {
+        continue;
+      }
+
+      if (write != read) {
+        data[write] = std::move(data[read]);
+        this->addMoves(1);
+      }
+
+      ++write;
     }
 
-    data[index] = value;
-    ++size;
+    size_t removed = size - write;
+
+    if (removed > 0) {
+      thaw();
+      std::destroy(data + write, data + size);
+      size = write;
+    }
+
+    std::fill(tombstones.begin(), tombstones.end(), 0);
+    std::fill(removedBefore.begin(), removedBefore.end(), 0);
+    removedCount = 0;
+
+    return removed;
   }
 
   /**
-   * Remove an element at a specific index.
+   * find for a key of any type the comparator accepts.
    *
-   * @complexity
-   * - Worst: O(n)
-   * - Average: O(n)
-   * - Best: O(1)
+   * @complexity O(log n)
    */
-  void remove(size_t index) {
-    if (index >= size) {
-      throw std::out_of_range("Index out of range");
+  template <typename K> size_t findKey(const K &value) const {
+    size_t index = bound(value, false);
+
+    if (removedCount > 0) {
+      index = firstLiveMatch(index, value);
+      return index == npos ? npos : liveIndexOf(index);
     }
 
-    for (size_t i = index; i < size - 1; ++i) {
-      data[i] = std::move(data[i + 1]);
+    return matches(index, value) ? index : npos;
+  }
+
+  /**
+   * range for keys of any type the comparator accepts.
+   *
+   * @complexity O(log n)
+   */
+  template <typename K>
+  ArrayView<T> rangeOf(const K &from, const K &to) const {
+    size_t first = bound(from, false);
+    size_t last = std::max(first, bound(to, false));
+
+    return contiguousView(first, last);
+  }
+
+  /**
+   * Drop the frozen search layout or model before the array changes.
+   *
+   * @complexity O(1)
+   */
+  void thaw() {
+    if (!eytzinger.empty()) {
+      decltype(eytzinger)(allocator).swap(eytzinger);
+      decltype(eytzingerRank)(allocator).swap(eytzingerRank);
     }
 
-    --size;
+    if (!learned.isEmpty()) {
+      learned.clear();
+    }
   }
 
-  // Begin iterator
-  T *begin() { return data; }
+  /**
+   * Copy the elements of `other` into this empty array, growing to exactly
+   * its size if needed.
+   *
+   * @complexity O(n)
+   */
+  void copyElementsFrom(const OrderedArray &other) {
+    if (other.size > capacity) {
+      release();
+      data = AllocatorTraits::allocate(allocator, other.size);
+      capacity = other.size;
+    }
 
-  // End iterator
-  T *end() { return data + size; }
+    std::uninitialized_copy(other.data, other.data + other.size, data);
+    size = other.size;
+  }
 
-  // Const begin iterator
-  const T *begin() const { return data; }
+  /**
+   * Take the buffer of `other` into this empty, bufferless array.
+   *
+   * @complexity O(1)
+   */
+  void takeBufferFrom(OrderedArray &other) noexcept {
+    data = std::exchange(other.data, nullptr);
+    size = std::exchange(other.size, 0);
+    capacity = std::exchange(other.capacity, 0);
+  }
 
-  // Const end iterator
-  const T *end() const { return data + size; }
-};
+  /**
+   * Copy the order, search layout and tombstones of `other`; the members
+   * holding memory are assigned with their own allocator semantics.
+   *
+   * @complexity O(n)
+   */
+  template <typename Other> void assignStateFrom(Other &&other) {
+    Stats::operator=(other);
+    comp = other.comp;
+    eytzinger = std::forward<Other>(other).eytzinger;
+    eytzingerRank = std::forward<Other>(other).eytzingerRank;
+    learned = std::forward<Other>(other).learned;
+    useTombstones = other.useTombstones;
+    tombstoneThreshold = other.tombstoneThreshold;
+    tombstones = std::forward<Other>(other).tombstones;
+    removedBefore = std::forward<Other>(other).removedBefore;
+    removedCount = other.removedCount;
+  }
+
+public:
+  /**
+   * Forward iterator over the live elements in order, skipping tombstoned
+   * slots.
+   */
+  class Iterator {
+  private:
+    const OrderedArray *array;
+    size_t slot;
+
+    void skipRemoved() {
+      while (slot < array->size && array->isTombstoned(slot)) {
+        ++slot;
+      }
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    Iterator() : array(nullptr), slot(0) {}
+
+    Iterator(const OrderedArray *array, size_t slot)
+        : array(array), slot(slot) {
+      if (array->removedCount > 0) {
+        skipRemoved();
+      }
+    }
+
+    reference operator*() const { return array->data[slot]; }
+    pointer operator->() const { return array->data + slot; }
+
+    Iterator &operator++() {
+      ++slot;
+
+      if (array->removedCount > 0) {
+        skipRemoved();
+      }
+
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const Iterator &other) const { return slot == other.slot; }
+
+    bool operator!=(const Iterator &other) const { return !(*this == other); }
+  };
+
+  /**
+   * Index returned by find when nothing matches.
+   */
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /**
+   * Default constructor.
+   *
+   * @complexity O(1)
+   */
+  OrderedArray() : OrderedArray(Compare()) {}
+
+  /**
+   * Empty array ordered by `comp` and allocating from `allocator`.
+   *
+   * @complexity O(1)
+   */
+  explicit OrderedArray(const Compare &comp,
+                        const Allocator &allocator = Allocator())
+      : allocator(allocator), size(0), capacity(1), comp(comp),
+        eytzinger(allocator), eytzingerRank(allocator), learned(allocator),
+        tombstones(allocator), removedBefore(allocator) {
+    data = AllocatorTraits::allocate(this->allocator, capacity);
+  }
+
+  /**
+   * Empty array allocating from `allocator`.
+   *
+   * @complexity O(1)
+   */
+  explicit OrderedArray(const Allocator &allocator)
+      : OrderedArray(Compare(), allocator) {}
+
+  /**
+   * Constructor using an initializer list.
+   *
+   * @complexity O(n log n)
+   */
+  OrderedArray(std::initializer_list<T> init, const Compare &comp = Compare(),
+               const Allocator &allocator = Allocator())
+      : allocator(allocator), size(init.size()), capacity(init.size() * 2),
+        comp(comp), eytzinger(allocator), eytzingerRank(allocator),
+        learned(allocator), tombstones(allocator), removedBefore(allocator) {
+    data = AllocatorTraits::allocate(this->allocator, capacity);
+
+    try {
+      std::uninitialized_copy(init.begin(), init.end(), data);
+    } catch (...) {
+      AllocatorTraits::deallocate(this->allocator, data, capacity);
+      throw;
+    }
+
+    std::sort(data, data + size,
+              [this](const T &a, const T &b) { return precedes(a, b); });
+  }
+
+  /**
+   * Destructor.
+   *
+   * @complexity O(n)
+   */
+  ~OrderedArray() {
+    std::destroy(data, data + size);
+    release();
+  }
+
+  /**
+   * Deep copy, including the frozen layout and tombstones. The copy's
+   * capacity is its size.
+   *
+   * @complexity O(n)
+   */
+  OrderedArray(const OrderedArray &other)
+      : Stats(other),
+        allocator(AllocatorTraits::select_on_container_copy_construction(
+            other.allocator)),
+        data(nullptr), size(0), capacity(0), comp(other.comp),
+        eytzinger(other.eytzinger, allocator),
+        eytzingerRank(other.eytzingerRank, allocator),
+        learned(other.learned, allocator),
+        useTombstones(other.useTombstones),
+        tombstoneThreshold(other.tombstoneThreshold),
+        tombstones(other.tombstones, allocator),
+        removedBefore(other.removedBefore, allocator),
+        removedCount(other.removedCount) {
+    try {
+      copyElementsFrom(other);
+    } catch (...) {
+      release();
+      throw;
+    }
+  }
+
+  /**
+   * Take over the buffers of `other`, leaving it empty.
+   *
+   * @complexity O(1)
+   */
+  OrderedArray(OrderedArray &&other) noexcept
+      : Stats(other), allocator(std::move(other.allocator)), data(nullptr),
+        size(0), capacity(0), comp(other.comp),
+        eytzinger(std::move(other.eytzinger)),
+        eytzingerRank(std::move(other.eytzingerRank)),
+        learned(std::move(other.learned)),
+        useTombstones(other.useTombstones),
+        tombstoneThreshold(other.tombstoneThreshold),
+        tombstones(std::move(other.tombstones)),
+        removedBefore(std::move(other.removedBefore)),
+        removedCount(std::exchange(other.removedCount, 0)) {
+    takeBufferFrom(other);
+  }
+
+  /**
+   * Replace the contents with a copy of `other`, reusing the buffer when it
+   * is large enough.
+   *
+   * @complexity O(n + m)
+   */
+  OrderedArray &operator=(const OrderedArray &other) {
+    if (this == &other) {
+      return *this;
+    }
+
+    std::destroy(data, data + size);
+    size = 0;
+
+    if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::
+                      value) {
+      if (allocator != other.allocator) {
+        release();
+      }
+
+      allocator = other.allocator;
+    }
+
+    copyElementsFrom(other);
+    assignStateFrom(other);
+
+    return *this;
+  }
+
+  /**
+   * Take over the buffers of `other`, leaving it empty. With allocators
+   * that neither propagate nor compare equal the elements are moved one by
+   * one instead.
+   *
+   * @complexity O(n) to destroy the old elements, otherwise O(1)
+   */
+  OrderedArray &operator=(OrderedArray &&other) noexcept(
+      AllocatorTraits::propagate_on_container_move_assignment::value ||
+      AllocatorTraits::is_always_equal::value) {
+    if (this == &other) {
+      return *this;
+    }
+
+    std::destroy(data, data + size);
+    size = 0;
+
+    if constexpr (AllocatorTraits::propagate_on_container_move_assignment::
+                      value) {
+      release();
+      allocator = std::move(other.allocator);
+      takeBufferFrom(other);
+    } else if (allocator == other.allocator) {
+      release();
+      takeBufferFrom(other);
+    } else {
+      if (other.size > capacity) {
+        release();
+        data = AllocatorTraits::allocate(allocator, other.size);
+        capacity = other.size;
+      }
+
+      std::uninitialized_move(other.data, other.data + other.size, data);
+      size = other.size;
+      std::destroy(other.data, other.data + other.size);
+      other.size = 0;
+    }
+
+    assignStateFrom(std::move(other));
+    other.removedCount = 0;
+
+    return *this;
+  }
+
+  /**
+   * Exchange the contents of two arrays in O(1).
+   *
+   * @complexity O(1)
+   */
+  void swap(OrderedArray &other) noexcept {
+    if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+      std::swap(allocator, other.allocator);
+    }
+
+    std::swap(static_cast<Stats &>(*this), static_cast<Stats &>(other));
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+    std::swap(capacity, other.capacity);
+    std::swap(comp, other.comp);
+    eytzinger.swap(other.eytzinger);
+    eytzingerRank.swap(other.eytzingerRank);
+    learned.swap(other.learned);
+    std::swap(useTombstones, other.useTombstones);
+    std::swap(tombstoneThreshold, other.tombstoneThreshold);
+    tombstones.swap(other.tombstones);
+    removedBefore.swap(other.removedBefore);
+    std::swap(removedCount, other.removedCount);
+  }
+
+  friend void swap(OrderedArray &a, OrderedArray &b) noexcept { a.swap(b); }
+
+  /**
+   * Return the number of live elements.
+   *
+   * @complexity O(1)
+   */
+  size_t getSize() const { return size - removedCount; }
+
+  /**
+   * Return Capacity.
+   *
+   * @complexity O(1)
+   */
+  size_t getCapacity() const { return capacity; }
+
+  /**
+   * Return a copy of the allocator.
+   *
+   * @complexity O(1)
+   */
+  Allocator getAllocator() const { return allocator; }
+
+  /**
+   *
+   * Access an element at a specific index.
+   *
+   * @complexity O(1), O(log n) while elements are tombstoned
+   */
+
+  const T &get(size_t index) const {
+    if (index >= getSize()) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    return data[slotOf(index)];
+  }
+
+  /**
+   * Perform binary search on the ordered array (on the Eytzinger layout
+   * while frozen).
+   *
+   * @complexity
+   * - Worst: O(log n)
+   * - Average: O(log n)
+   * - Best: O(log n)
+   * @return index of the first element equivalent to `value`, or npos if
+   * not found.
+   */
+  size_t find(const T &value) const { return findKey(value); }
+
+  /**
+   * find by any key type the transparent comparator accepts, e.g. the ID
+   * field of a record.
+   *
+   * @complexity O(log n)
+   */
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_t find(const K &key) const {
+    return findKey(key);
+  }
+
+  /**
+   * Index of the first element that does not precede `value` in the
+   * array's order, or getSize() if there is none.
+   *
+   * @complexity O(log n)
+   */
+  size_t lowerBound(const T &value) const { return liveBound(value, false); }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_t lowerBound(const K &key) const {
+    return liveBound(key, false);
+  }
+
+  /**
+   * Index of the first element that `value` precedes in the array's order,
+   * or getSize() if there is none.
+   *
+   * @complexity O(log n)
+   */
+  size_t upperBound(const T &value) const { return liveBound(value, true); }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_t upperBound(const K &key) const {
+    return liveBound(key, true);
+  }
+
+  /**
+   * Half-open index range [first, second) of the elements equivalent to
+   * `value`.
+   *
+   * @complexity O(log n)
+   */
+  std::pair<size_t, size_t> equalRange(const T &value) const {
+    return {liveBound(value, false), liveBound(value, true)};
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<size_t, size_t> equalRange(const K &key) const {
+    return {liveBound(key, false), liveBound(key, true)};
+  }
+
+  /**
+   * View of the elements from `from` (inclusive) up to `to` (exclusive) in
+   * the array's order, for example a time window over sorted timestamps.
+   * No elements are copied; the view is invalidated by the next mutation.
+   * Throws std::logic_error if a removed element lies inside the range
+   * while it awaits compaction.
+   *
+   * @complexity O(log n)
+   */
+  ArrayView<T> range(const T &from, const T &to) const {
+    return rangeOf(from, to);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  ArrayView<T> range(const K &from, const K &to) const {
+    return rangeOf(from, to);
+  }
+
+  /**
+   * Look up `count` keys at once, writing the index of each key's first
+   * match (or npos) to `out`.
+   *
+   * Unsorted keys are searched 16 at a time in lockstep with software
+   * prefetching, which keeps many cache misses in flight instead of one per
+   * lookup. Keys already sorted in the array's order take a merge-like path
+   * where each search gallops forward from the previous result.
+   *
+   * @complexity
+   * - Worst: O(k log n)
+   * - Average: O(k log n)
+   * - Best: O(n + k) (Sorted keys)
+   */
+  void findMany(const T *keys, size_t count, size_t *out) const {
+    if (size == 0) {
+      std::fill(out, out + count, npos);
+      return;
+    }
+
+    auto order = [this](const T &a, const T &b) { return precedes(a, b); };
+
+    if (std::is_sorted(keys, keys + count, order)) {
+      size_t previous = 0;
+
+      for (size_t i = 0; i < count; ++i) {
+        previous = gallopingLowerBound(previous, keys[i]);
+        out[i] = previous;
+      }
+    } else {
+      batchedLowerBound(keys, count, out);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      if (removedCount > 0) {
+        size_t slot = firstLiveMatch(out[i], keys[i]);
+        out[i] = slot == npos ? npos : liveIndexOf(slot);
+      } else {
+        out[i] = matches(out[i], keys[i]) ? out[i] : npos;
+      }
+    }
+  }
+
+  /**
+   * Build the Eytzinger search layout used by `find` until the next
+   * mutation. Call it after bulk loading a read-mostly array.
+   *
+   * @complexity O(n)
+   */
+  void freeze() {
+    thaw();
+    eytzingerRank.resize(size);
+
+    // An in-order walk of the implicit tree visits the nodes in sorted
+    // order, so the i-th node visited holds data[i].
+    size_t rank = 0;
+    size_t k = 1;
+
+    while (rank < size) {
+      while (k <= size) {
+        k *= 2;
+      }
+
+      k >>= countTrailingZeros(static_cast<uint64_t>(~k)) + 1;
+      eytzingerRank[k - 1] = rank++;
+      k = 2 * k + 1;
+    }
+
+    eytzinger.reserve(size);
+
+    for (size_t i = 0; i < size; ++i) {
+      eytzinger.push_back(data[eytzingerRank[i]]);
+    }
+  }
+
+  /**
+   * Fit the learned model used by `find`, `lowerBound`, `upperBound` and
+   * `equalRange` until the next mutation, in place of the Eytzinger layout
+   * of freeze(). Every distinct key is predicted to within `epsilon`
+   * positions; a larger bound means fewer segments and a wider final
+   * search. Only for arithmetic keys ordered by std::less.
+   *
+   * @complexity O(n)
+   */
+  void freezeLearned(size_t epsilon = learnedIndexEpsilon) {
+    static_assert(learnedIndexApplies<T, Compare>,
+                  "freezeLearned needs arithmetic keys ordered by std::less");
+
+    thaw();
+    learned.build(data, size, epsilon);
+  }
+
+  /**
+   * Whether a frozen search layout or learned model is active.
+   *
+   * @complexity O(1)
+   */
+  bool isFrozen() const { return !eytzinger.empty() || !learned.isEmpty(); }
+
+  /**
+   * Bytes held by the learned model, 0 unless freezeLearned() is active.
+   *
+   * @complexity O(1)
+   */
+  size_t getLearnedIndexBytes() const { return learned.getMemoryBytes(); }
+
+  /**
+   * Return a copy of the comparator.
+   *
+   * @complexity O(1)
+   */
+  Compare getCompare() const { return comp; }
+
+  /**
+   * Insert an element while maintaining order using binary search.
+   *
+   * `value` is copied before any element moves, so it may refer to an
+   * element of this array.
+   *
+   * @complexity
+   * - Worst: O(n)
+   * - Average: O(n)
+   * - Best: O(1)
+   */
+  void insert(const T &value) {
+    T item(value);
+    compact();
+    thaw();
+
+    if (size >= capacity) {
+      resize(std::max<size_t>(1, capacity * 2));
+    }
+
+    size_t index = flatBound(item, true);
+
+    if (index == size) {
+      AllocatorTraits::construct(allocator, data + size, std::move(item));
+      ++size;
+      return;
+    }
+
+    this->addMoves(size - index);
+
+    // The slot past the end is raw storage: construct it from the last
+    // element, then shift the rest of the tail with move assignment.
+    AllocatorTraits::construct(allocator, data + size,
+                               std::move(data[size - 1]));
+    ++size;
+
+    for (size_t i = size - 2; i > index; --i) {
+      data[i] = std::move(data[i - 1]);
+    }
+
+    data[index] = std::move(item);
+  }
+
+  /**
+   * Ensure room for at least `newCapacity` elements without reallocating.
+   *
+   * @complexity
+   * - Worst: O(n)
+   * - Average: O(n)
+   * - Best: O(1) (If the capacity is already large enough)
+   */
+  void reserve(size_t newCapacity) {
+    if (newCapacity > capacity) {
+      resize(newCapacity);
+    }
+  }
+
+  /**
+   * Insert every element of [first, last) while maintaining order.
+   *
+   * The batch is sorted on its own and merged backward into the existing
+   * elements, so each element moves at most once instead of once per
+   * inserted value.
+   *
+   * @complexity
+   * - Worst: O(n + k log k)
+   * - Average: O(n + k log k)
+   * - Best: O(n + k) (If the batch is already sorted)
+   */
+  template <typename InputIt> void insertRange(InputIt first, InputIt last) {
+    std::vector<T> batch(first, last);
+    size_t count = batch.size();
+
+    if (count == 0) {
+      return;
+    }
+
+    compact();
+    thaw();
+
+    auto order = [this](const T &a, const T &b) { return precedes(a, b); };
+
+    if (!std::is_sorted(batch.begin(), batch.end(), order)) {
+      std::sort(batch.begin(), batch.end(), order);
+    }
+
+    reserve(size + count);
+
+    // Fill from the back: the first `count` writes land in raw storage past
+    // the end and are constructed, the rest overwrite moved-from elements.
+    size_t out = size + count;
+    size_t i = size;
+    size_t j = count;
+
+    try {
+      while (j > 0) {
+        --out;
+        T &next = (i > 0 && precedes(batch[j - 1], data[i - 1]))
+                      ? data[--i]
+                      : batch[--j];
+
+        if (out >= size) {
+          AllocatorTraits::construct(allocator, data + out, std::move(next));
+        } else {
+          data[out] = std::move(next);
+        }
+      }
+    } catch (...) {
+      std::destroy(data + std::max(out + 1, size), data + size + count);
+      throw;
+    }
+
+    // Existing elements below index i stayed where they were.
+    this->addMoves(size - i);
+    size += count;
+  }
+
+  /**
+   * Insert `count` elements starting at `values` while maintaining order.
+   *
+   * @complexity
+   * - Worst: O(n + k log k)
+   * - Average: O(n + k log k)
+   * - Best: O(n + k) (If the batch is already sorted)
+   */
+  void insertMany(const T *values, size_t count) {
+    insertRange(values, values + count);
+  }
+
+  /**
+   * Remove an element at a specific index.
+   *
+   * In tombstone mode the slot is only marked, which shifts the indices
+   * after it like a real removal, and the array is compacted once the
+   * marks exceed the threshold.
+   *
+   * @complexity
+   * - Worst: O(n)
+   * - Average: O(n), O(n / 512) amortized in tombstone mode
+   * - Best: O(1)
+   */
+  void remove(size_t index) {
+    if (index >= getSize()) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    if (useTombstones) {
+      markRemoved(slotOf(index));
+
+      if (removedCount > tombstoneThreshold * size) {
+        compact();
+      }
+
+      return;
+    }
+
+    thaw();
+
+    for (size_t i = index; i < size - 1; ++i) {
+      data[i] = std::move(data[i + 1]);
+    }
+
+    this->addMoves(size - 1 - index);
+
+    --size;
+    AllocatorTraits::destroy(allocator, data + size);
+  }
+
+  /**
+   * Remove the elements at indices [first, last), together with any
+   * tombstoned slots, shifting the tail once.
+   *
+   * @complexity O(n)
+   */
+  void removeRange(size_t first, size_t last) {
+    if (first > last || last > getSize()) {
+      throw std::out_of_range("Index out of range");
+    }
+
+    if (first == last && removedCount == 0) {
+      return;
+    }
+
+    size_t firstSlot = slotOf(first);
+    size_t lastSlot = slotOf(last);
+    compactWhere([firstSlot, lastSlot](size_t i) {
+      return i >= firstSlot && i < lastSlot;
+    });
+  }
+
+  /**
+   * Remove every element for which `pred(element)` is true, together with
+   * any tombstoned slots, in a single compaction pass.
+   *
+   * @complexity O(n)
+   * @return number of elements that satisfied `pred`, as in
+   * DynamicArray::removeIf; the tombstoned slots are not counted.
+   */
+  template <typename Predicate> size_t removeIf(Predicate pred) {
+    size_t matched = 0;
+
+    compactWhere([this, &pred, &matched](size_t i) {
+      bool match = pred(data[i]);
+      matched += match;
+      return match;
+    });
+
+    return matched;
+  }
+
+  /**
+   * Switch `remove` to tombstone mode. The array is compacted once more
+   * than `compactThreshold` (in (0, 1]) of its slots are removed.
+   *
+   * @complexity O(1)
+   */
+  void enableTombstones(double compactThreshold = 0.25) {
+    if (!(compactThreshold > 0 && compactThreshold <= 1)) {
+      throw std::invalid_argument("Compact threshold must be in (0, 1]");
+    }
+
+    useTombstones = true;
+    tombstoneThreshold = compactThreshold;
+  }
+
+  /**
+   * Compact pending tombstones and return to removing by shifting.
+   *
+   * @complexity O(n)
+   */
+  void disableTombstones() {
+    compact();
+    useTombstones = false;
+    decltype(tombstones)(allocator).swap(tombstones);
+    decltype(removedBefore)(allocator).swap(removedBefore);
+  }
+
+  /**
+   * Return the number of removed elements awaiting compaction.
+   *
+   * @complexity O(1)
+   */
+  size_t getRemovedCount() const { return removedCount; }
+
+  /**
+   * Drop every tombstoned slot in one pass.
+   *
+   * @complexity
+   * - Worst: O(n)
+   * - Average: O(n)
+   * - Best: O(1) (If nothing is tombstoned)
+   */
+  void compact() {
+    if (removedCount > 0) {
+      compactWhere([](size_t) { return false; });
+    }
+  }
+
+  /**
+   * Call `fn(element)` for every live element in order, skipping tombstoned
+   * slots.
+   *
+   * @complexity O(n)
+   */
+  template <typename Function> void forEach(Function fn) const {
+    for (size_t i = 0; i < size; ++i) {
+      if (removedCount == 0 || !isTombstoned(i)) {
+        fn(data[i]);
+      }
+    }
+  }
+
+  /**
+   * Return the operation counters of the Stats policy (all zero for
+   * NoStats).
+   *
+   * @complexity O(1)
+   */
+  const OperationCounts &stats() const { return Stats::stats(); }
+
+  /**
+   * Reset the operation counters.
+   *
+   * @complexity O(1)
+   */
+  void resetStats() { Stats::resetStats(); }
+
+  /**
+   * View of every element, for passing the array to code that takes a
+   * contiguous range. Throws std::logic_error while removed elements await
+   * compaction.
+   *
+   * @complexity O(1)
+   */
+  ArrayView<T> view() const { return contiguousView(0, size); }
+
+  // Begin iterator
+  Iterator begin() const { return Iterator(this, 0); }
+
+  // End iterator
+  Iterator end() const { return Iterator(this, size); }
+};
+
+namespace pmr {
+
+/**
+ * OrderedArray allocating from a std::pmr::memory_resource.
+ */
+template <typename T, typename Compare = std::less<T>,
+          typename Stats = NoStats>
+using OrderedArray =
+    ::OrderedArray<T, Compare, Stats, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
+
+#endif // ORDERED_ARRAY_CPP
@@ -0,0 +1,318 @@
+#ifndef ORDERED_SET_OPERATIONS_CPP
+#define ORDERED_SET_OPERATIONS_CPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "../../sortings/PowerSort.cpp"
+#include "OrderedArray.cpp"
+#include "VectorizedSearch.cpp"
+
+/**
+ * Ordered set operations
+ *
+ * merge, setUnion, setIntersection and setDifference combine two
+ * OrderedArrays with the same Compare into a new one, with the multiset
+ * semantics of their std:: counterparts: an element present p times in `a`
+ * and q times in `b` appears p + q, max(p, q), min(p, q) and max(p - q, 0)
+ * times respectively, and equivalent elements are taken from `a` first.
+ *
+ * 1. **Linear merges**: arrays of similar size are combined in one pass,
+ *    O(n + m).
+ * 2. **Galloping**: when one array is at least orderedSetGallopRatio times
+ *    longer, the walk steps through the shorter one and finds each position
+ *    in the longer one by exponential search from the previous position,
+ *    O(m log(n / m)); the untouched runs of the longer array are copied in
+ *    bulk.
+ * 3. **SIMD intersection**: arrays of 4-byte integers in ascending order
+ *    without duplicates are intersected four-by-four with SSE2 compares.
+ *
+ * The result takes the comparator and allocator of `a`. Tombstoned
+ * elements are skipped; such arrays are first copied without them.
+ */
+
+// Size ratio from which set operations gallop over the longer array.
+constexpr size_t orderedSetGallopRatio = 16;
+
+/**
+ * Live elements of an OrderedArray as a contiguous range: the array's own
+ * buffer, or a copy without the tombstoned slots.
+ */
+template <typename T> struct OrderedSetInput {
+  std::vector<T> copy;
+  const T *data;
+  size_t size;
+
+  template <typename Compare, typename Stats, typename Allocator>
+  explicit OrderedSetInput(
+      const OrderedArray<T, Compare, Stats, Allocator> &array)
+      : data(nullptr), size(0) {
+    if (array.getRemovedCount() > 0) {
+      copy.reserve(array.getSize());
+      array.forEach([this](const T &value) { copy.push_back(value); });
+      data = copy.data();
+      size = copy.size();
+    } else {
+      ArrayView<T> all = array.view();
+      data = all.begin();
+      size = all.getSize();
+    }
+  }
+
+  const T *begin() const { return data; }
+  const T *end() const { return data + size; }
+};
+
+/**
+ * First position in [first, last) that does not precede `value`, by
+ * exponential search from `first`.
+ *
+ * @complexity O(log d) for a result d positions away
+ */
+template <typename T, typename Compare>
+const T *gallopLowerBound(const T *first, const T *last, const T &value,
+                          Compare comp) {
+  return gallopForward(first, last,
+                       [&](const T &x) { return comp(x, value); });
+}
+
+/**
+ * First position in [first, last) that `value` precedes, by exponential
+ * search from `first`.
+ *
+ * @complexity O(log d) for a result d positions away
+ */
+template <typename T, typename Compare>
+const T *gallopUpperBound(const T *first, const T *last, const T &value,
+                          Compare comp) {
+  return gallopForward(first, last,
+                       [&](const T &x) { return !comp(value, x); });
+}
+
+/**
+ * OrderedArray holding the sorted elements of `elements`, ordered and
+ * allocated like `like`.
+ *
+ * @complexity O(n)
+ */
+template <typename T, typename Compare, typename Stats, typename Allocator>
+OrderedArray<T, Compare, Stats, Allocator>
+orderedSetResult(const OrderedArray<T, Compare, Stats, Allocator> &like,
+                 std::vector<T> &elements) {
+  OrderedArray<T, Compare, Stats, Allocator> result(like.getCompare(),
+                                                    like.getAllocator());
+  result.insertRange(std::make_move_iterator(elements.begin()),
+                     std::make_move_iterator(elements.end()));
+
+  return result;
+}
+
+/**
+ * Every element of `a` and `b`, equivalent elements of `a` first.
+ *
+ * @complexity O(n + m), O(m log(n / m)) comparisons for very unequal sizes
+ */
+template <typename T, typename Compare, typename Stats, typename Allocator>
+OrderedArray<T, Compare, Stats, Allocator>
+merge(const OrderedArray<T, Compare, Stats, Allocator> &a,
+      const OrderedArray<T, Compare, Stats, Allocator> &b) {
+  OrderedSetInput<T> left(a);
+  OrderedSetInput<T> right(b);
+  Compare comp = a.getCompare();
+  std::vector<T> out;
+  out.reserve(left.size + right.size);
+
+  if (left.size * orderedSetGallopRatio <= right.size) {
+    const T *j = right.begin();
+
+    for (const T &value : left) {
+      const T *stop = gallopLowerBound(j, right.end(), value, comp);
+      out.insert(out.end(), j, stop);
+      out.push_back(value);
+      j = stop;
+    }
+
+    out.insert(out.end(), j, right.end());
+  } else if (right.size * orderedSetGallopRatio <= left.size) {
+    const T *i = left.begin();
+
+    for (const T &value : right) {
+      const T *stop = gallopUpperBound(i, left.end(), value, comp);
+      out.insert(out.end(), i, stop);
+      out.push_back(value);
+      i = stop;
+    }
+
+    out.insert(out.end(), i, left.end());
+  } else {
+    std::merge(left.begin(), left.end(), right.begin(), right.end(),
+               std::back_inserter(out), comp);
+  }
+
+  return orderedSetResult(a, out);
+}
+
+/**
+ * Elements of `a` or `b`; each value appears as often as in the array
+ * holding it more often.
+ *
+ * @complexity O(n + m), O(m log(n / m)) comparisons for very unequal sizes
+ */
+template <typename T, typename Compare, typename Stats, typename Allocator>
+OrderedArray<T, Compare, Stats, Allocator>
+setUnion(const OrderedArray<T, Compare, Stats, Allocator> &a,
+         const OrderedArray<T, Compare, Stats, Allocator> &b) {
+  OrderedSetInput<T> left(a);
+  OrderedSetInput<T> right(b);
+  Compare comp = a.getCompare();
+  std::vector<T> out;
+  out.reserve(left.size + right.size);
+
+  if (left.size * orderedSetGallopRatio <= right.size) {
+    const T *j = right.begin();
+
+    for (const T &value : left) {
+      const T *stop = gallopLowerBound(j, right.end(), value, comp);
+      out.insert(out.end(), j, stop);
+      out.push_back(value);
+      j = stop != right.end() && !comp(value, *stop) ? stop + 1 : stop;
+    }
+
+    out.insert(out.end(), j, right.end());
+  } else if (right.size * orderedSetGallopRatio <= left.size) {
+    const T *i = left.begin();
+
+    for (const T &value : right) {
+      const T *stop = gallopLowerBound(i, left.end(), value, comp);
+      out.insert(out.end(), i, stop);
+
+      if (stop != left.end() && !comp(value, *stop)) {
+        out.push_back(*stop++);
+      } else {
+        out.push_back(value);
+      }
+
+      i = stop;
+    }
+
+    out.insert(out.end(), i, left.end());
+  } else {
+    std::set_union(left.begin(), left.end(), right.begin(), right.end(),
+                   std::back_inserter(out), comp);
+  }
+
+  return orderedSetResult(a, out);
+}
+
+/**
+ * Elements of `a` that are also in `b`; each value appears as often as in
+ * the array holding it less often.
+ *
+ * @complexity O(n + m), O(m log(n / m)) comparisons for very unequal sizes
+ */
+template <typename T, typename Compare, typename Stats, typename Allocator>
+OrderedArray<T, Compare, Stats, Allocator>
+setIntersection(const OrderedArray<T, Compare, Stats, Allocator> &a,
+                const OrderedArray<T, Compare, Stats, Allocator> &b) {
+  OrderedSetInput<T> left(a);
+  OrderedSetInput<T> right(b);
+  Compare comp = a.getCompare();
+  std::vector<T> out;
+
+  if (left.size * orderedSetGallopRatio <= right.size) {
+    const T *j = right.begin();
+
+    for (const T &value : left) {
+      j = gallopLowerBound(j, right.end(), value, comp);
+
+      if (j != right.end() && !comp(value, *j)) {
+        out.push_back(value);
+        ++j;
+      }
+    }
+  } else if (right.size * orderedSetGallopRatio <= left.size) {
+    const T *i = left.begin();
+
+    for (const T &value : right) {
+      i = gallopLowerBound(i, left.end(), value, comp);
+
+      if (i != left.end() && !comp(value, *i)) {
+        out.push_back(*i++);
+      }
+    }
+  } else {
+    constexpr bool vectorizable =
+        std::is_integral<T>::value && sizeof(T) == 4 &&
+        (std::is_same<Compare, std::less<T>>::value ||
+         std::is_same<Compare, std::less<>>::value);
+
+    if constexpr (vectorizable) {
+      // The block kernel needs sets; duplicates take the scalar merge.
+      if (vectorizedStrictlyIncreasing(left.data, left.size) &&
+          vectorizedStrictlyIncreasing(right.data, right.size)) {
+        out.resize(std::min(left.size, right.size));
+        out.resize(vectorizedIntersect(left.data, left.size, right.data,
+                                       right.size, out.data()));
+
+        return orderedSetResult(a, out);
+      }
+    }
+
+    std::set_intersection(left.begin(), left.end(), right.begin(),
+                          right.end(), std::back_inserter(out), comp);
+  }
+
+  return orderedSetResult(a, out);
+}
+
+/**
+ * Elements of `a` that are not in `b`; a value present p times in `a` and
+ * q times in `b` appears max(p - q, 0) times.
+ *
+ * @complexity O(n + m), O(m log(n / m)) comparisons for very unequal sizes
+ */
+template <typename T, typename Compare, typename Stats, typename Allocator>
+OrderedArray<T, Compare, Stats, Allocator>
+setDifference(const OrderedArray<T, Compare, Stats, Allocator> &a,
+              const OrderedArray<T, Compare, Stats, Allocator> &b) {
+  OrderedSetInput<T> left(a);
+  OrderedSetInput<T> right(b);
+  Compare comp = a.getCompare();
+  std::vector<T> out;
+
+  if (left.size * orderedSetGallopRatio <= right.size) {
+    const T *j = right.begin();
+
+    for (const T &value : left) {
+      j = gallopLowerBound(j, right.end(), value, comp);
+
+      if (j != right.end() && !comp(value, *j)) {
+        ++j;
+      } else {
+        out.push_back(value);
+      }
+    }
+  } else if (right.size * orderedSetGallopRatio <= left.size) {
+    out.reserve(left.size);
+    const T *i = left.begin();
+
+    for (const T &value : right) {
+      const T *stop = gallopLowerBound(i, left.end(), value, comp);
+      out.insert(out.end(), i, stop);
+      i = stop != left.end() && !comp(value, *stop) ? stop + 1 : stop;
+    }
+
+    out.insert(out.end(), i, left.end());
+  } else {
+    std::set_difference(left.begin(), left.end(), right.begin(), right.end(),
+                        std::back_inserter(out), comp);
+  }
+
+  return orderedSetResult(a, out);
+}
+
+#endif // ORDERED_SET_OPERATIONS_CPP
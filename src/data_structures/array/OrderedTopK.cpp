@@ -0,0 +1,45 @@
+#ifndef ORDERED_TOP_K_CPP
+#define ORDERED_TOP_K_CPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "../../sortings/Selection.cpp"
+#include "OrderedArray.cpp"
+
+/**
+ * OrderedArray of the `k` elements of [first, last) that come first under
+ * `comp`, built in one streaming pass through a TopK accumulator: the input
+ * can be a single-pass range of any length and only k elements are stored.
+ * The kept elements arrive sorted, so the array takes them without
+ * re-sorting.
+ *
+ * @complexity O(n log k), O(n + k log k) for random input
+ */
+template <typename InputIt, typename Compare>
+OrderedArray<typename std::iterator_traits<InputIt>::value_type, Compare>
+orderedTopK(InputIt first, InputIt last, size_t k, const Compare &comp) {
+  using T = typename std::iterator_traits<InputIt>::value_type;
+
+  TopK<T, Compare> top(k, comp);
+  top.pushRange(first, last);
+  std::vector<T> elements = top.take();
+
+  OrderedArray<T, Compare> result(comp);
+  result.insertRange(std::make_move_iterator(elements.begin()),
+                     std::make_move_iterator(elements.end()));
+
+  return result;
+}
+
+template <typename InputIt>
+OrderedArray<typename std::iterator_traits<InputIt>::value_type>
+orderedTopK(InputIt first, InputIt last, size_t k) {
+  return orderedTopK(
+      first, last, k,
+      std::less<typename std::iterator_traits<InputIt>::value_type>());
+}
+
+#endif // ORDERED_TOP_K_CPP
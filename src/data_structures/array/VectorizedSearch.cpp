@@ -0,0 +1,364 @@
+#ifndef VECTORIZED_SEARCH_CPP
+#define VECTORIZED_SEARCH_CPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "../../utils/BitScan.cpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+/**
+ * VectorizedEqual
+ *
+ * Compares a block of `lanes` consecutive elements against one value and
+ * returns a bitmask with bit i set when block[i] == value. The primary
+ * template is the scalar fallback (one lane); arithmetic types with 4- or
+ * 8-byte elements get SSE2 or AVX2 specializations, picked at compile time
+ * from the target flags.
+ *
+ * Floating-point lanes use ordered comparisons, so the results match
+ * operator==: NaN never matches and -0.0 matches 0.0.
+ */
+template <typename T, typename Enable = void> struct VectorizedEqual {
+  static constexpr size_t lanes = 1;
+
+  const T &value;
+
+  explicit VectorizedEqual(const T &value) : value(value) {}
+
+  uint32_t mask(const T *block) const { return *block == value ? 1 : 0; }
+};
+
+template <typename T, size_t Size>
+using EnableIfIntegral = std::enable_if_t<std::is_integral<T>::value &&
+                                          !std::is_same<T, bool>::value &&
+                                          sizeof(T) == Size>;
+
+#if defined(__AVX2__)
+
+template <typename T> struct VectorizedEqual<T, EnableIfIntegral<T, 4>> {
+  static constexpr size_t lanes = 8;
+
+  __m256i needle;
+
+  explicit VectorizedEqual(T value)
+      : needle(_mm256_set1_epi32(static_cast<int32_t>(value))) {}
+
+  uint32_t mask(const T *block) const {
+    __m256i items =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+
+    return _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpeq_epi32(items, needle)));
+  }
+};
+
+template <typename T> struct VectorizedEqual<T, EnableIfIntegral<T, 8>> {
+  static constexpr size_t lanes = 4;
+
+  __m256i needle;
+
+  explicit VectorizedEqual(T value)
+      : needle(_mm256_set1_epi64x(static_cast<int64_t>(value))) {}
+
+  uint32_t mask(const T *block) const {
+    __m256i items =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+
+    return _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpeq_epi64(items, needle)));
+  }
+};
+
+template <> struct VectorizedEqual<float> {
+  static constexpr size_t lanes = 8;
+
+  __m256 needle;
+
+  explicit VectorizedEqual(float value) : needle(_mm256_set1_ps(value)) {}
+
+  uint32_t mask(const float *block) const {
+    return _mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(block), needle, _CMP_EQ_OQ));
+  }
+};
+
+template <> struct VectorizedEqual<double> {
+  static constexpr size_t lanes = 4;
+
+  __m256d needle;
+
+  explicit VectorizedEqual(double value) : needle(_mm256_set1_pd(value)) {}
+
+  uint32_t mask(const double *block) const {
+    return _mm256_movemask_pd(
+        _mm256_cmp_pd(_mm256_loadu_pd(block), needle, _CMP_EQ_OQ));
+  }
+};
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+template <typename T> struct VectorizedEqual<T, EnableIfIntegral<T, 4>> {
+  static constexpr size_t lanes = 4;
+
+  __m128i needle;
+
+  explicit VectorizedEqual(T value)
+      : needle(_mm_set1_epi32(static_cast<int32_t>(value))) {}
+
+  uint32_t mask(const T *block) const {
+    __m128i items = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(items, needle)));
+  }
+};
+
+template <typename T> struct VectorizedEqual<T, EnableIfIntegral<T, 8>> {
+  static constexpr size_t lanes = 2;
+
+  __m128i needle;
+
+  explicit VectorizedEqual(T value)
+      : needle(_mm_set1_epi64x(static_cast<int64_t>(value))) {}
+
+  uint32_t mask(const T *block) const {
+    __m128i items = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+    // SSE2 has no 64-bit compare: both 32-bit halves have to match.
+    __m128i halves = _mm_cmpeq_epi32(items, needle);
+    __m128i swapped = _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128i both = _mm_and_si128(halves, swapped);
+
+    return _mm_movemask_pd(_mm_castsi128_pd(both));
+  }
+};
+
+template <> struct VectorizedEqual<float> {
+  static constexpr size_t lanes = 4;
+
+  __m128 needle;
+
+  explicit VectorizedEqual(float value) : needle(_mm_set1_ps(value)) {}
+
+  uint32_t mask(const float *block) const {
+    return _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(block), needle));
+  }
+};
+
+template <> struct VectorizedEqual<double> {
+  static constexpr size_t lanes = 2;
+
+  __m128d needle;
+
+  explicit VectorizedEqual(double value) : needle(_mm_set1_pd(value)) {}
+
+  uint32_t mask(const double *block) const {
+    return _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(block), needle));
+  }
+};
+
+#endif
+
+/**
+ * Index of the first element equal to `value`, or `size` if there is none.
+ *
+ * @complexity
+ * - Worst: O(n)
+ * - Average: O(n)
+ * - Best: O(1)
+ */
+template <typename T>
+size_t vectorizedFind(const T *data, size_t size, const T &value) {
+  using Equal = VectorizedEqual<T>;
+  const Equal equal(value);
+  size_t i = 0;
+
+  for (; i + Equal::lanes <= size; i += Equal::lanes) {
+    uint32_t mask = equal.mask(data + i);
+
+    if (mask != 0) {
+      return i + countTrailingZeros(mask);
+    }
+  }
+
+  for (; i < size; ++i) {
+    if (data[i] == value) {
+      return i;
+    }
+  }
+
+  return size;
+}
+
+/**
+ * Number of elements equal to `value`.
+ *
+ * @complexity O(n)
+ */
+template <typename T>
+size_t vectorizedCount(const T *data, size_t size, const T &value) {
+  using Equal = VectorizedEqual<T>;
+  const Equal equal(value);
+  size_t count = 0;
+  size_t i = 0;
+
+  for (; i + Equal::lanes <= size; i += Equal::lanes) {
+    count += popCount(equal.mask(data + i));
+  }
+
+  for (; i < size; ++i) {
+    count += data[i] == value;
+  }
+
+  return count;
+}
+
+/**
+ * Append the index of every element equal to `value` to `indices`.
+ *
+ * @complexity O(n)
+ */
+template <typename T>
+void vectorizedFindAll(const T *data, size_t size, const T &value,
+                       std::vector<size_t> &indices) {
+  using Equal = VectorizedEqual<T>;
+  const Equal equal(value);
+  size_t i = 0;
+
+  for (; i + Equal::lanes <= size; i += Equal::lanes) {
+    for (uint32_t mask = equal.mask(data + i); mask != 0; mask &= mask - 1) {
+      indices.push_back(i + countTrailingZeros(mask));
+    }
+  }
+
+  for (; i < size; ++i) {
+    if (data[i] == value) {
+      indices.push_back(i);
+    }
+  }
+}
+
+/**
+ * Index of the first element satisfying `predicate`, or `size` if there is
+ * none.
+ *
+ * The predicate is evaluated for a whole block of 64 elements without
+ * branching and packed into a bitmask, which lets the compiler vectorize
+ * simple predicates such as `x > limit`. It must therefore be cheap and free
+ * of side effects; it may run on elements past the first match.
+ *
+ * @complexity
+ * - Worst: O(n)
+ * - Average: O(n)
+ * - Best: O(1)
+ */
+template <typename T, typename Predicate>
+size_t vectorizedFindIf(const T *data, size_t size, Predicate predicate) {
+  constexpr size_t block = 64;
+  size_t i = 0;
+
+  for (; i + block <= size; i += block) {
+    uint64_t mask = 0;
+
+    for (size_t j = 0; j < block; ++j) {
+      mask |= static_cast<uint64_t>(predicate(data[i + j]) ? 1 : 0) << j;
+    }
+
+    if (mask != 0) {
+      return i + countTrailingZeros(mask);
+    }
+  }
+
+  for (; i < size; ++i) {
+    if (predicate(data[i])) {
+      return i;
+    }
+  }
+
+  return size;
+}
+
+/**
+ * Whether every element is strictly less than the next one.
+ *
+ * Scans without an early exit so that the loop vectorizes.
+ *
+ * @complexity O(n)
+ */
+template <typename T>
+bool vectorizedStrictlyIncreasing(const T *data, size_t size) {
+  bool ordered = true;
+
+  for (size_t i = 1; i < size; ++i) {
+    ordered &= data[i - 1] < data[i];
+  }
+
+  return ordered;
+}
+
+/**
+ * Write the elements common to the strictly increasing ranges `a` and `b`
+ * to `out`, which must have room for min(aSize, bSize) elements.
+ *
+ * For 4-byte integers with SSE2, blocks of four elements from each side
+ * are compared all-against-all with three lane rotations, the matches are
+ * extracted from a bitmask, and the block with the smaller maximum is
+ * advanced. Other types, and the tails, take a scalar merge.
+ *
+ * @complexity O(n + m)
+ * @return the number of elements written.
+ */
+template <typename T>
+size_t vectorizedIntersect(const T *a, size_t aSize, const T *b, size_t bSize,
+                           T *out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t count = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+  if constexpr (std::is_integral<T>::value && sizeof(T) == 4) {
+    while (i + 4 <= aSize && j + 4 <= bSize) {
+      __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+      __m128i right =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+      __m128i equal = _mm_cmpeq_epi32(left, right);
+      equal = _mm_or_si128(
+          equal, _mm_cmpeq_epi32(left, _mm_shuffle_epi32(right, 0x39)));
+      equal = _mm_or_si128(
+          equal, _mm_cmpeq_epi32(left, _mm_shuffle_epi32(right, 0x4e)));
+      equal = _mm_or_si128(
+          equal, _mm_cmpeq_epi32(left, _mm_shuffle_epi32(right, 0x93)));
+
+      for (uint32_t mask = _mm_movemask_ps(_mm_castsi128_ps(equal)); mask != 0;
+           mask &= mask - 1) {
+        out[count++] = a[i + countTrailingZeros(mask)];
+      }
+
+      T leftLast = a[i + 3];
+      T rightLast = b[j + 3];
+      i += leftLast <= rightLast ? 4 : 0;
+      j += rightLast <= leftLast ? 4 : 0;
+    }
+  }
+#endif
+
+  while (i < aSize && j < bSize) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      out[count++] = a[i];
+      ++i;
+      ++j;
+    }
+  }
+
+  return count;
+}
+
+#endif // VECTORIZED_SEARCH_CPP
@@ -0,0 +1,213 @@
+#ifndef ARGSORT_CPP
+#define ARGSORT_CPP
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "PdqSort.cpp"
+#include "RadixSort.cpp"
+
+// argsortByKey orders integral keys with radixSort from this many elements
+// on; below it the histogram passes cost more than they save.
+constexpr std::ptrdiff_t argsortRadixThreshold = 256;
+
+/**
+ * A key copied out of its element, with the element's original index.
+ */
+template <typename Key> struct ArgsortEntry {
+  Key key;
+  size_t index;
+};
+
+/**
+ * Whether argsortByKey can order keys with radixSort: integral keys in
+ * ascending std::less order, where the LSD passes keep ties in index order
+ * just like the comparison sort does.
+ */
+template <typename Key, typename Compare>
+constexpr bool argsortRadixApplies =
+    std::is_integral<Key>::value && !std::is_same<Key, bool>::value &&
+    (std::is_same<Compare, std::less<Key>>::value ||
+     std::is_same<Compare, std::less<>>::value);
+
+/**
+ * Argsort
+ *
+ * Returns the permutation that sorts [first, last): order[i] is the
+ * original index of the element that belongs at position i. The range is
+ * not modified, so one order can be reused for parallel arrays or applied
+ * with applyPermutation.
+ *
+ * Only indices move during the sort; each comparison reads two elements
+ * through their indices. Prefer argsortByKey when the ordering depends on
+ * a small key, which is then read once instead of on every comparison.
+ *
+ * Stable: equivalent elements keep their relative order.
+ *
+ * @complexity
+ * - Worst: O(n log n)
+ * - Average: O(n log n)
+ * - Best: O(n) (If the range is already sorted)
+ */
+template <typename RandomIt, typename Compare>
+std::vector<size_t> argsort(RandomIt first, RandomIt last, Compare comp) {
+  std::vector<size_t> order(static_cast<size_t>(last - first));
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+
+  pdqSort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return comp(first[a], first[b]) || (!comp(first[b], first[a]) && a < b);
+  });
+
+  return order;
+}
+
+template <typename RandomIt>
+std::vector<size_t> argsort(RandomIt first, RandomIt last) {
+  return argsort(first, last, std::less<>());
+}
+
+/**
+ * Argsort by key
+ *
+ * Like argsort, but orders the elements by `keyOf(element)` under `comp`.
+ * Every key is copied once into a dense array of (key, index) entries and
+ * only that array is sorted, so a 200-byte record with an 8-byte key costs
+ * 16 bytes of sort traffic instead of 200. Integral keys in ascending order
+ * are sorted with radixSort from argsortRadixThreshold elements on.
+ *
+ * Stable.
+ *
+ * @complexity
+ * - Worst: O(n log n) (O(w * n) for w-byte integral keys)
+ * - Average: O(n log n)
+ * - Best: O(n) (If the keys are already sorted)
+ */
+template <typename RandomIt, typename KeyOf, typename Compare>
+std::vector<size_t> argsortByKey(RandomIt first, RandomIt last, KeyOf keyOf,
+                                 Compare comp) {
+  using Key = std::decay_t<decltype(keyOf(*first))>;
+
+  size_t size = static_cast<size_t>(last - first);
+  std::vector<ArgsortEntry<Key>> entries;
+  entries.reserve(size);
+
+  for (size_t i = 0; i < size; ++i) {
+    entries.push_back({keyOf(first[i]), i});
+  }
+
+  if constexpr (argsortRadixApplies<Key, Compare>) {
+    if (static_cast<std::ptrdiff_t>(size) >= argsortRadixThreshold) {
+      radixSort(entries.begin(), entries.end(),
+                [](const ArgsortEntry<Key> &entry) { return entry.key; });
+    } else {
+      pdqSort(entries.begin(), entries.end(),
+              [](const ArgsortEntry<Key> &a, const ArgsortEntry<Key> &b) {
+                return a.key < b.key || (a.key == b.key && a.index < b.index);
+              });
+    }
+  } else {
+    pdqSort(entries.begin(), entries.end(),
+            [&](const ArgsortEntry<Key> &a, const ArgsortEntry<Key> &b) {
+              return comp(a.key, b.key) ||
+                     (!comp(b.key, a.key) && a.index < b.index);
+            });
+  }
+
+  std::vector<size_t> order(size);
+
+  for (size_t i = 0; i < size; ++i) {
+    order[i] = entries[i].index;
+  }
+
+  return order;
+}
+
+template <typename RandomIt, typename KeyOf>
+std::vector<size_t> argsortByKey(RandomIt first, RandomIt last, KeyOf keyOf) {
+  return argsortByKey(first, last, keyOf, std::less<>());
+}
+
+/**
+ * Rearrange [first, last) in place so that position i receives the element
+ * that was at `order[i]`, as returned by argsort.
+ *
+ * The permutation is applied cycle by cycle: every element is moved exactly
+ * once, plus one temporary per cycle, whatever its size. A bitmap of n bits
+ * tracks the positions already filled.
+ *
+ * Throws std::invalid_argument if `order` is not a permutation of the
+ * range's indices; the range then holds its elements in an unspecified
+ * order.
+ *
+ * @complexity O(n)
+ */
+template <typename RandomIt>
+void applyPermutation(RandomIt first, RandomIt last,
+                      const std::vector<size_t> &order) {
+  size_t size = static_cast<size_t>(last - first);
+
+  if (order.size() != size) {
+    throw std::invalid_argument("Permutation size does not match the range");
+  }
+
+  std::vector<bool> placed(size);
+
+  for (size_t start = 0; start < size; ++start) {
+    if (placed[start] || order[start] == start) {
+      continue;
+    }
+
+    auto value = std::move(first[start]);
+    size_t hole = start;
+
+    while (order[hole] != start) {
+      size_t source = order[hole];
+
+      if (source >= size || placed[source] || source == hole) {
+        first[hole] = std::move(value);
+        throw std::invalid_argument("Not a permutation");
+      }
+
+      first[hole] = std::move(first[source]);
+      placed[hole] = true;
+      hole = source;
+    }
+
+    first[hole] = std::move(value);
+    placed[hole] = true;
+  }
+}
+
+/**
+ * Sort by key, permuting the payload once
+ *
+ * Sorts [first, last) by `keyOf(element)`: the keys are argsorted in a dense
+ * array (see argsortByKey) and the elements are then moved into place in a
+ * single pass with applyPermutation. A comparison sort of heavy records
+ * moves each one O(log n) times; here each moves once.
+ *
+ * Stable. Uses O(n) extra memory for the keys and the permutation.
+ *
+ * @complexity
+ * - Worst: O(n log n)
+ * - Average: O(n log n)
+ * - Best: O(n) (If the keys are already sorted)
+ */
+template <typename RandomIt, typename KeyOf, typename Compare>
+void sortByKey(RandomIt first, RandomIt last, KeyOf keyOf, Compare comp) {
+  applyPermutation(first, last, argsortByKey(first, last, keyOf, comp));
+}
+
+template <typename RandomIt, typename KeyOf>
+void sortByKey(RandomIt first, RandomIt last, KeyOf keyOf) {
+  sortByKey(first, last, keyOf, std::less<>());
+}
+
+#endif // ARGSORT_CPP
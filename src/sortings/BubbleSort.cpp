@@ -2,7 +2,14 @@
 #include <utility>
 #include <vector>
 
-void bubbleSort(std::vector<int> &arr) {
+#include "../utils/OperationStats.cpp"
+
+/**
+ * Bubble sort reporting comparisons and element moves (three per swap) to
+ * a stats policy (see OperationStats.cpp).
+ */
+template <typename Stats>
+void bubbleSort(std::vector<int> &arr, const Stats &stats) {
   if (arr.empty()) {
     return;
   }
@@ -14,8 +21,11 @@ void bubbleSort(std::vector<int> &arr) {
     sorted = true;
 
     for (size_t i = 0; i < unsortedUntilIndex; ++i) {
+      stats.addComparisons(1);
+
       if (arr[i] > arr[i + 1]) {
         std::swap(arr[i], arr[i + 1]);
+        stats.addMoves(3);
         sorted = false;
       }
     }
@@ -23,3 +33,5 @@ void bubbleSort(std::vector<int> &arr) {
     --unsortedUntilIndex;
   }
 }
+
+void bubbleSort(std::vector<int> &arr) { bubbleSort(arr, NoStats()); }
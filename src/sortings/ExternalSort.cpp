@@ -0,0 +1,798 @@
+#ifndef EXTERNAL_SORT_CPP
+#define EXTERNAL_SORT_CPP
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../concurrency/ThreadPool.cpp"
+#include "ParallelSort.cpp"
+#include "PdqSort.cpp"
+
+enum class ExternalSortPhase { Runs, Merge };
+
+/**
+ * Snapshot passed to the progress callback: elements handled so far in the
+ * current phase, out of `totalElements` (0 while the total is unknown).
+ */
+struct ExternalSortProgress {
+  ExternalSortPhase phase;
+  uint64_t elements;
+  uint64_t totalElements;
+  size_t runs;
+};
+
+struct ExternalSortOptions {
+  // Memory for the in-memory chunks, split between the chunk being filled
+  // and the one being sorted and written; the merge gets the same budget
+  // for its read buffers.
+  size_t memoryBytes = size_t(1) << 30;
+  // Size of each read and write block. Every run being merged holds two.
+  size_t bufferBytes = size_t(1) << 20;
+  // Directory for the run files; empty means $TMPDIR or /tmp.
+  std::string temporaryDirectory;
+  // Sorts chunks with parallelSort when set (which needs another chunk of
+  // memory), pdqSort otherwise.
+  ThreadPool *pool = nullptr;
+  // Called after every chunk and every merged block.
+  std::function<void(const ExternalSortProgress &)> progress;
+};
+
+/**
+ * Write `bytes` bytes to `fd` at `offset`, retrying short writes.
+ *
+ * @complexity O(bytes)
+ */
+inline void externalWriteAt(int fd, const void *data, size_t bytes,
+                            uint64_t offset) {
+  const char *from = static_cast<const char *>(data);
+
+  while (bytes > 0) {
+    ssize_t written =
+        ::pwrite(fd, from, bytes, static_cast<off_t>(offset));
+
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (written <= 0) {
+      throw std::runtime_error("Cannot write sort run");
+    }
+
+    from += written;
+    bytes -= static_cast<size_t>(written);
+    offset += static_cast<uint64_t>(written);
+  }
+}
+
+/**
+ * Read up to `bytes` bytes from `fd` at `offset`.
+ *
+ * @complexity O(bytes)
+ * @return the number of bytes read, short only at the end of the file.
+ */
+inline size_t externalReadAt(int fd, void *data, size_t bytes,
+                             uint64_t offset) {
+  char *to = static_cast<char *>(data);
+  size_t total = 0;
+
+  while (total < bytes) {
+    ssize_t got = ::pread(fd, to + total, bytes - total,
+                          static_cast<off_t>(offset + total));
+
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (got < 0) {
+      throw std::runtime_error("Cannot read sort run");
+    }
+
+    if (got == 0) {
+      break;
+    }
+
+    total += static_cast<size_t>(got);
+  }
+
+  return total;
+}
+
+/**
+ * Anonymous temporary file: created with mkstemp and unlinked at once, so
+ * its space is freed when it is closed, even if the process dies.
+ */
+class ExternalTemporaryFile {
+private:
+  int fd;
+
+public:
+  explicit ExternalTemporaryFile(std::string directory) {
+    if (directory.empty()) {
+      const char *fromEnvironment = std::getenv("TMPDIR");
+      directory = fromEnvironment != nullptr ? fromEnvironment : "/tmp";
+    }
+
+    std::string name = directory + "/externalSortXXXXXX";
+    fd = mkstemp(&name[0]);
+
+    if (fd < 0) {
+      throw std::runtime_error("Cannot create a temporary file in " +
+                               directory);
+    }
+
+    unlink(name.c_str());
+  }
+
+  ExternalTemporaryFile(const ExternalTemporaryFile &) = delete;
+  ExternalTemporaryFile &operator=(const ExternalTemporaryFile &) = delete;
+
+  ~ExternalTemporaryFile() { close(fd); }
+
+  int get() const { return fd; }
+};
+
+/**
+ * One long-lived thread running the blocking reads or writes of a reader
+ * or writer, one job at a time, so that a large sort does not start a
+ * thread per block.
+ */
+class ExternalIoThread {
+private:
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::function<void()> job;
+  bool busy = false;
+  bool stopping = false;
+  std::exception_ptr error;
+  // Last, so that the state above exists while it runs.
+  std::thread thread;
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+      changed.wait(lock, [this] { return job || stopping; });
+
+      if (!job) {
+        return;
+      }
+
+      std::function<void()> current = std::move(job);
+      job = nullptr;
+      lock.unlock();
+
+      std::exception_ptr failure;
+
+      try {
+        current();
+      } catch (...) {
+        failure = std::current_exception();
+      }
+
+      lock.lock();
+      error = failure;
+      busy = false;
+      changed.notify_all();
+    }
+  }
+
+public:
+  ExternalIoThread() : thread([this] { run(); }) {}
+
+  ExternalIoThread(const ExternalIoThread &) = delete;
+  ExternalIoThread &operator=(const ExternalIoThread &) = delete;
+
+  /**
+   * Finish the pending job, dropping its error, and stop the thread.
+   */
+  ~ExternalIoThread() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+
+    changed.notify_all();
+    thread.join();
+  }
+
+  /**
+   * Wait for the previous job, then start `work`.
+   *
+   * @complexity O(1) plus waiting for the previous job
+   */
+  void submit(std::function<void()> work) {
+    wait();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    job = std::move(work);
+    busy = true;
+    changed.notify_all();
+  }
+
+  /**
+   * Wait for the pending job and rethrow its exception, if any.
+   *
+   * @complexity O(1) plus waiting for the job
+   */
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return !busy; });
+
+    if (error) {
+      std::exception_ptr failure = error;
+      error = nullptr;
+      std::rethrow_exception(failure);
+    }
+  }
+};
+
+/**
+ * A sorted run: `count` elements from element `offset` of the run file.
+ */
+struct ExternalRun {
+  uint64_t offset;
+  uint64_t count;
+};
+
+/**
+ * Sequential reader over `count` elements of a file from element `offset`,
+ * double buffered: the next block is read on the reader's I/O thread while
+ * the current one is consumed.
+ */
+template <typename T> class ExternalRunReader {
+private:
+  int fd;
+  uint64_t nextOffset;
+  uint64_t remaining;
+  size_t blockElements;
+  std::vector<T> current;
+  std::vector<T> prefetched;
+  size_t position = 0;
+  bool pending = false;
+  // Last, so that it is destroyed (waiting for the read) first.
+  std::unique_ptr<ExternalIoThread> io;
+
+  /**
+   * Start reading the next block into `prefetched`.
+   *
+   * @complexity O(1)
+   */
+  void prefetch() {
+    if (remaining == 0) {
+      return;
+    }
+
+    size_t count =
+        static_cast<size_t>(std::min<uint64_t>(blockElements, remaining));
+    prefetched.resize(count);
+    uint64_t offset = nextOffset * sizeof(T);
+    int file = fd;
+    T *to = prefetched.data();
+
+    io->submit([file, to, count, offset] {
+      if (externalReadAt(file, to, count * sizeof(T), offset) !=
+          count * sizeof(T)) {
+        throw std::runtime_error("Sort run is truncated");
+      }
+    });
+
+    pending = true;
+    nextOffset += count;
+    remaining -= count;
+  }
+
+  /**
+   * Switch to the prefetched block and start reading the one after it.
+   *
+   * @complexity O(1) plus waiting for the read
+   */
+  void refill() {
+    current.clear();
+    position = 0;
+
+    if (pending) {
+      pending = false;
+      io->wait();
+      std::swap(current, prefetched);
+      prefetch();
+    }
+  }
+
+public:
+  ExternalRunReader(int fd, uint64_t offset, uint64_t count,
+                    size_t blockElements)
+      : fd(fd), nextOffset(offset), remaining(count),
+        blockElements(blockElements),
+        io(std::make_unique<ExternalIoThread>()) {
+    prefetch();
+    refill();
+  }
+
+  bool exhausted() const { return position == current.size(); }
+
+  const T &head() const { return current[position]; }
+
+  void next() {
+    if (++position == current.size()) {
+      refill();
+    }
+  }
+};
+
+/**
+ * Sequential writer from element `offset` of a file, double buffered: a
+ * full block is written on the writer's I/O thread while the next one
+ * fills.
+ */
+template <typename T> class ExternalBlockWriter {
+private:
+  int fd;
+  uint64_t offset;
+  size_t blockElements;
+  std::vector<T> filling;
+  std::vector<T> writing;
+  // Last, so that it is destroyed (waiting for the write) first.
+  std::unique_ptr<ExternalIoThread> io;
+
+  void flushBlock() {
+    io->wait();
+    std::swap(filling, writing);
+    filling.clear();
+    filling.reserve(blockElements);
+
+    int file = fd;
+    const T *from = writing.data();
+    size_t bytes = writing.size() * sizeof(T);
+    uint64_t at = offset * sizeof(T);
+    io->submit(
+        [file, from, bytes, at] { externalWriteAt(file, from, bytes, at); });
+    offset += writing.size();
+  }
+
+public:
+  ExternalBlockWriter(int fd, uint64_t offset, size_t blockElements)
+      : fd(fd), offset(offset), blockElements(blockElements),
+        io(std::make_unique<ExternalIoThread>()) {
+    filling.reserve(blockElements);
+  }
+
+  /**
+   * Append one element, handing the block off once it is full.
+   *
+   * @complexity O(1) amortized
+   */
+  void write(const T &value) {
+    filling.push_back(value);
+
+    if (filling.size() == blockElements) {
+      flushBlock();
+    }
+  }
+
+  /**
+   * Write the partial block and wait for every write to finish.
+   *
+   * @complexity O(B)
+   */
+  void finish() {
+    if (!filling.empty()) {
+      flushBlock();
+    }
+
+    io->wait();
+  }
+};
+
+/**
+ * Tournament tree of losers over k sources. The root holds the source
+ * whose head goes first; after that source advances, replay() restores
+ * the tree with one comparison per level, log2(k) in total, against the
+ * two per level of a binary heap.
+ *
+ * `beats(a, b)` tells whether the head of source a goes before that of
+ * source b, treating exhausted sources as larger than everything.
+ */
+template <typename Beats> class LoserTree {
+private:
+  size_t count;
+  // tree[0] is the winner, tree[1..count-1] the loser of each match.
+  std::vector<size_t> tree;
+  Beats beats;
+
+  size_t build(size_t node) {
+    if (node >= count) {
+      return node - count;
+    }
+
+    size_t left = build(2 * node);
+    size_t right = build(2 * node + 1);
+
+    if (beats(right, left)) {
+      std::swap(left, right);
+    }
+
+    tree[node] = right;
+    return left;
+  }
+
+public:
+  LoserTree(size_t count, Beats beats)
+      : count(count), tree(std::max<size_t>(count, 1)), beats(beats) {
+    tree[0] = count > 1 ? build(1) : 0;
+  }
+
+  size_t winner() const { return tree[0]; }
+
+  /**
+   * Re-run the matches on the path of the winner after its head changed.
+   *
+   * @complexity O(log k)
+   */
+  void replay() {
+    size_t current = tree[0];
+
+    for (size_t node = (current + count) / 2; node > 0; node /= 2) {
+      if (beats(tree[node], current)) {
+        std::swap(tree[node], current);
+      }
+    }
+
+    tree[0] = current;
+  }
+};
+
+/**
+ * ExternalSorter
+ *
+ * Sorts more elements than fit in memory, fed one at a time with push():
+ *
+ * 1. **Runs**: elements fill a chunk of memoryBytes / 2. A full chunk is
+ *    sorted with the in-memory engine and appended to one unlinked
+ *    temporary run file on a background thread, while the next chunk
+ *    fills.
+ * 2. **Merge**: finish() merges the runs through a loser tree, reading
+ *    each run in double-buffered blocks so that disk reads overlap the
+ *    merge. More runs than the read buffers fit are first merged in groups
+ *    into longer runs, appended to the same file, so such a pass needs
+ *    disk space for another copy of the data.
+ *
+ * Input that fits in one chunk never touches the disk. T must be trivially
+ * copyable, since runs are raw bytes. Not stable.
+ */
+template <typename T, typename Compare = std::less<T>> class ExternalSorter {
+private:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "External sort writes elements as raw bytes");
+
+  ExternalSortOptions options;
+  Compare comp;
+  size_t chunkElements;
+  size_t blockElements;
+  size_t fanIn;
+  uint64_t pushed = 0;
+  uint64_t expected = 0;
+  std::unique_ptr<ExternalTemporaryFile> runFile;
+  uint64_t runFileSize = 0;
+  std::vector<ExternalRun> runs;
+  std::vector<T> filling;
+  std::vector<T> sorting;
+  // Last, so that it is destroyed (waiting for the spill) first.
+  std::future<void> spilling;
+
+  void report(ExternalSortPhase phase, uint64_t elements,
+              uint64_t total) const {
+    if (options.progress) {
+      options.progress(ExternalSortProgress{phase, elements, total,
+                                            runs.size()});
+    }
+  }
+
+  template <typename RandomIt> void sortChunk(RandomIt first, RandomIt last) {
+    if (options.pool != nullptr) {
+      parallelSort(first, last, comp, *options.pool);
+    } else {
+      pdqSort(first, last, comp);
+    }
+  }
+
+  void waitForSpill() {
+    if (spilling.valid()) {
+      spilling.get();
+    }
+  }
+
+  /**
+   * Sort the full chunk and write it as a new run in the background.
+   *
+   * @complexity O(C log C)
+   */
+  void spill() {
+    waitForSpill();
+    std::swap(filling, sorting);
+    filling.clear();
+    filling.reserve(chunkElements);
+
+    if (!runFile) {
+      runFile =
+          std::make_unique<ExternalTemporaryFile>(options.temporaryDirectory);
+    }
+
+    uint64_t offset = runFileSize;
+    runs.push_back(ExternalRun{offset, sorting.size()});
+    runFileSize += sorting.size();
+
+    spilling = std::async(std::launch::async, [this, offset] {
+      sortChunk(sorting.begin(), sorting.end());
+      externalWriteAt(runFile->get(), sorting.data(),
+                      sorting.size() * sizeof(T), offset * sizeof(T));
+    });
+
+    report(ExternalSortPhase::Runs, pushed, expected);
+  }
+
+  /**
+   * Merge runs [first, last) of `runs`, passing every element in order to
+   * `consume`.
+   *
+   * @complexity O(n log k)
+   */
+  template <typename Consumer>
+  void mergeRuns(size_t first, size_t last, Consumer consume) {
+    std::vector<ExternalRunReader<T>> readers;
+    readers.reserve(last - first);
+
+    for (size_t r = first; r < last; ++r) {
+      readers.emplace_back(runFile->get(), runs[r].offset, runs[r].count,
+                           blockElements);
+    }
+
+    auto beats = [this, &readers](size_t a, size_t b) {
+      return !readers[a].exhausted() &&
+             (readers[b].exhausted() ||
+              !comp(readers[b].head(), readers[a].head()));
+    };
+    LoserTree<decltype(beats)> tree(readers.size(), beats);
+
+    while (!readers[tree.winner()].exhausted()) {
+      ExternalRunReader<T> &reader = readers[tree.winner()];
+      consume(reader.head());
+      reader.next();
+      tree.replay();
+    }
+  }
+
+public:
+  /**
+   * Empty sorter with the given memory budget and order.
+   *
+   * @complexity O(1)
+   */
+  explicit ExternalSorter(const ExternalSortOptions &options = {},
+                          const Compare &comp = Compare())
+      : options(options), comp(comp),
+        chunkElements(std::max<size_t>(1, options.memoryBytes / 2 / sizeof(T))),
+        blockElements(std::max<size_t>(1, options.bufferBytes / sizeof(T))),
+        // Each run being merged holds two blocks; keep two for the output.
+        fanIn(std::max<size_t>(3, options.memoryBytes /
+                                      (2 * options.bufferBytes)) -
+              1) {
+    filling.reserve(std::min<size_t>(chunkElements, 1 << 16));
+  }
+
+  ExternalSorter(const ExternalSorter &) = delete;
+  ExternalSorter &operator=(const ExternalSorter &) = delete;
+
+  /**
+   * Announce the total element count, only used for progress reports.
+   *
+   * @complexity O(1)
+   */
+  void setExpectedSize(uint64_t count) { expected = count; }
+
+  /**
+   * Add one element.
+   *
+   * @complexity O(1) amortized, plus O(C log C) per full chunk
+   */
+  void push(const T &value) {
+    filling.push_back(value);
+    ++pushed;
+
+    if (filling.size() == chunkElements) {
+      spill();
+    }
+  }
+
+  /**
+   * Add every element of [first, last).
+   *
+   * @complexity O(k) amortized, plus O(C log C) per full chunk
+   */
+  template <typename InputIt> void pushRange(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      push(*first);
+    }
+  }
+
+  /**
+   * Pass every pushed element, in order, to `consume(const T &)`, then
+   * reset the sorter.
+   *
+   * @complexity O(n log n) CPU, O(n) I/O per merge pass
+   */
+  template <typename Consumer> void finish(Consumer consume) {
+    uint64_t total = pushed;
+    uint64_t done = 0;
+
+    if (runs.empty()) {
+      sortChunk(filling.begin(), filling.end());
+
+      for (const T &value : filling) {
+        consume(value);
+      }
+
+      report(ExternalSortPhase::Merge, total, total);
+      filling.clear();
+      pushed = 0;
+      return;
+    }
+
+    if (!filling.empty()) {
+      spill();
+    }
+
+    waitForSpill();
+    std::vector<T>().swap(filling);
+    std::vector<T>().swap(sorting);
+
+    // Merge the oldest runs into longer ones until one pass can take all.
+    while (runs.size() > fanIn) {
+      ExternalRun merged{runFileSize, 0};
+      ExternalBlockWriter<T> writer(runFile->get(), merged.offset,
+                                    blockElements);
+
+      mergeRuns(0, fanIn, [&](const T &value) {
+        writer.write(value);
+        ++merged.count;
+      });
+      writer.finish();
+
+      runFileSize += merged.count;
+      runs.erase(runs.begin(), runs.begin() + fanIn);
+      runs.push_back(merged);
+    }
+
+    mergeRuns(0, runs.size(), [&](const T &value) {
+      consume(value);
+
+      if (++done % blockElements == 0) {
+        report(ExternalSortPhase::Merge, done, total);
+      }
+    });
+
+    report(ExternalSortPhase::Merge, total, total);
+    runs.clear();
+    runFile.reset();
+    runFileSize = 0;
+    pushed = 0;
+  }
+};
+
+/**
+ * External sort from an input range to an output iterator.
+ *
+ * @complexity O(n log n)
+ */
+template <typename InputIt, typename OutputIt, typename Compare>
+OutputIt externalSort(InputIt first, InputIt last, OutputIt out, Compare comp,
+                      const ExternalSortOptions &options = {}) {
+  using Value = typename std::iterator_traits<InputIt>::value_type;
+  ExternalSorter<Value, Compare> sorter(options, comp);
+  sorter.pushRange(first, last);
+  sorter.finish([&out](const Value &value) { *out++ = value; });
+
+  return out;
+}
+
+/**
+ * Sort the file at `input`, a flat sequence of raw T (such as fixed-width
+ * integer records), into `output`. Both files are read and written in
+ * double-buffered blocks.
+ *
+ * The result is written to `output` + ".tmp" and renamed over `output`
+ * once complete, so `output` may be `input`, and a failed sort leaves it
+ * untouched.
+ *
+ * @complexity O(n log n)
+ */
+template <typename T, typename Compare>
+void externalSortFile(const std::string &input, const std::string &output,
+                      Compare comp, const ExternalSortOptions &options = {}) {
+  int in = open(input.c_str(), O_RDONLY);
+
+  if (in < 0) {
+    throw std::runtime_error("Cannot open " + input);
+  }
+
+  struct stat status;
+
+  if (fstat(in, &status) != 0 ||
+      static_cast<uint64_t>(status.st_size) % sizeof(T) != 0) {
+    close(in);
+    throw std::runtime_error(input + " is not a whole number of elements");
+  }
+
+  uint64_t count = static_cast<uint64_t>(status.st_size) / sizeof(T);
+  size_t blockElements = std::max<size_t>(1, options.bufferBytes / sizeof(T));
+
+  std::string temporary = output + ".tmp";
+  int out = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  if (out < 0) {
+    close(in);
+    throw std::runtime_error("Cannot create " + temporary);
+  }
+
+  try {
+    posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+    ExternalSorter<T, Compare> sorter(options, comp);
+    sorter.setExpectedSize(count);
+
+    {
+      ExternalRunReader<T> reader(in, 0, count, blockElements);
+
+      for (; !reader.exhausted(); reader.next()) {
+        sorter.push(reader.head());
+      }
+    }
+
+    ExternalBlockWriter<T> writer(out, 0, blockElements);
+    sorter.finish([&writer](const T &value) { writer.write(value); });
+    writer.finish();
+  } catch (...) {
+    close(in);
+    close(out);
+    std::remove(temporary.c_str());
+    throw;
+  }
+
+  close(in);
+
+  if (close(out) != 0) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("Cannot write " + temporary);
+  }
+
+  if (std::rename(temporary.c_str(), output.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("Cannot replace " + output);
+  }
+}
+
+template <typename T>
+void externalSortFile(const std::string &input, const std::string &output,
+                      const ExternalSortOptions &options = {}) {
+  externalSortFile<T>(input, output, std::less<T>(), options);
+}
+
+#endif // EXTERNAL_SORT_CPP
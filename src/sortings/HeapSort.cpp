@@ -0,0 +1,83 @@
+#ifndef HEAP_SORT_CPP
+#define HEAP_SORT_CPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "../utils/OperationStats.cpp"
+
+/**
+ * Restore the max-heap property below `root` in the implicit heap
+ * [first, first + size).
+ *
+ * @complexity O(log n)
+ */
+template <typename RandomIt, typename Compare>
+constexpr void siftDown(RandomIt first, std::ptrdiff_t root,
+                        std::ptrdiff_t size, Compare comp) {
+  auto value = std::move(first[root]);
+  std::ptrdiff_t hole = root;
+
+  while (2 * hole + 1 < size) {
+    std::ptrdiff_t child = 2 * hole + 1;
+
+    if (child + 1 < size && comp(first[child], first[child + 1])) {
+      ++child;
+    }
+
+    if (!comp(value, first[child])) {
+      break;
+    }
+
+    first[hole] = std::move(first[child]);
+    hole = child;
+  }
+
+  first[hole] = std::move(value);
+}
+
+/**
+ * Heap Sort
+ *
+ * Builds a max-heap in place, then repeatedly swaps the maximum to the end
+ * of the shrinking heap. Not stable and not cache friendly, but O(n log n)
+ * in every case with O(1) extra memory, which is why the quicksort engine
+ * falls back to it when partitioning keeps going badly. Usable in constant
+ * expressions, even in C++17.
+ *
+ * @complexity
+ * - Worst: O(n log n)
+ * - Average: O(n log n)
+ * - Best: O(n log n)
+ */
+template <typename RandomIt, typename Compare>
+constexpr void heapSort(RandomIt first, RandomIt last, Compare comp) {
+  std::ptrdiff_t size = last - first;
+
+  for (std::ptrdiff_t root = size / 2; root > 0; --root) {
+    siftDown(first, root - 1, size, comp);
+  }
+
+  for (std::ptrdiff_t end = size - 1; end > 0; --end) {
+    // Moves instead of std::iter_swap, which is not constexpr before C++20.
+    auto top = std::move(*first);
+    *first = std::move(first[end]);
+    first[end] = std::move(top);
+    siftDown(first, 0, end, comp);
+  }
+}
+
+template <typename RandomIt>
+constexpr void heapSort(RandomIt first, RandomIt last) {
+  heapSort(first, last, std::less<>());
+}
+
+/** Counted heapSort; see CountingCompare for the Stats overloads. */
+template <typename RandomIt, typename Compare, typename Stats>
+void heapSort(RandomIt first, RandomIt last, Compare comp, const Stats &stats) {
+  heapSort(first, last, countingCompare(comp, stats));
+}
+
+#endif // HEAP_SORT_CPP
@@ -0,0 +1,92 @@
+#ifndef INSERTION_SORT_CPP
+#define INSERTION_SORT_CPP
+
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "../utils/OperationStats.cpp"
+
+/**
+ * Insertion Sort
+ *
+ * Grows a sorted prefix one element at a time, shifting larger elements to
+ * the right until the new one fits. Stable, in-place and adaptive: the cost
+ * is proportional to the number of inversions, which makes it the fastest
+ * choice for tiny or nearly sorted ranges and the base case of the
+ * quicksort engine. Usable in constant expressions.
+ *
+ * @complexity
+ * - Worst: O(n^2)
+ * - Average: O(n^2)
+ * - Best: O(n) (If the range is already sorted)
+ */
+template <typename RandomIt, typename Compare>
+constexpr void insertionSort(RandomIt first, RandomIt last, Compare comp) {
+  if (first == last) {
+    return;
+  }
+
+  for (RandomIt current = first + 1; current != last; ++current) {
+    if (!comp(*current, *(current - 1))) {
+      continue;
+    }
+
+    auto value = std::move(*current);
+    RandomIt hole = current;
+
+    do {
+      *hole = std::move(*(hole - 1));
+      --hole;
+    } while (hole != first && comp(value, *(hole - 1)));
+
+    *hole = std::move(value);
+  }
+}
+
+template <typename RandomIt>
+constexpr void insertionSort(RandomIt first, RandomIt last) {
+  insertionSort(first, last, std::less<>());
+}
+
+/** Counted insertionSort; see CountingCompare for the Stats overloads. */
+template <typename RandomIt, typename Compare, typename Stats>
+void insertionSort(RandomIt first, RandomIt last, Compare comp,
+                   const Stats &stats) {
+  insertionSort(first, last, countingCompare(comp, stats));
+}
+
+/**
+ * Insertion sort that assumes an element not greater than any in the range
+ * sits right before `first`, so the inner loop needs no bounds check.
+ *
+ * @complexity
+ * - Worst: O(n^2)
+ * - Average: O(n^2)
+ * - Best: O(n)
+ */
+template <typename RandomIt, typename Compare>
+constexpr void unguardedInsertionSort(RandomIt first, RandomIt last,
+                                      Compare comp) {
+  if (first == last) {
+    return;
+  }
+
+  for (RandomIt current = first + 1; current != last; ++current) {
+    if (!comp(*current, *(current - 1))) {
+      continue;
+    }
+
+    auto value = std::move(*current);
+    RandomIt hole = current;
+
+    do {
+      *hole = std::move(*(hole - 1));
+      --hole;
+    } while (comp(value, *(hole - 1)));
+
+    *hole = std::move(value);
+  }
+}
+
+#endif // INSERTION_SORT_CPP
@@ -0,0 +1,172 @@
+#ifndef PARALLEL_SORT_CPP
+#define PARALLEL_SORT_CPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "../concurrency/ThreadPool.cpp"
+#include "PdqSort.cpp"
+
+// Ranges at or below this many elements are sorted or merged serially; the
+// cost of a task would outweigh the work it saves.
+constexpr std::ptrdiff_t parallelSortGrainSize = 1 << 14;
+
+/**
+ * Merge the sorted ranges [first1, last1) and [first2, last2) into `out` by
+ * moving, splitting the work across the pool.
+ *
+ * The median of the longer range is placed directly at its final position
+ * (found by binary search in the other range), and the two halves on either
+ * side are merged in parallel.
+ *
+ * @complexity
+ * - Work: O(n)
+ * - Span: O(log^2 n)
+ */
+template <typename InIt1, typename InIt2, typename OutIt, typename Compare>
+void parallelMerge(InIt1 first1, InIt1 last1, InIt2 first2, InIt2 last2,
+                   OutIt out, Compare comp, ThreadPool &pool) {
+  std::ptrdiff_t size1 = last1 - first1;
+  std::ptrdiff_t size2 = last2 - first2;
+
+  if (size1 + size2 <= parallelSortGrainSize) {
+    std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+               std::make_move_iterator(first2), std::make_move_iterator(last2),
+               out, comp);
+    return;
+  }
+
+  if (size1 < size2) {
+    // Keep the longer range first; the merge is not stable anyway.
+    parallelMerge(first2, last2, first1, last1, out, comp, pool);
+    return;
+  }
+
+  InIt1 middle1 = first1 + size1 / 2;
+  InIt2 middle2 = std::lower_bound(first2, last2, *middle1, comp);
+  OutIt middleOut = out + (middle1 - first1) + (middle2 - first2);
+  *middleOut = std::move(*middle1);
+
+  TaskGroup group(pool);
+  group.run([=, &pool] {
+    parallelMerge(first1, middle1, first2, middle2, out, comp, pool);
+  });
+  parallelMerge(middle1 + 1, last1, middle2, last2, middleOut + 1, comp, pool);
+  group.wait();
+}
+
+/**
+ * Sort [first, last) so that the result ends up in `first` when `intoBuffer`
+ * is false, or in the matching slice of `buffer` when it is true. The halves
+ * are sorted into the opposite array, so each level merges between the two
+ * arrays without copying back.
+ *
+ * @complexity
+ * - Work: O(n log n)
+ * - Span: O(log^3 n)
+ */
+template <typename RandomIt, typename BufferIt, typename Compare>
+void parallelMergeSort(RandomIt first, RandomIt last, BufferIt buffer,
+                       bool intoBuffer, Compare comp, ThreadPool &pool) {
+  std::ptrdiff_t size = last - first;
+
+  if (size <= parallelSortGrainSize) {
+    pdqSort(first, last, comp);
+
+    if (intoBuffer) {
+      std::move(first, last, buffer);
+    }
+
+    return;
+  }
+
+  std::ptrdiff_t half = size / 2;
+  RandomIt middle = first + half;
+
+  TaskGroup group(pool);
+  group.run([=, &pool] {
+    parallelMergeSort(first, middle, buffer, !intoBuffer, comp, pool);
+  });
+  parallelMergeSort(middle, last, buffer + half, !intoBuffer, comp, pool);
+  group.wait();
+
+  if (intoBuffer) {
+    parallelMerge(first, middle, middle, last, buffer, comp, pool);
+  } else {
+    parallelMerge(buffer, buffer + half, buffer + half, buffer + size, first,
+                  comp, pool);
+  }
+}
+
+/**
+ * Parallel Sort
+ *
+ * Fork-join merge sort on a work-stealing ThreadPool:
+ *
+ * 1. **Leaves**: the range is split in halves down to the grain size, and
+ *    each leaf is sorted with the serial pdqSort engine.
+ * 2. **Merging**: sorted halves are combined with a parallel merge that
+ *    splits at the median of the longer side, so the final levels keep all
+ *    threads busy instead of ending in one serial merge.
+ * 3. **Scratch memory**: one buffer of n elements, populated by moving the
+ *    input, so T needs to be move-constructible but not default
+ *    constructible. Runs ping-pong between the range and the buffer.
+ *
+ * Ranges at or below the grain size, and pools without workers, go straight
+ * to pdqSort. Not stable. The calling thread helps execute tasks while it
+ * waits, so it should not hold locks the tasks need.
+ *
+ * @complexity
+ * - Work: O(n log n)
+ * - Span: O(log^3 n)
+ */
+template <typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp,
+                  ThreadPool &pool) {
+  std::ptrdiff_t size = last - first;
+
+  if (size <= parallelSortGrainSize || pool.getThreadCount() == 0) {
+    pdqSort(first, last, comp);
+    return;
+  }
+
+  // The elements move into the buffer, which is sorted with the result
+  // landing back in the (moved-from, still assignable) original range.
+  using Value = typename std::iterator_traits<RandomIt>::value_type;
+  std::vector<Value> buffer(std::make_move_iterator(first),
+                            std::make_move_iterator(last));
+
+  parallelMergeSort(buffer.begin(), buffer.end(), first, true, comp, pool);
+}
+
+/**
+ * Parallel sort on a temporary pool. `threads` counts the calling thread,
+ * so `threads - 1` workers are started; 0 means one per hardware thread.
+ *
+ * @complexity O(n log n)
+ */
+template <typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp,
+                  size_t threads = 0) {
+  if (threads == 0) {
+    threads = ThreadPool::defaultThreadCount();
+  }
+
+  if (threads <= 1 || last - first <= parallelSortGrainSize) {
+    pdqSort(first, last, comp);
+    return;
+  }
+
+  ThreadPool pool(threads - 1);
+  parallelSort(first, last, comp, pool);
+}
+
+template <typename RandomIt> void parallelSort(RandomIt first, RandomIt last) {
+  parallelSort(first, last, std::less<>());
+}
+
+#endif // PARALLEL_SORT_CPP
@@ -0,0 +1,333 @@
+#ifndef PDQ_SORT_CPP
+#define PDQ_SORT_CPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "../utils/Constexpr.cpp"
+#include "../utils/OperationStats.cpp"
+#include "HeapSort.cpp"
+#include "InsertionSort.cpp"
+#include "SortingNetwork.cpp"
+
+// Ranges shorter than this are finished with insertion sort.
+constexpr std::ptrdiff_t pdqInsertionSortThreshold = 24;
+
+// Ranges longer than this pick the pivot with Tukey's ninther.
+constexpr std::ptrdiff_t pdqNintherThreshold = 128;
+
+// Element moves a partial insertion sort may make before giving up.
+constexpr std::ptrdiff_t pdqPartialInsertionSortLimit = 8;
+
+/**
+ * Sort the three elements at a, b and c in place.
+ *
+ * @complexity O(1)
+ */
+template <typename RandomIt, typename Compare>
+CONSTEXPR20 void pdqSort3(RandomIt a, RandomIt b, RandomIt c, Compare comp) {
+  if (comp(*b, *a)) {
+    std::iter_swap(a, b);
+  }
+
+  if (comp(*c, *b)) {
+    std::iter_swap(b, c);
+
+    if (comp(*b, *a)) {
+      std::iter_swap(a, b);
+    }
+  }
+}
+
+/**
+ * Try to insertion sort [first, last), bailing out once more than
+ * pdqPartialInsertionSortLimit elements have been moved.
+ *
+ * @complexity O(n)
+ * @return whether the range ended up sorted.
+ */
+template <typename RandomIt, typename Compare>
+CONSTEXPR20 bool pdqPartialInsertionSort(RandomIt first, RandomIt last,
+                                         Compare comp) {
+  if (first == last) {
+    return true;
+  }
+
+  std::ptrdiff_t moved = 0;
+
+  for (RandomIt current = first + 1; current != last; ++current) {
+    if (!comp(*current, *(current - 1))) {
+      continue;
+    }
+
+    auto value = std::move(*current);
+    RandomIt hole = current;
+
+    do {
+      *hole = std::move(*(hole - 1));
+      --hole;
+    } while (hole != first && comp(value, *(hole - 1)));
+
+    *hole = std::move(value);
+    moved += current - hole;
+
+    if (moved > pdqPartialInsertionSortLimit) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Partition [first, last) around the pivot stored at *first. Elements equal
+ * to the pivot go to the right.
+ *
+ * Requires an element not less than the pivot somewhere after it, which the
+ * median-of-three selection guarantees, so the scans need no bounds checks.
+ *
+ * @complexity O(n)
+ * @return final pivot position and whether the range was already
+ * partitioned (no swaps were needed).
+ */
+template <typename RandomIt, typename Compare>
+CONSTEXPR20 std::pair<RandomIt, bool>
+pdqPartitionRight(RandomIt first, RandomIt last, Compare comp) {
+  auto pivot = std::move(*first);
+  RandomIt left = first;
+  RandomIt right = last;
+
+  while (comp(*++left, pivot)) {
+  }
+
+  // With nothing smaller than the pivot at the front, the right scan has no
+  // sentinel and must check bounds.
+  if (left - 1 == first) {
+    while (left < right && !comp(*--right, pivot)) {
+    }
+  } else {
+    while (!comp(*--right, pivot)) {
+    }
+  }
+
+  bool alreadyPartitioned = left >= right;
+
+  while (left < right) {
+    std::iter_swap(left, right);
+
+    while (comp(*++left, pivot)) {
+    }
+
+    while (!comp(*--right, pivot)) {
+    }
+  }
+
+  RandomIt pivotPosition = left - 1;
+  *first = std::move(*pivotPosition);
+  *pivotPosition = std::move(pivot);
+
+  return {pivotPosition, alreadyPartitioned};
+}
+
+/**
+ * Partition [first, last) around the pivot stored at *first, putting
+ * elements equal to the pivot on the left. Used when the pivot equals the
+ * element before the range, so the whole equal run is finished in one pass.
+ *
+ * @complexity O(n)
+ * @return final pivot position.
+ */
+template <typename RandomIt, typename Compare>
+CONSTEXPR20 RandomIt pdqPartitionLeft(RandomIt first, RandomIt last,
+                                      Compare comp) {
+  auto pivot = std::move(*first);
+  RandomIt left = first;
+  RandomIt right = last;
+
+  while (comp(pivot, *--right)) {
+  }
+
+  if (right + 1 == last) {
+    while (left < right && !comp(pivot, *++left)) {
+    }
+  } else {
+    while (!comp(pivot, *++left)) {
+    }
+  }
+
+  while (left < right) {
+    std::iter_swap(left, right);
+
+    while (comp(pivot, *--right)) {
+    }
+
+    while (!comp(pivot, *++left)) {
+    }
+  }
+
+  *first = std::move(*right);
+  *right = std::move(pivot);
+
+  return right;
+}
+
+/**
+ * Main pdqsort loop: recurse into the left partition, loop on the right.
+ *
+ * `badAllowed` counts how many highly unbalanced partitions may still
+ * happen before switching to heap sort. `leftmost` tells whether an element
+ * before `first` can act as a sentinel.
+ *
+ * @complexity O(n log n)
+ */
+template <typename RandomIt, typename Compare>
+CONSTEXPR20 void pdqSortLoop(RandomIt first, RandomIt last, Compare comp,
+                             int badAllowed, bool leftmost) {
+  while (true) {
+    std::ptrdiff_t size = last - first;
+
+    if (size < pdqInsertionSortThreshold) {
+      if constexpr (sortingNetworkBaseCase<RandomIt>) {
+        if (!isConstantEvaluated()) {
+          sortSmall<pdqInsertionSortThreshold - 1>(first, last, comp);
+          return;
+        }
+      }
+
+      if (leftmost) {
+        insertionSort(first, last, comp);
+      } else {
+        unguardedInsertionSort(first, last, comp);
+      }
+
+      return;
+    }
+
+    // Move the chosen pivot to *first.
+    std::ptrdiff_t half = size / 2;
+
+    if (size > pdqNintherThreshold) {
+      pdqSort3(first, first + half, last - 1, comp);
+      pdqSort3(first + 1, first + (half - 1), last - 2, comp);
+      pdqSort3(first + 2, first + (half + 1), last - 3, comp);
+      pdqSort3(first + (half - 1), first + half, first + (half + 1), comp);
+      std::iter_swap(first, first + half);
+    } else {
+      pdqSort3(first + half, first, last - 1, comp);
+    }
+
+    // A pivot equal to the element before the range means everything equal
+    // to it is already in place: skip the run instead of recursing on it.
+    if (!leftmost && !comp(*(first - 1), *first)) {
+      first = pdqPartitionLeft(first, last, comp) + 1;
+      continue;
+    }
+
+    std::pair<RandomIt, bool> partition = pdqPartitionRight(first, last, comp);
+    RandomIt pivot = partition.first;
+    std::ptrdiff_t leftSize = pivot - first;
+    std::ptrdiff_t rightSize = last - (pivot + 1);
+
+    if (leftSize < size / 8 || rightSize < size / 8) {
+      if (--badAllowed == 0) {
+        heapSort(first, last, comp);
+        return;
+      }
+
+      // Break up patterns that produce bad pivots by swapping a few
+      // elements from the quarters into the pivot candidates.
+      if (leftSize >= pdqInsertionSortThreshold) {
+        std::iter_swap(first, first + leftSize / 4);
+        std::iter_swap(pivot - 1, pivot - leftSize / 4);
+
+        if (leftSize > pdqNintherThreshold) {
+          std::iter_swap(first + 1, first + (leftSize / 4 + 1));
+          std::iter_swap(first + 2, first + (leftSize / 4 + 2));
+          std::iter_swap(pivot - 2, pivot - (leftSize / 4 + 1));
+          std::iter_swap(pivot - 3, pivot - (leftSize / 4 + 2));
+        }
+      }
+
+      if (rightSize >= pdqInsertionSortThreshold) {
+        std::iter_swap(pivot + 1, pivot + (1 + rightSize / 4));
+        std::iter_swap(last - 1, last - rightSize / 4);
+
+        if (rightSize > pdqNintherThreshold) {
+          std::iter_swap(pivot + 2, pivot + (2 + rightSize / 4));
+          std::iter_swap(pivot + 3, pivot + (3 + rightSize / 4));
+          std::iter_swap(last - 2, last - (1 + rightSize / 4));
+          std::iter_swap(last - 3, last - (2 + rightSize / 4));
+        }
+      }
+    } else if (partition.second &&
+               pdqPartialInsertionSort(first, pivot, comp) &&
+               pdqPartialInsertionSort(pivot + 1, last, comp)) {
+      // A partition that needed no swaps hints at sorted input; if a cheap
+      // insertion sort finishes both sides, we are done.
+      return;
+    }
+
+    pdqSortLoop(first, pivot, comp, badAllowed, leftmost);
+    first = pivot + 1;
+    leftmost = false;
+  }
+}
+
+/**
+ * Pattern-Defeating Quicksort
+ *
+ * Introsort-style quicksort over any random-access range (std::vector,
+ * DynamicArray, OrderedArray, raw pointers) with a user-supplied strict weak
+ * ordering:
+ *
+ * 1. **Pivot selection**: median of three, or Tukey's ninther for ranges
+ *    above 128 elements.
+ * 2. **Adaptivity**: partitions that need no swaps trigger a bounded
+ *    insertion sort, so sorted and nearly sorted inputs finish in about
+ *    linear time; runs of equal keys are skipped in one pass.
+ * 3. **Worst-case bound**: after log2(n) highly unbalanced partitions the
+ *    range is handed to heap sort, so the result is never quadratic.
+ * 4. **Base case**: ranges below 24 elements use insertion sort, which beats
+ *    bubble sort at every size because it does fewer moves per inversion;
+ *    ranges of arithmetic keys use the branchless sorting network for
+ *    their size (see SortingNetwork.cpp) instead.
+ *
+ * Not stable. constexpr from C++20 on, with insertion sort as the base
+ * case during constant evaluation.
+ *
+ * @complexity
+ * - Worst: O(n log n)
+ * - Average: O(n log n)
+ * - Best: O(n) (Sorted or all-equal input)
+ */
+template <typename RandomIt, typename Compare>
+CONSTEXPR20 void pdqSort(RandomIt first, RandomIt last, Compare comp) {
+  std::ptrdiff_t size = last - first;
+
+  if (size < 2) {
+    return;
+  }
+
+  int log2Size = 0;
+
+  while (size >>= 1) {
+    ++log2Size;
+  }
+
+  pdqSortLoop(first, last, comp, log2Size, true);
+}
+
+template <typename RandomIt>
+CONSTEXPR20 void pdqSort(RandomIt first, RandomIt last) {
+  pdqSort(first, last, std::less<>());
+}
+
+/** Counted pdqSort; see CountingCompare for the Stats overloads. */
+template <typename RandomIt, typename Compare, typename Stats>
+void pdqSort(RandomIt first, RandomIt last, Compare comp, const Stats &stats) {
+  pdqSort(first, last, countingCompare(comp, stats));
+}
+
+#endif // PDQ_SORT_CPP
@@ -0,0 +1,398 @@
+#ifndef POWER_SORT_CPP
+#define POWER_SORT_CPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "../utils/OperationStats.cpp"
+#include "InsertionSort.cpp"
+#include "SortingNetwork.cpp"
+
+// Consecutive wins by one run after which a merge switches to galloping.
+constexpr std::ptrdiff_t powerSortMinGallop = 7;
+
+/**
+ * First position in [first, last) where `pred` is false, for a range where
+ * it holds on a prefix. Probes positions 0, 2, 6, 14, ... before a binary
+ * search, so a partition point k elements in costs O(log k).
+ *
+ * @complexity O(log k)
+ */
+template <typename It, typename Predicate>
+It gallopForward(It first, It last, Predicate pred) {
+  std::ptrdiff_t size = last - first;
+  std::ptrdiff_t low = 0;
+  std::ptrdiff_t offset = 1;
+
+  while (offset <= size && pred(first[offset - 1])) {
+    low = offset;
+    offset = 2 * offset + 1;
+  }
+
+  return std::partition_point(first + low, first + std::min(offset, size),
+                              pred);
+}
+
+/**
+ * Same as gallopForward, probing from the back: a partition point k
+ * elements before `last` costs O(log k).
+ *
+ * @complexity O(log k)
+ */
+template <typename It, typename Predicate>
+It gallopBackward(It first, It last, Predicate pred) {
+  std::ptrdiff_t size = last - first;
+  std::ptrdiff_t high = 0;
+  std::ptrdiff_t offset = 1;
+
+  while (offset <= size && !pred(last[-offset])) {
+    high = offset;
+    offset = 2 * offset + 1;
+  }
+
+  return std::partition_point(last - std::min(offset, size), last - high,
+                              pred);
+}
+
+/**
+ * Length of the natural run starting at `first`. A strictly descending run
+ * is reversed in place, which keeps the sort stable.
+ *
+ * @complexity O(run length)
+ */
+template <typename RandomIt, typename Compare>
+std::ptrdiff_t powerSortFindRun(RandomIt first, RandomIt last, Compare comp) {
+  RandomIt end = first + 1;
+
+  if (end == last) {
+    return 1;
+  }
+
+  if (comp(*end, *first)) {
+    while (end != last && comp(*end, *(end - 1))) {
+      ++end;
+    }
+
+    std::reverse(first, end);
+  } else {
+    while (end != last && !comp(*end, *(end - 1))) {
+      ++end;
+    }
+  }
+
+  return end - first;
+}
+
+/**
+ * Shortest run worth merging: short natural runs are extended to this
+ * length with insertion sort. Between limit / 2 and `limit` and chosen, as
+ * in Timsort, so that n / minRun is at or just below a power of two.
+ *
+ * @complexity O(log n)
+ */
+inline std::ptrdiff_t powerSortMinRun(std::ptrdiff_t size,
+                                      std::ptrdiff_t limit = 64) {
+  std::ptrdiff_t remainder = 0;
+
+  while (size >= limit) {
+    remainder |= size & 1;
+    size >>= 1;
+  }
+
+  return size + remainder;
+}
+
+/**
+ * Depth of the boundary between the adjacent runs [begin1, begin2) and
+ * [begin2, end2) in the perfectly balanced merge tree over n elements,
+ * from the binary expansions of the run midpoints divided by n.
+ *
+ * @complexity O(log n)
+ */
+inline int powerSortNodePower(std::ptrdiff_t size, std::ptrdiff_t begin1,
+                              std::ptrdiff_t begin2, std::ptrdiff_t end2) {
+  // Twice the midpoints, so that they stay integral.
+  std::ptrdiff_t a = begin1 + begin2;
+  std::ptrdiff_t b = begin2 + end2;
+  int power = 0;
+
+  while (true) {
+    ++power;
+
+    if (a >= size) {
+      a -= size;
+      b -= size;
+    } else if (b >= size) {
+      return power;
+    }
+
+    a <<= 1;
+    b <<= 1;
+  }
+}
+
+/**
+ * Merge the sorted runs [first, middle) and [middle, last), moving the
+ * shorter one into `scratch`. Elements of the first run already below the
+ * second and of the second already above the first are skipped by
+ * galloping, and the merge switches to galloping whenever one run wins
+ * `minGallop` times in a row.
+ *
+ * Stable: of equivalent elements, those from the first run go first.
+ *
+ * @complexity O(n), O(log n) for runs that do not interleave
+ */
+template <typename RandomIt, typename Compare, typename Value>
+void powerSortMerge(RandomIt first, RandomIt middle, RandomIt last,
+                    Compare comp, std::vector<Value> &scratch,
+                    std::ptrdiff_t &minGallop) {
+  // Elements of the first run not above the second's head stay in place,
+  // as do elements of the second run not below the first's tail.
+  first = gallopForward(first, middle,
+                        [&](const Value &x) { return !comp(*middle, x); });
+
+  if (first == middle) {
+    return;
+  }
+
+  last = gallopBackward(middle, last, [&](const Value &x) {
+    return comp(x, *(middle - 1));
+  });
+
+  if (middle == last) {
+    return;
+  }
+
+  scratch.clear();
+
+  if (middle - first <= last - middle) {
+    // Merge forward with the first run in scratch.
+    scratch.assign(std::make_move_iterator(first),
+                   std::make_move_iterator(middle));
+    auto left = scratch.begin();
+    auto leftEnd = scratch.end();
+    RandomIt right = middle;
+    RandomIt out = first;
+
+    while (left != leftEnd && right != last) {
+      std::ptrdiff_t leftWins = 0;
+      std::ptrdiff_t rightWins = 0;
+
+      while (left != leftEnd && right != last &&
+             std::max(leftWins, rightWins) < minGallop) {
+        if (comp(*right, *left)) {
+          *out++ = std::move(*right++);
+          ++rightWins;
+          leftWins = 0;
+        } else {
+          *out++ = std::move(*left++);
+          ++leftWins;
+          rightWins = 0;
+        }
+      }
+
+      while (left != leftEnd && right != last) {
+        auto leftStop = gallopForward(
+            left, leftEnd, [&](const Value &x) { return !comp(*right, x); });
+        leftWins = leftStop - left;
+        out = std::move(left, leftStop, out);
+        left = leftStop;
+
+        if (left == leftEnd) {
+          break;
+        }
+
+        RandomIt rightStop = gallopForward(
+            right, last, [&](const Value &x) { return comp(x, *left); });
+        rightWins = rightStop - right;
+        out = std::move(right, rightStop, out);
+        right = rightStop;
+
+        if (std::max(leftWins, rightWins) < powerSortMinGallop) {
+          break;
+        }
+
+        minGallop -= minGallop > 1;
+      }
+
+      ++minGallop;
+    }
+
+    std::move(left, leftEnd, out);
+  } else {
+    // Merge backward with the second run in scratch.
+    scratch.assign(std::make_move_iterator(middle),
+                   std::make_move_iterator(last));
+    RandomIt left = middle;
+    auto rightBegin = scratch.begin();
+    auto right = scratch.end();
+    RandomIt out = last;
+
+    while (left != first && right != rightBegin) {
+      std::ptrdiff_t leftWins = 0;
+      std::ptrdiff_t rightWins = 0;
+
+      while (left != first && right != rightBegin &&
+             std::max(leftWins, rightWins) < minGallop) {
+        if (comp(*(right - 1), *(left - 1))) {
+          *--out = std::move(*--left);
+          ++leftWins;
+          rightWins = 0;
+        } else {
+          *--out = std::move(*--right);
+          ++rightWins;
+          leftWins = 0;
+        }
+      }
+
+      while (left != first && right != rightBegin) {
+        RandomIt leftStop = gallopBackward(first, left, [&](const Value &x) {
+          return !comp(*(right - 1), x);
+        });
+        leftWins = left - leftStop;
+        out = std::move_backward(leftStop, left, out);
+        left = leftStop;
+
+        if (left == first) {
+          break;
+        }
+
+        auto rightStop = gallopBackward(rightBegin, right, [&](const Value &x) {
+          return comp(x, *(left - 1));
+        });
+        rightWins = right - rightStop;
+        out = std::move_backward(rightStop, right, out);
+        right = rightStop;
+
+        if (std::max(leftWins, rightWins) < powerSortMinGallop) {
+          break;
+        }
+
+        minGallop -= minGallop > 1;
+      }
+
+      ++minGallop;
+    }
+
+    std::move_backward(rightBegin, right, out);
+  }
+}
+
+/**
+ * Powersort
+ *
+ * Stable adaptive merge sort, the merge policy of CPython's list.sort since
+ * 3.11:
+ *
+ * 1. **Natural runs**: the input is scanned for ascending and strictly
+ *    descending runs (the latter reversed in place); runs shorter than
+ *    32-64 elements are extended with insertion sort.
+ * 2. **Merge policy**: each boundary between two runs gets the depth it
+ *    would have in a balanced merge tree over the whole range, and a stack
+ *    of runs is merged whenever its top boundary is deeper than the new
+ *    one. The merge cost is within O(n) of optimal for the run lengths
+ *    found, without Timsort's stack invariants.
+ * 3. **Galloping merges**: merges skip the prefix and suffix that are
+ *    already in place and switch to exponential search while one run keeps
+ *    winning, so a few far-out-of-place elements cost O(log n) each.
+ * 4. **Scratch**: merges move the shorter run into one buffer that grows to
+ *    at most n / 2 elements and is reused across merges, or across calls
+ *    with the overload that takes it.
+ *
+ * @complexity
+ * - Worst: O(n log n)
+ * - Average: O(n log n)
+ * - Best: O(n) (Sorted or reverse sorted input; O(n log r) for r runs)
+ */
+template <typename RandomIt, typename Compare>
+void powerSort(
+    RandomIt first, RandomIt last, Compare comp,
+    std::vector<typename std::iterator_traits<RandomIt>::value_type> &scratch) {
+  struct Run {
+    std::ptrdiff_t begin;
+    int power;
+  };
+
+  std::ptrdiff_t size = last - first;
+
+  if (size < 2) {
+    return;
+  }
+
+  // Integer keys extend short runs to at most 32 elements with a sorting
+  // network instead.
+  constexpr bool networkRuns = sortingNetworkStableBaseCase<RandomIt, Compare>;
+  std::ptrdiff_t minRun = powerSortMinRun(
+      size, networkRuns ? static_cast<std::ptrdiff_t>(sortingNetworkMaxSize)
+                        : 64);
+  std::ptrdiff_t minGallop = powerSortMinGallop;
+
+  auto nextRun = [&](std::ptrdiff_t begin) {
+    std::ptrdiff_t length = powerSortFindRun(first + begin, last, comp);
+
+    if (length < minRun) {
+      length = std::min(minRun, size - begin);
+
+      if constexpr (networkRuns) {
+        sortSmall(first + begin, first + begin + length, comp);
+      } else {
+        insertionSort(first + begin, first + begin + length, comp);
+      }
+    }
+
+    return begin + length;
+  };
+
+  // Powers strictly increase up the stack and are at most 64, so the
+  // stack never holds more than 65 runs.
+  Run stack[65];
+  int height = 0;
+  std::ptrdiff_t begin = 0;
+  std::ptrdiff_t end = nextRun(0);
+
+  while (end < size) {
+    std::ptrdiff_t nextEnd = nextRun(end);
+    int power = powerSortNodePower(size, begin, end, nextEnd);
+
+    while (height > 0 && stack[height - 1].power > power) {
+      std::ptrdiff_t below = stack[--height].begin;
+      powerSortMerge(first + below, first + begin, first + end, comp, scratch,
+                     minGallop);
+      begin = below;
+    }
+
+    stack[height++] = Run{begin, power};
+    begin = end;
+    end = nextEnd;
+  }
+
+  while (height > 0) {
+    std::ptrdiff_t below = stack[--height].begin;
+    powerSortMerge(first + below, first + begin, last, comp, scratch,
+                   minGallop);
+    begin = below;
+  }
+}
+
+template <typename RandomIt, typename Compare>
+void powerSort(RandomIt first, RandomIt last, Compare comp) {
+  std::vector<typename std::iterator_traits<RandomIt>::value_type> scratch;
+  powerSort(first, last, comp, scratch);
+}
+
+template <typename RandomIt> void powerSort(RandomIt first, RandomIt last) {
+  powerSort(first, last, std::less<>());
+}
+
+/** Counted powerSort; see CountingCompare for the Stats overloads. */
+template <typename RandomIt, typename Compare, typename Stats>
+void powerSort(RandomIt first, RandomIt last, Compare comp,
+               const Stats &stats) {
+  powerSort(first, last, countingCompare(comp, stats));
+}
+
+#endif // POWER_SORT_CPP
@@ -0,0 +1,275 @@
+#ifndef RADIX_SORT_CPP
+#define RADIX_SORT_CPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "InsertionSort.cpp"
+
+// Bits per digit: one byte, so a histogram fits in 2 KB and stays in L1.
+constexpr unsigned radixDigitBits = 8;
+constexpr size_t radixBuckets = size_t(1) << radixDigitBits;
+
+// MSD buckets at or below this size are finished with insertion sort.
+constexpr std::ptrdiff_t msdRadixInsertionThreshold = 64;
+
+/**
+ * Unsigned integer with the same width as the radix key.
+ */
+template <typename Key, typename Enable = void> struct RadixBits;
+
+template <typename Key>
+struct RadixBits<Key, std::enable_if_t<std::is_integral<Key>::value &&
+                                       !std::is_same<Key, bool>::value>> {
+  using type = std::make_unsigned_t<Key>;
+};
+
+template <> struct RadixBits<float> { using type = uint32_t; };
+
+template <> struct RadixBits<double> { using type = uint64_t; };
+
+/**
+ * Map a key to unsigned bits whose unsigned order matches the key's order.
+ *
+ * - Unsigned integers are used as is.
+ * - Signed integers flip the sign bit, so negatives sort first.
+ * - Floating point flips every bit of negatives (reversing their order) and
+ *   only the sign bit of non-negatives. NaNs with the sign bit clear sort
+ *   after +infinity.
+ *
+ * @complexity O(1)
+ */
+template <typename Key> typename RadixBits<Key>::type radixKey(Key key) {
+  using Bits = typename RadixBits<Key>::type;
+  constexpr Bits signBit = Bits(1) << (sizeof(Bits) * 8 - 1);
+
+  if constexpr (std::is_floating_point<Key>::value) {
+    Bits bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+
+    return (bits & signBit) ? Bits(~bits) : Bits(bits ^ signBit);
+  } else if constexpr (std::is_signed<Key>::value) {
+    return static_cast<Bits>(key) ^ signBit;
+  } else {
+    return key;
+  }
+}
+
+/**
+ * Digit `digit` (0 = least significant) of the radix key of `value`.
+ *
+ * @complexity O(1)
+ */
+template <typename Value, typename KeyOf>
+size_t radixDigit(const Value &value, KeyOf &keyOf, unsigned digit) {
+  return (radixKey(keyOf(value)) >> (digit * radixDigitBits)) &
+         (radixBuckets - 1);
+}
+
+/**
+ * Move `size` elements from `source` to `destination`, ordered stably by
+ * one digit. `offsets` holds the digit histogram on entry.
+ *
+ * @complexity O(n)
+ */
+template <typename SourceIt, typename DestinationIt, typename KeyOf>
+void radixScatter(SourceIt source, std::ptrdiff_t size,
+                  DestinationIt destination,
+                  std::array<size_t, radixBuckets> &offsets, KeyOf &keyOf,
+                  unsigned digit) {
+  size_t total = 0;
+
+  for (size_t &offset : offsets) {
+    size_t count = offset;
+    offset = total;
+    total += count;
+  }
+
+  for (std::ptrdiff_t i = 0; i < size; ++i) {
+    size_t bucket = radixDigit(source[i], keyOf, digit);
+    destination[offsets[bucket]++] = std::move(source[i]);
+  }
+}
+
+/**
+ * LSD Radix Sort
+ *
+ * Sorts by an integer or floating-point key, one byte at a time from the
+ * least significant byte up, with a stable counting scatter per byte:
+ *
+ * 1. **One histogram pass**: the counts of every byte position are gathered
+ *    in a single read of the input.
+ * 2. **Pass skipping**: a byte position where all keys fall into the same
+ *    bucket would not change the order and is skipped. Small-range keys like
+ *    sequential IDs in 64-bit fields usually need only 2-4 of the 8 passes.
+ * 3. **Key extractor**: `keyOf(element)` selects the key, so records can be
+ *    sorted by an integer field; the default sorts the elements themselves.
+ *
+ * Stable. Uses a scratch buffer of n elements; the input is moved into it,
+ * so T only has to be move-constructible and move-assignable.
+ *
+ * @complexity
+ * - Worst: O(w * n) for w-byte keys
+ * - Average: O(w * n)
+ * - Best: O(n) (If all keys share every byte but one)
+ */
+template <typename RandomIt, typename KeyOf>
+void radixSort(RandomIt first, RandomIt last, KeyOf keyOf) {
+  using Value = typename std::iterator_traits<RandomIt>::value_type;
+  using Key = std::decay_t<decltype(keyOf(*first))>;
+  constexpr unsigned digits = sizeof(Key);
+
+  std::ptrdiff_t size = last - first;
+
+  if (size < 2) {
+    return;
+  }
+
+  std::array<std::array<size_t, radixBuckets>, digits> counts{};
+
+  for (RandomIt it = first; it != last; ++it) {
+    auto bits = radixKey(keyOf(*it));
+
+    for (unsigned digit = 0; digit < digits; ++digit) {
+      size_t bucket = (bits >> (digit * radixDigitBits)) & (radixBuckets - 1);
+      ++counts[digit][bucket];
+    }
+  }
+
+  std::vector<Value> buffer(std::make_move_iterator(first),
+                            std::make_move_iterator(last));
+  bool inBuffer = true;
+
+  for (unsigned digit = 0; digit < digits; ++digit) {
+    std::array<size_t, radixBuckets> &count = counts[digit];
+
+    if (count[radixDigit(inBuffer ? buffer[0] : *first, keyOf, digit)] ==
+        static_cast<size_t>(size)) {
+      continue;
+    }
+
+    if (inBuffer) {
+      radixScatter(buffer.begin(), size, first, count, keyOf, digit);
+    } else {
+      radixScatter(first, size, buffer.begin(), count, keyOf, digit);
+    }
+
+    inBuffer = !inBuffer;
+  }
+
+  if (inBuffer) {
+    std::move(buffer.begin(), buffer.end(), first);
+  }
+}
+
+template <typename RandomIt> void radixSort(RandomIt first, RandomIt last) {
+  radixSort(first, last, [](const auto &value) { return value; });
+}
+
+/**
+ * Recursive MSD step: `data` holds the live elements, `scratch` the same
+ * number of assignable slots. Elements are distributed by the highest digit
+ * that still differs, moved back in bucket order, and every bucket is sorted
+ * by the digits below.
+ *
+ * @complexity O(w * n)
+ */
+template <typename RandomIt, typename BufferIt, typename KeyOf>
+void msdRadixSortBuckets(RandomIt data, std::ptrdiff_t size, BufferIt scratch,
+                         KeyOf &keyOf, int digit) {
+  if (size <= msdRadixInsertionThreshold) {
+    insertionSort(data, data + size, [&keyOf](const auto &a, const auto &b) {
+      return radixKey(keyOf(a)) < radixKey(keyOf(b));
+    });
+    return;
+  }
+
+  std::array<size_t, radixBuckets> count{};
+
+  for (; digit >= 0; --digit) {
+    count.fill(0);
+
+    for (std::ptrdiff_t i = 0; i < size; ++i) {
+      ++count[radixDigit(data[i], keyOf, digit)];
+    }
+
+    size_t firstBucket = radixDigit(data[0], keyOf, digit);
+
+    if (count[firstBucket] != static_cast<size_t>(size)) {
+      break;
+    }
+  }
+
+  if (digit < 0) {
+    // Every key is equal.
+    return;
+  }
+
+  std::array<size_t, radixBuckets> offsets = count;
+  radixScatter(data, size, scratch, offsets, keyOf, digit);
+  std::move(scratch, scratch + size, data);
+
+  if (digit == 0) {
+    return;
+  }
+
+  size_t start = 0;
+
+  for (size_t bucket = 0; bucket < radixBuckets; ++bucket) {
+    if (count[bucket] > 1) {
+      msdRadixSortBuckets(data + start, count[bucket], scratch + start, keyOf,
+                          digit - 1);
+    }
+
+    start += count[bucket];
+  }
+}
+
+/**
+ * MSD Radix Sort
+ *
+ * Distributes by the most significant byte first and recurses into each
+ * bucket, skipping bytes shared by the whole bucket and finishing small
+ * buckets with insertion sort. Unlike LSD it stops as soon as buckets are
+ * sorted, so wide keys with a large spread (random 64-bit IDs, hashes)
+ * typically need only about log256(n) passes instead of all eight.
+ *
+ * Stable. Takes the same optional key extractor as radixSort.
+ *
+ * @complexity
+ * - Worst: O(w * n) for w-byte keys
+ * - Average: O(n log256 n)
+ * - Best: O(n)
+ */
+template <typename RandomIt, typename KeyOf>
+void msdRadixSort(RandomIt first, RandomIt last, KeyOf keyOf) {
+  using Value = typename std::iterator_traits<RandomIt>::value_type;
+  using Key = std::decay_t<decltype(keyOf(*first))>;
+  constexpr int digits = sizeof(Key);
+
+  std::ptrdiff_t size = last - first;
+
+  if (size < 2) {
+    return;
+  }
+
+  // Moving the input out and back leaves n assignable moved-from slots
+  // without requiring T to be default-constructible.
+  std::vector<Value> scratch(std::make_move_iterator(first),
+                             std::make_move_iterator(last));
+  std::move(scratch.begin(), scratch.end(), first);
+
+  msdRadixSortBuckets(first, size, scratch.begin(), keyOf, digits - 1);
+}
+
+template <typename RandomIt> void msdRadixSort(RandomIt first, RandomIt last) {
+  msdRadixSort(first, last, [](const auto &value) { return value; });
+}
+
+#endif // RADIX_SORT_CPP
@@ -0,0 +1,392 @@
+#ifndef SELECTION_CPP
+#define SELECTION_CPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../utils/OperationStats.cpp"
+#include "HeapSort.cpp"
+#include "InsertionSort.cpp"
+#include "PdqSort.cpp"
+
+// partialSort keeps the first k elements in a heap instead of selecting them
+// with nthElement while k is at most this fraction of the range.
+constexpr std::ptrdiff_t partialSortHeapRatio = 64;
+
+template <typename RandomIt, typename Compare>
+void nthElement(RandomIt first, RandomIt nth, RandomIt last, Compare comp);
+
+/**
+ * Move the median of medians of groups of five to *first: each group is
+ * sorted in place, its median moved to the front, and the medians' median
+ * selected recursively. At least 3/10 of the range is on either side of it.
+ *
+ * @complexity O(n)
+ */
+template <typename RandomIt, typename Compare>
+void medianOfMediansPivot(RandomIt first, RandomIt last, Compare comp) {
+  std::ptrdiff_t groups = (last - first) / 5;
+
+  for (std::ptrdiff_t g = 0; g < groups; ++g) {
+    RandomIt group = first + 5 * g;
+    insertionSort(group, group + 5, comp);
+    std::iter_swap(first + g, group + 2);
+  }
+
+  nthElement(first, first + groups / 2, first + groups, comp);
+  std::iter_swap(first, first + groups / 2);
+}
+
+/**
+ * Nth element (introselect)
+ *
+ * Rearranges [first, last) so that *nth is the element that would be there
+ * if the range were sorted, nothing after it precedes it and nothing before
+ * it follows it:
+ *
+ * 1. **Quickselect**: partitions around a median of three (Tukey's ninther
+ *    above 128 elements) with the pdqSort partitioning and keeps only the
+ *    side holding nth; runs of keys equal to an earlier pivot are skipped
+ *    in one pass, and unbalanced partitions shuffle a few elements to
+ *    break up patterns.
+ * 2. **Worst-case bound**: after log2(n) highly unbalanced partitions the
+ *    pivots switch to the median of medians, so the result is never
+ *    quadratic.
+ * 3. **Base case**: ranges below 24 elements are insertion sorted.
+ *
+ * Not stable.
+ *
+ * @complexity
+ * - Worst: O(n)
+ * - Average: O(n)
+ * - Best: O(n)
+ */
+template <typename RandomIt, typename Compare>
+void nthElement(RandomIt first, RandomIt nth, RandomIt last, Compare comp) {
+  if (nth == last) {
+    return;
+  }
+
+  std::ptrdiff_t size = last - first;
+  int badAllowed = 0;
+
+  while (size >>= 1) {
+    ++badAllowed;
+  }
+
+  bool leftmost = true;
+
+  while (last - first >= pdqInsertionSortThreshold) {
+    size = last - first;
+    std::ptrdiff_t half = size / 2;
+
+    if (badAllowed == 0) {
+      medianOfMediansPivot(first, last, comp);
+    } else if (size > pdqNintherThreshold) {
+      pdqSort3(first, first + half, last - 1, comp);
+      pdqSort3(first + 1, first + (half - 1), last - 2, comp);
+      pdqSort3(first + 2, first + (half + 1), last - 3, comp);
+      pdqSort3(first + (half - 1), first + half, first + (half + 1), comp);
+      std::iter_swap(first, first + half);
+    } else {
+      pdqSort3(first + half, first, last - 1, comp);
+    }
+
+    // Everything equal to the element before the range is already in
+    // place, as in pdqSort.
+    if (!leftmost && !comp(*(first - 1), *first)) {
+      RandomIt equalEnd = pdqPartitionLeft(first, last, comp) + 1;
+
+      if (nth < equalEnd) {
+        return;
+      }
+
+      first = equalEnd;
+      continue;
+    }
+
+    RandomIt pivot = pdqPartitionRight(first, last, comp).first;
+
+    if (pivot == nth) {
+      return;
+    }
+
+    bool bad = pivot - first < size / 8 || last - (pivot + 1) < size / 8;
+
+    if (nth < pivot) {
+      last = pivot;
+    } else {
+      first = pivot + 1;
+      leftmost = false;
+    }
+
+    // Break up patterns that produce bad pivots, as pdqSort does, by
+    // swapping a few elements from the quarters into the pivot candidates.
+    std::ptrdiff_t kept = last - first;
+
+    if (bad && badAllowed > 0 && --badAllowed > 0 &&
+        kept >= pdqInsertionSortThreshold) {
+      std::iter_swap(first, first + kept / 4);
+      std::iter_swap(last - 1, last - kept / 4);
+
+      if (kept > pdqNintherThreshold) {
+        std::iter_swap(first + 1, first + (kept / 4 + 1));
+        std::iter_swap(first + 2, first + (kept / 4 + 2));
+        std::iter_swap(last - 2, last - (kept / 4 + 1));
+        std::iter_swap(last - 3, last - (kept / 4 + 2));
+      }
+    }
+  }
+
+  insertionSort(first, last, comp);
+}
+
+template <typename RandomIt>
+void nthElement(RandomIt first, RandomIt nth, RandomIt last) {
+  nthElement(first, nth, last, std::less<>());
+}
+
+/** Counted nthElement; see CountingCompare for the Stats overloads. */
+template <typename RandomIt, typename Compare, typename Stats>
+void nthElement(RandomIt first, RandomIt nth, RandomIt last, Compare comp,
+                const Stats &stats) {
+  nthElement(first, nth, last, countingCompare(comp, stats));
+}
+
+/**
+ * Partial sort
+ *
+ * Rearranges [first, last) so that [first, middle) holds, in order, the
+ * k = middle - first elements that come first in the sorted range; the
+ * order of the rest is unspecified.
+ *
+ * 1. **Small k**: the prefix is kept as a max-heap and every later element
+ *    is compared with its root, so on random input almost every element
+ *    costs one comparison; the heap is then sorted. An element that
+ *    replaces the root costs a sift-down, so on input in descending order
+ *    every element does.
+ * 2. **Larger k**: nthElement moves the k elements to the front in linear
+ *    time and pdqSort sorts them.
+ *
+ * Not stable.
+ *
+ * @complexity
+ * - Worst: O(n log k) on the small-k path, O(n + k log k) otherwise
+ * - Average: O(n + k log k log(n / k))
+ * - Best: O(n) (k small against n)
+ */
+template <typename RandomIt, typename Compare>
+void partialSort(RandomIt first, RandomIt middle, RandomIt last,
+                 Compare comp) {
+  std::ptrdiff_t k = middle - first;
+
+  if (k == 0) {
+    return;
+  }
+
+  if (k * partialSortHeapRatio > last - first) {
+    nthElement(first, middle, last, comp);
+    pdqSort(first, middle, comp);
+    return;
+  }
+
+  for (std::ptrdiff_t root = k / 2; root > 0; --root) {
+    siftDown(first, root - 1, k, comp);
+  }
+
+  for (RandomIt current = middle; current != last; ++current) {
+    if (comp(*current, *first)) {
+      std::iter_swap(current, first);
+      siftDown(first, 0, k, comp);
+    }
+  }
+
+  for (std::ptrdiff_t end = k - 1; end > 0; --end) {
+    std::iter_swap(first, first + end);
+    siftDown(first, 0, end, comp);
+  }
+}
+
+template <typename RandomIt>
+void partialSort(RandomIt first, RandomIt middle, RandomIt last) {
+  partialSort(first, middle, last, std::less<>());
+}
+
+/** Counted partialSort; see CountingCompare for the Stats overloads. */
+template <typename RandomIt, typename Compare, typename Stats>
+void partialSort(RandomIt first, RandomIt middle, RandomIt last, Compare comp,
+                 const Stats &stats) {
+  partialSort(first, middle, last, countingCompare(comp, stats));
+}
+
+/**
+ * TopK
+ *
+ * Streaming accumulator of the `capacity` elements that come first under
+ * `Compare` among everything pushed: the smallest with std::less, the
+ * largest with std::greater. Input is never stored, so it can be unbounded.
+ *
+ * Once full, the kept elements form a max-heap whose root is the current
+ * threshold; an element that does not precede it is rejected with a single
+ * comparison, and one that does replaces the root. An element equivalent
+ * to the threshold is rejected, but which of several equivalent kept
+ * elements is evicted depends on the heap layout, so among equivalent
+ * elements the kept ones are unspecified.
+ *
+ * @complexity O(n log k) for n pushes, O(n) for random input with k << n
+ */
+template <typename T, typename Compare = std::less<T>> class TopK {
+private:
+  std::vector<T> heap;
+  size_t capacity;
+  Compare comp;
+
+  /**
+   * Turn the buffer into a max-heap once it first fills up.
+   *
+   * @complexity O(k)
+   */
+  void heapify() {
+    std::ptrdiff_t size = static_cast<std::ptrdiff_t>(heap.size());
+
+    for (std::ptrdiff_t root = size / 2; root > 0; --root) {
+      siftDown(heap.begin(), root - 1, size, comp);
+    }
+  }
+
+  /**
+   * Put `value` in place of the root and restore the heap.
+   *
+   * @complexity O(log k)
+   */
+  template <typename Value> void replaceRoot(Value &&value) {
+    heap.front() = std::forward<Value>(value);
+    siftDown(heap.begin(), 0, static_cast<std::ptrdiff_t>(heap.size()),
+             comp);
+  }
+
+  template <typename Value> void pushValue(Value &&value) {
+    if (heap.size() < capacity) {
+      heap.push_back(std::forward<Value>(value));
+
+      if (heap.size() == capacity) {
+        heapify();
+      }
+    } else if (capacity > 0 && comp(value, heap.front())) {
+      replaceRoot(std::forward<Value>(value));
+    }
+  }
+
+public:
+  /**
+   * Empty accumulator keeping at most `capacity` elements.
+   *
+   * @complexity O(k)
+   */
+  explicit TopK(size_t capacity, const Compare &comp = Compare())
+      : capacity(capacity), comp(comp) {
+    heap.reserve(capacity);
+  }
+
+  /**
+   * Offer `value`: kept if fewer than k elements are held or it precedes
+   * the threshold, which it then evicts.
+   *
+   * @complexity O(1) if rejected, O(log k) otherwise
+   */
+  void push(const T &value) { pushValue(value); }
+
+  void push(T &&value) { pushValue(std::move(value)); }
+
+  /**
+   * Offer every element of [first, last).
+   *
+   * @complexity O(n log k)
+   */
+  template <typename InputIt> void pushRange(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      pushValue(*first);
+    }
+  }
+
+  /**
+   * Return the number of elements held, at most the capacity.
+   *
+   * @complexity O(1)
+   */
+  size_t getSize() const { return heap.size(); }
+
+  /**
+   * Return the capacity k.
+   *
+   * @complexity O(1)
+   */
+  size_t getCapacity() const { return capacity; }
+
+  /**
+   * Whether k elements are held, so that pushes start to evict.
+   *
+   * @complexity O(1)
+   */
+  bool isFull() const { return heap.size() == capacity; }
+
+  /**
+   * The last of the kept elements in order: a pushed element must precede
+   * it to be kept. Only defined once the accumulator is full.
+   *
+   * @complexity O(1)
+   */
+  const T &threshold() const {
+    if (heap.empty() || heap.size() < capacity) {
+      throw std::out_of_range("TopK is not full");
+    }
+
+    return heap.front();
+  }
+
+  /**
+   * Copy of the kept elements in order.
+   *
+   * @complexity O(k log k)
+   */
+  std::vector<T> sorted() const {
+    std::vector<T> result(heap);
+    pdqSort(result.begin(), result.end(), comp);
+
+    return result;
+  }
+
+  /**
+   * Move the kept elements out in order, leaving the accumulator empty.
+   *
+   * @complexity O(k log k)
+   */
+  std::vector<T> take() {
+    std::vector<T> result = std::move(heap);
+    heap.clear();
+    heap.reserve(capacity);
+    pdqSort(result.begin(), result.end(), comp);
+
+    return result;
+  }
+
+  /**
+   * Drop every kept element.
+   *
+   * @complexity O(k)
+   */
+  void clear() { heap.clear(); }
+
+  /**
+   * Return the comparator.
+   *
+   * @complexity O(1)
+   */
+  const Compare &getCompare() const { return comp; }
+};
+
+#endif // SELECTION_CPP
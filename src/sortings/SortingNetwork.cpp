@@ -0,0 +1,437 @@
+#ifndef SORTING_NETWORK_CPP
+#define SORTING_NETWORK_CPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "../utils/OperationStats.cpp"
+
+// Largest size with a generated network.
+constexpr size_t sortingNetworkMaxSize = 32;
+
+/**
+ * One comparator of a sorting network: after it, the element at `low`
+ * does not follow the one at `high`.
+ */
+struct NetworkComparator {
+  unsigned char low;
+  unsigned char high;
+};
+
+/**
+ * Call `visit(i, j)` for every comparator of Batcher's odd-even merge sort
+ * over `size` wires, in order. Comparators that would touch a wire at or
+ * past `size` are dropped, which leaves a valid network for any size.
+ *
+ * @complexity O(n log^2 n)
+ */
+template <typename Visit>
+constexpr void batcherNetwork(size_t size, Visit &&visit) {
+  for (size_t p = 1; p < size; p += p) {
+    for (size_t k = p; k > 0; k /= 2) {
+      for (size_t j = k % p; j + k < size; j += k + k) {
+        for (size_t i = 0; i < k && i + j + k < size; ++i) {
+          if ((i + j) / (p + p) == (i + j + k) / (p + p)) {
+            visit(i + j, i + j + k);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Number of comparators in the network over `size` wires.
+ *
+ * @complexity O(n log^2 n)
+ */
+constexpr size_t sortingNetworkLength(size_t size) {
+  size_t length = 0;
+  batcherNetwork(size, [&length](size_t, size_t) { ++length; });
+
+  return length;
+}
+
+/**
+ * The comparators of the network over N wires, computed at compile time.
+ *
+ * @complexity O(n log^2 n), at compile time
+ */
+template <size_t N>
+constexpr std::array<NetworkComparator, sortingNetworkLength(N)>
+makeSortingNetwork() {
+  std::array<NetworkComparator, sortingNetworkLength(N)> network{};
+  size_t next = 0;
+
+  batcherNetwork(N, [&network, &next](size_t i, size_t j) {
+    network[next].low = static_cast<unsigned char>(i);
+    network[next].high = static_cast<unsigned char>(j);
+    ++next;
+  });
+
+  return network;
+}
+
+template <size_t N>
+constexpr std::array<NetworkComparator, sortingNetworkLength(N)>
+    sortingNetwork = makeSortingNetwork<N>();
+
+/**
+ * Order `a` and `b`. Arithmetic values and pointers are selected without
+ * a branch, which compiles to conditional moves or min/max instructions;
+ * other types are swapped only if out of order.
+ *
+ * @complexity O(1)
+ */
+template <typename T, typename Compare>
+inline void compareExchange(T &a, T &b, Compare &comp) {
+#if defined(__SSE2__) || defined(_M_X64)
+  // Compilers branch on floating-point selects; minsd(y, x) is exactly
+  // y < x ? y : x, and maxsd(x, y) is y < x ? x : y.
+  constexpr bool ascending = std::is_same<Compare, std::less<T>>::value ||
+                             std::is_same<Compare, std::less<>>::value;
+
+  if constexpr (ascending && std::is_same<T, double>::value) {
+    __m128d x = _mm_set_sd(a);
+    __m128d y = _mm_set_sd(b);
+    a = _mm_cvtsd_f64(_mm_min_sd(y, x));
+    b = _mm_cvtsd_f64(_mm_max_sd(x, y));
+    return;
+  } else if constexpr (ascending && std::is_same<T, float>::value) {
+    __m128 x = _mm_set_ss(a);
+    __m128 y = _mm_set_ss(b);
+    a = _mm_cvtss_f32(_mm_min_ss(y, x));
+    b = _mm_cvtss_f32(_mm_max_ss(x, y));
+    return;
+  }
+#endif
+
+  if constexpr (std::is_arithmetic<T>::value ||
+                       std::is_pointer<T>::value) {
+    T x = a;
+    T y = b;
+    bool swap = comp(y, x);
+    a = swap ? y : x;
+    b = swap ? x : y;
+  } else if (comp(b, a)) {
+    std::swap(a, b);
+  }
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+/**
+ * Lanes of an SSE register holding four int32 or float keys, with the
+ * min and max the register-level networks need. Everything is kept as
+ * __m128 and reinterpreted, since the casts are free. Of two equal keys,
+ * min and max return different operands, so both are kept.
+ */
+template <typename T> struct NetworkLanes;
+
+template <> struct NetworkLanes<float> {
+  static __m128 load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, __m128 v) { _mm_storeu_ps(p, v); }
+  // minps and maxps return their second operand when the comparison fails;
+  // swapping the operands of one keeps 0.0 and -0.0 (or NaNs) distinct.
+  static __m128 min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+  static __m128 max(__m128 a, __m128 b) { return _mm_max_ps(b, a); }
+};
+
+template <> struct NetworkLanes<int32_t> {
+  static __m128 load(const int32_t *p) {
+    return _mm_castsi128_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+  }
+
+  static void store(int32_t *p, __m128 v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_castps_si128(v));
+  }
+
+  // SSE2 has no 32-bit integer min/max: blend on a greater-than mask.
+  static __m128 min(__m128 a, __m128 b) {
+    __m128 greater = _mm_castsi128_ps(
+        _mm_cmpgt_epi32(_mm_castps_si128(a), _mm_castps_si128(b)));
+    return _mm_or_ps(_mm_and_ps(greater, b), _mm_andnot_ps(greater, a));
+  }
+
+  static __m128 max(__m128 a, __m128 b) {
+    __m128 greater = _mm_castsi128_ps(
+        _mm_cmpgt_epi32(_mm_castps_si128(a), _mm_castps_si128(b)));
+    return _mm_or_ps(_mm_and_ps(greater, a), _mm_andnot_ps(greater, b));
+  }
+};
+
+/**
+ * Sort a bitonic register: compare-exchange lanes two apart, then
+ * neighbours.
+ *
+ * @complexity O(1)
+ */
+template <typename Lanes> inline __m128 bitonicCleanLanes(__m128 v) {
+  __m128 swapped = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+  __m128 low = Lanes::min(v, swapped);
+  __m128 high = Lanes::max(v, swapped);
+  v = _mm_movelh_ps(low, high);
+
+  swapped = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+  low = Lanes::min(v, swapped);
+  high = Lanes::max(v, swapped);
+  v = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+
+  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+/**
+ * Sort `Count` registers whose lanes, read in order, form a bitonic
+ * sequence: compare-exchange registers half the span apart, then each
+ * half, down to single registers.
+ *
+ * @complexity O(Count log Count)
+ */
+template <typename Lanes, size_t Count>
+inline void bitonicCleanRegisters(__m128 *v) {
+  if constexpr (Count == 1) {
+    v[0] = bitonicCleanLanes<Lanes>(v[0]);
+  } else {
+    constexpr size_t half = Count / 2;
+
+    for (size_t i = 0; i < half; ++i) {
+      __m128 low = Lanes::min(v[i], v[i + half]);
+      v[i + half] = Lanes::max(v[i], v[i + half]);
+      v[i] = low;
+    }
+
+    bitonicCleanRegisters<Lanes, half>(v);
+    bitonicCleanRegisters<Lanes, half>(v + half);
+  }
+}
+
+/**
+ * Merge the sorted sequences in v[0, Count) and v[Count, 2 * Count):
+ * reversing the second makes the whole bitonic, one min/max step splits it
+ * into two bitonic halves with the low one first, and each half is
+ * cleaned.
+ *
+ * @complexity O(Count log Count)
+ */
+template <typename Lanes, size_t Count>
+inline void bitonicMergeRegisters(__m128 *v) {
+  __m128 high[Count];
+
+  for (size_t i = 0; i < Count; ++i) {
+    __m128 reversed = _mm_shuffle_ps(v[2 * Count - 1 - i],
+                                     v[2 * Count - 1 - i],
+                                     _MM_SHUFFLE(0, 1, 2, 3));
+    high[i] = Lanes::max(v[i], reversed);
+    v[i] = Lanes::min(v[i], reversed);
+  }
+
+  for (size_t i = 0; i < Count; ++i) {
+    v[Count + i] = high[i];
+  }
+
+  bitonicCleanRegisters<Lanes, Count>(v);
+  bitonicCleanRegisters<Lanes, Count>(v + Count);
+}
+
+/**
+ * Sort 4 * Count elements held in Count registers (Count is 4 or 8): the
+ * 4-element network runs across each group of four registers, sorting
+ * its columns, a transpose turns the columns into sorted registers, and
+ * bitonic merges combine them.
+ *
+ * @complexity O(1)
+ */
+template <typename Lanes, size_t Count>
+inline void sortRegisters(__m128 *v) {
+  for (size_t g = 0; g < Count; g += 4) {
+    __m128 *r = v + g;
+    auto exchange = [](__m128 &a, __m128 &b) {
+      __m128 low = Lanes::min(a, b);
+      b = Lanes::max(a, b);
+      a = low;
+    };
+
+    exchange(r[0], r[1]);
+    exchange(r[2], r[3]);
+    exchange(r[0], r[2]);
+    exchange(r[1], r[3]);
+    exchange(r[1], r[2]);
+    _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+
+    bitonicMergeRegisters<Lanes, 1>(r);
+    bitonicMergeRegisters<Lanes, 1>(r + 2);
+    bitonicMergeRegisters<Lanes, 2>(r);
+  }
+
+  if constexpr (Count == 8) {
+    bitonicMergeRegisters<Lanes, 4>(v);
+  }
+}
+#endif
+
+/**
+ * Whether sortN<N> over `RandomIt` with `Compare` can run the register
+ * network: 16 or 32 contiguous int32 or float keys in ascending order.
+ */
+template <size_t N, typename RandomIt, typename Compare>
+constexpr bool vectorizedNetworkApplies() {
+#if defined(__SSE2__) || defined(_M_X64)
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+
+  return (N == 16 || N == 32) &&
+         (std::is_same<T, int32_t>::value || std::is_same<T, float>::value) &&
+         (std::is_same<RandomIt, T *>::value ||
+          std::is_same<RandomIt, typename std::vector<T>::iterator>::value) &&
+         (std::is_same<Compare, std::less<T>>::value ||
+          std::is_same<Compare, std::less<>>::value);
+#else
+  return false;
+#endif
+}
+
+/**
+ * Sorting network
+ *
+ * Sorts exactly N elements starting at `first` with a fixed sequence of
+ * compare-exchanges (Batcher's odd-even merge sort, generated at compile
+ * time and fully unrolled), so the work does not depend on the input and
+ * no comparison result is ever branched on for arithmetic types:
+ *
+ * 1. **Scalar**: the elements are copied into locals that the compiler can
+ *    keep in registers, sorted with branchless min/max, and written back.
+ * 2. **SIMD**: 16 or 32 int32 or float keys in ascending order are sorted
+ *    four lanes at a time in SSE registers (see sortRegisters).
+ *
+ * The networks have 1, 3, 5, 9, 12, 16, 19 comparators for N = 2..8, which
+ * is optimal, and 63 and 191 for N = 16 and 32 (best known: 60 and 185).
+ * Not stable.
+ *
+ * @complexity
+ * - Worst: O(N log^2 N)
+ * - Average: O(N log^2 N)
+ * - Best: O(N log^2 N)
+ */
+template <size_t N, typename RandomIt, typename Compare>
+void sortN(RandomIt first, Compare comp) {
+  static_assert(N <= sortingNetworkMaxSize, "No network for this size");
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+
+  if constexpr (N < 2) {
+    return;
+  } else if constexpr (vectorizedNetworkApplies<N, RandomIt, Compare>()) {
+#if defined(__SSE2__) || defined(_M_X64)
+    using Lanes = NetworkLanes<T>;
+    T *data = &*first;
+    __m128 v[N / 4];
+
+    for (size_t i = 0; i < N / 4; ++i) {
+      v[i] = Lanes::load(data + 4 * i);
+    }
+
+    sortRegisters<Lanes, N / 4>(v);
+
+    for (size_t i = 0; i < N / 4; ++i) {
+      Lanes::store(data + 4 * i, v[i]);
+    }
+#endif
+  } else if constexpr (std::is_arithmetic<T>::value ||
+                       std::is_pointer<T>::value) {
+    T values[N];
+
+    for (size_t i = 0; i < N; ++i) {
+      values[i] = first[i];
+    }
+
+    // Fully unrolled, every index is a constant and the locals stay in
+    // registers.
+#pragma GCC unroll 256
+    for (const NetworkComparator &c : sortingNetwork<N>) {
+      compareExchange(values[c.low], values[c.high], comp);
+    }
+
+    for (size_t i = 0; i < N; ++i) {
+      first[i] = values[i];
+    }
+  } else {
+    for (const NetworkComparator &c : sortingNetwork<N>) {
+      compareExchange(first[c.low], first[c.high], comp);
+    }
+  }
+}
+
+template <size_t N, typename RandomIt> void sortN(RandomIt first) {
+  sortN<N>(first, std::less<>());
+}
+
+/** Counted sortN; see CountingCompare for the Stats overloads. */
+template <size_t N, typename RandomIt, typename Compare, typename Stats>
+void sortN(RandomIt first, Compare comp, const Stats &stats) {
+  sortN<N>(first, countingCompare(comp, stats));
+}
+
+template <typename RandomIt, typename Compare, size_t... N>
+constexpr std::array<void (*)(RandomIt, Compare), sizeof...(N)>
+makeSortNTable(std::index_sequence<N...>) {
+  return {&sortN<N, RandomIt, Compare>...};
+}
+
+/**
+ * Sort [first, last), at most MaxSize elements, with the network for its
+ * size, picked from a table of sortN instantiations. Callers that never
+ * pass the largest sizes lower MaxSize to instantiate fewer networks.
+ *
+ * @complexity O(n log^2 n)
+ */
+template <size_t MaxSize = sortingNetworkMaxSize, typename RandomIt,
+          typename Compare>
+void sortSmall(RandomIt first, RandomIt last, Compare comp) {
+  static_assert(MaxSize <= sortingNetworkMaxSize, "No network for this size");
+  static constexpr std::array<void (*)(RandomIt, Compare), MaxSize + 1>
+      table = makeSortNTable<RandomIt, Compare>(
+          std::make_index_sequence<MaxSize + 1>());
+
+  table[last - first](first, comp);
+}
+
+template <size_t MaxSize = sortingNetworkMaxSize, typename RandomIt>
+void sortSmall(RandomIt first, RandomIt last) {
+  sortSmall<MaxSize>(first, last, std::less<>());
+}
+
+/**
+ * Whether the quicksort and merge sort engines finish small ranges of
+ * RandomIt with sortSmall instead of insertion sort: only for arithmetic
+ * keys, where the branchless network beats the unpredictable branches of
+ * insertion sort.
+ */
+template <typename RandomIt>
+constexpr bool sortingNetworkBaseCase = std::is_arithmetic<
+    typename std::iterator_traits<RandomIt>::value_type>::value;
+
+/**
+ * Whether the stable merge sort engine may finish short runs with
+ * sortSmall: networks are not stable, so only for integer keys under the
+ * standard comparators, where equivalent keys are identical.
+ */
+template <typename RandomIt, typename Compare>
+constexpr bool sortingNetworkStableBaseCase = [] {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+
+  return std::is_integral<T>::value &&
+         (std::is_same<Compare, std::less<T>>::value ||
+          std::is_same<Compare, std::less<>>::value ||
+          std::is_same<Compare, std::greater<T>>::value ||
+          std::is_same<Compare, std::greater<>>::value);
+}();
+
+#endif // SORTING_NETWORK_CPP
@@ -0,0 +1,82 @@
+#ifndef BIT_SCAN_CPP
+#define BIT_SCAN_CPP
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/**
+ * Index of the lowest set bit of `mask`, which must not be zero. GCC and
+ * Clang use their builtins, MSVC uses _BitScanForward.
+ *
+ * @complexity O(1)
+ */
+inline unsigned countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned countTrailingZeros(uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward64(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+/**
+ * Number of set bits in `mask`.
+ *
+ * @complexity O(1)
+ */
+inline unsigned popCount(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  // __popcnt needs POPCNT, which x64 does not guarantee.
+  mask = mask - ((mask >> 1) & 0x55555555u);
+  mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+  return (((mask + (mask >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+#else
+  return static_cast<unsigned>(__builtin_popcount(mask));
+#endif
+}
+
+inline unsigned popCount(uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  return popCount(static_cast<uint32_t>(mask)) +
+         popCount(static_cast<uint32_t>(mask >> 32));
+#else
+  return static_cast<unsigned>(__builtin_popcountll(mask));
+#endif
+}
+
+/**
+ * Hint that the cache line holding `address` is about to be read. GCC and
+ * Clang use __builtin_prefetch, MSVC _mm_prefetch (x86) or __prefetch
+ * (ARM64); elsewhere it does nothing.
+ *
+ * @complexity O(1)
+ */
+inline void prefetchRead(const void *address) {
+#if defined(_MSC_VER) && !defined(__clang__)
+#if defined(_M_X64) || defined(_M_IX86)
+  _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#elif defined(_M_ARM64)
+  __prefetch(address);
+#else
+  (void)address;
+#endif
+#else
+  __builtin_prefetch(address);
+#endif
+}
+
+#endif // BIT_SCAN_CPP
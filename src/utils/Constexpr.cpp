@@ -0,0 +1,29 @@
+#ifndef CONSTEXPR_CPP
+#define CONSTEXPR_CPP
+
+#include <type_traits>
+
+// Marks functions that can only be constant-evaluated from C++20 on, when
+// std::swap, std::iter_swap and friends became constexpr; empty in C++17.
+#if __cplusplus >= 202002L
+#define CONSTEXPR20 constexpr
+#else
+#define CONSTEXPR20
+#endif
+
+/**
+ * Whether the call happens during constant evaluation, so that SIMD and
+ * other non-constexpr fast paths can step aside. Always false before
+ * C++20, where the callers are not constexpr anyway.
+ *
+ * @complexity O(1)
+ */
+constexpr bool isConstantEvaluated() noexcept {
+#if __cplusplus >= 202002L
+  return std::is_constant_evaluated();
+#else
+  return false;
+#endif
+}
+
+#endif // CONSTEXPR_CPP
@@ -0,0 +1,86 @@
+#ifndef OPERATION_STATS_CPP
+#define OPERATION_STATS_CPP
+
+#include <cstddef>
+
+/**
+ * Counters collected by the CountingStats policy.
+ *
+ * - comparisons: element comparisons (==, < or the comparator).
+ * - moves: element moves and copies made while shifting or merging.
+ * - reallocations: buffer reallocations.
+ */
+struct OperationCounts {
+  size_t comparisons = 0;
+  size_t moves = 0;
+  size_t reallocations = 0;
+};
+
+/**
+ * Stats policy that records nothing. Every hook is an empty inline function
+ * and the type has no members, so containers inheriting from it keep their
+ * size and the calls compile away.
+ */
+struct NoStats {
+  static constexpr bool enabled = false;
+
+  void addComparisons(size_t) const {}
+  void addMoves(size_t) const {}
+  void addReallocation() const {}
+
+  const OperationCounts &stats() const {
+    static const OperationCounts none;
+    return none;
+  }
+
+  void resetStats() {}
+};
+
+/**
+ * Stats policy that counts operations. The hooks are const so that const
+ * lookups such as `find` can report their comparisons; the counters are
+ * plain integers, so a counted instance must not be used from several
+ * threads at once.
+ */
+struct CountingStats {
+  static constexpr bool enabled = true;
+
+  mutable OperationCounts counts;
+
+  void addComparisons(size_t count) const { counts.comparisons += count; }
+  void addMoves(size_t count) const { counts.moves += count; }
+  void addReallocation() const { ++counts.reallocations; }
+
+  const OperationCounts &stats() const { return counts; }
+
+  void resetStats() { counts = OperationCounts(); }
+};
+
+/**
+ * Comparator adapter that reports every call to a stats policy, used to
+ * instrument the sorting functions without touching their inner loops.
+ *
+ * A sorting or selection function with a trailing `const Stats &stats`
+ * parameter wraps its comparator in a CountingCompare and calls the plain
+ * version, so it reports every comparison to `stats` and keeps the plain
+ * version's complexity. With NoStats the hook is empty and the counting
+ * compiles away.
+ */
+template <typename Compare, typename Stats> struct CountingCompare {
+  Compare comp;
+  const Stats *statistics;
+
+  template <typename A, typename B>
+  bool operator()(const A &a, const B &b) const {
+    statistics->addComparisons(1);
+    return comp(a, b);
+  }
+};
+
+template <typename Compare, typename Stats>
+CountingCompare<Compare, Stats> countingCompare(Compare comp,
+                                                const Stats &statistics) {
+  return {comp, &statistics};
+}
+
+#endif // OPERATION_STATS_CPP
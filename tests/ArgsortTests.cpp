@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/ColumnarArray.cpp"
+#include "../src/sortings/Argsort.cpp"
+
+namespace {
+
+struct Record {
+  int64_t key;
+  std::string payload;
+};
+
+// Indices 0..n-1 stably sorted by `values` under `comp`: the expected
+// argsort.
+template <typename T, typename Compare>
+std::vector<size_t> stableOrder(const std::vector<T> &values, Compare comp) {
+  std::vector<size_t> order(values.size());
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return comp(values[a], values[b]);
+  });
+
+  return order;
+}
+
+std::vector<int64_t> randomKeys(size_t count, int64_t range) {
+  std::mt19937 random(27);
+  std::vector<int64_t> keys(count);
+
+  for (int64_t &key : keys) {
+    key = static_cast<int64_t>(random() % range) - range / 2;
+  }
+
+  return keys;
+}
+
+} // namespace
+
+TEST_CASE("argsort is the stable sorting permutation", "[Argsort]") {
+  for (size_t size : {0, 1, 10, 1000}) {
+    std::vector<int64_t> keys = randomKeys(size, 20);
+    REQUIRE(argsort(keys.begin(), keys.end()) ==
+            stableOrder(keys, std::less<int64_t>()));
+    REQUIRE(argsort(keys.begin(), keys.end(), std::greater<int64_t>()) ==
+            stableOrder(keys, std::greater<int64_t>()));
+  }
+}
+
+TEST_CASE("argsortByKey is stable below and above the radix threshold",
+          "[Argsort]") {
+  // Below argsortRadixThreshold the entries are compared, from it on the
+  // integral keys are radix sorted; either way ties keep index order.
+  for (size_t size : {size_t(argsortRadixThreshold) - 1,
+                      size_t(argsortRadixThreshold), size_t(5000)}) {
+    for (int64_t range : {int64_t(8), int64_t(1) << 40}) {
+      std::vector<int64_t> keys = randomKeys(size, range);
+      std::vector<Record> records(size);
+
+      for (size_t i = 0; i < size; ++i) {
+        records[i] = {keys[i], std::to_string(i)};
+      }
+
+      auto keyOf = [](const Record &record) { return record.key; };
+      REQUIRE(argsortByKey(records.begin(), records.end(), keyOf) ==
+              stableOrder(keys, std::less<int64_t>()));
+      REQUIRE(argsortByKey(records.begin(), records.end(), keyOf,
+                           std::greater<int64_t>()) ==
+              stableOrder(keys, std::greater<int64_t>()));
+
+      std::vector<size_t> order = stableOrder(keys, std::less<int64_t>());
+      sortByKey(records.begin(), records.end(), keyOf);
+
+      for (size_t i = 0; i < size; ++i) {
+        REQUIRE(records[i].key == keys[order[i]]);
+        REQUIRE(records[i].payload == std::to_string(order[i]));
+      }
+    }
+  }
+}
+
+TEST_CASE("applyPermutation rejects what is not a permutation",
+          "[Argsort]") {
+  std::vector<std::string> values{"a", "b", "c", "d"};
+
+  std::vector<std::string> permuted = values;
+  applyPermutation(permuted.begin(), permuted.end(), {2, 0, 3, 1});
+  REQUIRE(permuted == std::vector<std::string>{"c", "a", "d", "b"});
+
+  for (std::vector<size_t> order : {std::vector<size_t>{0, 1, 2},
+                                    std::vector<size_t>{1, 0, 3, 4},
+                                    std::vector<size_t>{1, 1, 2, 3},
+                                    std::vector<size_t>{2, 0, 2, 1}}) {
+    std::vector<std::string> attempt = values;
+    REQUIRE_THROWS_AS(
+        applyPermutation(attempt.begin(), attempt.end(), order),
+        std::invalid_argument);
+
+    // Whatever the order left behind, no element was lost or duplicated.
+    if (order.size() == values.size()) {
+      std::sort(attempt.begin(), attempt.end());
+      REQUIRE(attempt == values);
+    }
+  }
+}
+
+TEST_CASE("ColumnarArray::sort keeps the columns aligned", "[Argsort]") {
+  using Table = ColumnarArray<int64_t, std::string, double>;
+  std::vector<int64_t> keys = randomKeys(1000, 30);
+
+  // Row i holds (keys[i], "i", i).
+  auto makeTable = [&keys] {
+    Table table;
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      table.push_back(keys[i], std::to_string(i), static_cast<double>(i));
+    }
+
+    return table;
+  };
+
+  auto checkRows = [&keys](const Table &table,
+                           const std::vector<size_t> &order) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      REQUIRE(table.getKey(i) == keys[order[i]]);
+      REQUIRE(table.get<0>(i) == std::to_string(order[i]));
+      REQUIRE(table.get<1>(i) == static_cast<double>(order[i]));
+    }
+  };
+
+  Table ascending = makeTable();
+  ascending.sort();
+  checkRows(ascending, stableOrder(keys, std::less<int64_t>()));
+
+  Table descending = makeTable();
+  descending.sort(std::greater<int64_t>());
+  checkRows(descending, stableOrder(keys, std::greater<int64_t>()));
+
+  size_t positive = static_cast<size_t>(std::count_if(
+      keys.begin(), keys.end(), [](int64_t key) { return key > 0; }));
+  REQUIRE(descending.lowerBound(0, std::greater<int64_t>()) == positive);
+}
@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/ChunkedOrderedArray.cpp"
+
+TEST_CASE("ChunkedOrderedArray matches std::multiset",
+          "[ChunkedOrderedArray]") {
+  std::mt19937 random(1);
+  ChunkedOrderedArray<int> array(8);
+  std::multiset<int> reference;
+
+  for (int step = 0; step < 20000; ++step) {
+    if (reference.empty() || random() % 5 < 3) {
+      int value = static_cast<int>(random() % 2000);
+      array.insert(value);
+      reference.insert(value);
+    } else {
+      size_t index = random() % reference.size();
+      array.remove(index);
+      reference.erase(std::next(reference.begin(), index));
+    }
+
+    if (step % 1000 == 0) {
+      std::vector<int> expected(reference.begin(), reference.end());
+      REQUIRE(array.getSize() == expected.size());
+      REQUIRE(std::vector<int>(array.begin(), array.end()) == expected);
+
+      for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(array.get(i) == expected[i]);
+      }
+
+      for (int key = -1; key <= 2000; key += 13) {
+        size_t lower = std::lower_bound(expected.begin(), expected.end(),
+                                        key) -
+                       expected.begin();
+        size_t upper = std::upper_bound(expected.begin(), expected.end(),
+                                        key) -
+                       expected.begin();
+        REQUIRE(array.lowerBound(key) == lower);
+        REQUIRE(array.upperBound(key) == upper);
+        REQUIRE(array.find(key) ==
+                (lower < upper ? lower : ChunkedOrderedArray<int>::npos));
+      }
+    }
+  }
+}
+
+TEST_CASE("ChunkedOrderedArray const lookups are safe from several threads",
+          "[ChunkedOrderedArray]") {
+  std::vector<int> values(50000);
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<int>(2 * i);
+  }
+
+  ChunkedOrderedArray<int> array(64);
+  array.insertRange(values.begin(), values.end());
+  array.remove(0);
+  array.insert(1);
+
+  const ChunkedOrderedArray<int> &shared = array;
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> readers;
+
+  for (int r = 0; r < 4; ++r) {
+    readers.emplace_back([&shared, &mismatches, r] {
+      for (size_t i = r; i < shared.getSize(); i += 7) {
+        int value = shared.get(i);
+
+        if (shared.find(value) != i || shared.lowerBound(value) != i) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+
+  for (std::thread &thread : readers) {
+    thread.join();
+  }
+
+  REQUIRE(mismatches.load() == 0);
+}
@@ -0,0 +1,124 @@
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/ConcurrentOrderedArray.cpp"
+
+namespace {
+
+using Array = ConcurrentOrderedArray<int>;
+
+std::vector<int> contents(const Array::Snapshot &snapshot) {
+  std::vector<int> values;
+
+  for (size_t b = 0; b < snapshot.getBlockCount(); ++b) {
+    ArrayView<int> block = snapshot.getBlock(b);
+    values.insert(values.end(), block.begin(), block.end());
+  }
+
+  return values;
+}
+
+// Queues `count` random updates on both `array` and `reference`, removing
+// existing and missing keys as well as inserting.
+void queueUpdates(Array &array, std::multiset<int> &reference,
+                  std::mt19937 &random, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    int value = static_cast<int>(random() % 500);
+
+    if (random() % 3 == 0) {
+      array.remove(value);
+      auto it = reference.find(value);
+
+      if (it != reference.end()) {
+        reference.erase(it);
+      }
+    } else {
+      array.insert(value);
+      reference.insert(value);
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("ConcurrentOrderedArray snapshots match std::multiset",
+          "[ConcurrentOrderedArray]") {
+  Array array(4, 8);
+  std::multiset<int> reference;
+  std::mt19937 random(1);
+
+  for (int round = 0; round < 200; ++round) {
+    queueUpdates(array, reference, random, 1 + random() % 40);
+    array.publish();
+
+    const Array::Snapshot &snapshot = array.current();
+    std::vector<int> expected(reference.begin(), reference.end());
+    REQUIRE(snapshot.getSize() == expected.size());
+    REQUIRE(contents(snapshot) == expected);
+
+    for (int key = -1; key <= 500; key += 7) {
+      size_t lower = std::lower_bound(expected.begin(), expected.end(), key) -
+                     expected.begin();
+      size_t upper = std::upper_bound(expected.begin(), expected.end(), key) -
+                     expected.begin();
+      REQUIRE(snapshot.lowerBound(key) == lower);
+      REQUIRE(snapshot.upperBound(key) == upper);
+      REQUIRE(snapshot.find(key) ==
+              (lower < upper ? lower : Array::Snapshot::npos));
+    }
+  }
+}
+
+TEST_CASE("ConcurrentOrderedArray readers see whole published batches",
+          "[ConcurrentOrderedArray]") {
+  constexpr int rounds = 300;
+  constexpr int readerCount = 3;
+  Array array(readerCount, 16);
+  std::multiset<int> reference;
+  std::mt19937 random(2);
+
+  // expected[v] is written before version v is published and only read
+  // once a reader holds that version.
+  std::vector<std::vector<int>> expected(rounds + 1);
+  std::atomic<bool> done{false};
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> readers;
+
+  for (int r = 0; r < readerCount; ++r) {
+    readers.emplace_back([&] {
+      Array::Reader reader(array);
+
+      while (!done.load()) {
+        reader.read([&](const Array::Snapshot &snapshot) {
+          if (contents(snapshot) != expected[snapshot.getVersion()]) {
+            ++mismatches;
+          }
+
+          return 0;
+        });
+      }
+    });
+  }
+
+  for (int round = 1; round <= rounds; ++round) {
+    queueUpdates(array, reference, random, 1 + random() % 20);
+    expected[round].assign(reference.begin(), reference.end());
+    REQUIRE(array.publish() == static_cast<uint64_t>(round));
+  }
+
+  done.store(true);
+
+  for (std::thread &thread : readers) {
+    thread.join();
+  }
+
+  REQUIRE(mismatches.load() == 0);
+  array.reclaim();
+  REQUIRE(array.getRetiredCount() == 0);
+}
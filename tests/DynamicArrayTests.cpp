@@ -0,0 +1,348 @@
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/DynamicArray.cpp"
+
+namespace {
+
+// Contents of `array` as a std::vector, for comparisons.
+template <typename Array>
+std::vector<std::string> contents(const Array &array) {
+  return std::vector<std::string>(array.begin(), array.end());
+}
+
+// Small array holding "0", "1", ... up to `count` elements.
+SmallDynamicArray<std::string, 4> numbered(size_t count) {
+  SmallDynamicArray<std::string, 4> array;
+
+  for (size_t i = 0; i < count; ++i) {
+    array.push_back(std::to_string(i));
+  }
+
+  return array;
+}
+
+// Move constructor that may throw, which inline storage has to respect.
+struct ThrowingMove {
+  ThrowingMove() = default;
+  ThrowingMove(const ThrowingMove &) = default;
+  ThrowingMove(ThrowingMove &&) noexcept(false) {}
+  ThrowingMove &operator=(const ThrowingMove &) = default;
+  ThrowingMove &operator=(ThrowingMove &&) noexcept(false) { return *this; }
+};
+
+// Memory resource counting the bytes it currently has handed out.
+class CountingResource : public std::pmr::memory_resource {
+public:
+  size_t outstanding = 0;
+
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *pointer, size_t bytes, size_t alignment) override {
+    outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// Stateful allocator that propagates on copy, move and swap; two
+// instances are equal only with the same id.
+template <typename T> struct PropagatingAllocator {
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  int id;
+
+  explicit PropagatingAllocator(int id = 0) : id(id) {}
+
+  template <typename U>
+  PropagatingAllocator(const PropagatingAllocator<U> &other) : id(other.id) {}
+
+  T *allocate(size_t count) { return std::allocator<T>().allocate(count); }
+
+  void deallocate(T *pointer, size_t count) {
+    std::allocator<T>().deallocate(pointer, count);
+  }
+
+  bool operator==(const PropagatingAllocator &other) const {
+    return id == other.id;
+  }
+
+  bool operator!=(const PropagatingAllocator &other) const {
+    return id != other.id;
+  }
+};
+
+} // namespace
+
+TEST_CASE("insert at an index copies a value that refers into the array",
+          "[DynamicArray]") {
+  DynamicArray<std::string> array;
+  array.reserve(4);
+
+  for (const char *word : {"alpha", "bravo", "charlie", "delta"}) {
+    array.push_back(word);
+  }
+
+  REQUIRE(array.getSize() == array.getCapacity());
+
+  SECTION("growing") { array.insert(0, array.getAt(1)); }
+
+  SECTION("in place") {
+    array.remove(3);
+    array.insert(0, array.getAt(1));
+    array.push_back("delta");
+  }
+
+  REQUIRE(array.getAt(0) == "bravo");
+  REQUIRE(array.getAt(1) == "alpha");
+  REQUIRE(array.getAt(2) == "bravo");
+  REQUIRE(array.getAt(3) == "charlie");
+  REQUIRE(array.getAt(4) == "delta");
+}
+
+TEST_CASE("SmallDynamicArray keeps up to N elements inline",
+          "[DynamicArray]") {
+  SmallDynamicArray<std::string, 4> array;
+  REQUIRE(array.isInline());
+  REQUIRE(array.getCapacity() == 4);
+
+  for (int i = 0; i < 4; ++i) {
+    array.push_back(std::string(40, char('a' + i)));
+  }
+
+  REQUIRE(array.isInline());
+  array.push_back("spill");
+  REQUIRE_FALSE(array.isInline());
+  REQUIRE(array.getCapacity() > 4);
+  REQUIRE(array.getAt(0) == std::string(40, 'a'));
+  REQUIRE(array.getAt(4) == "spill");
+
+  // Shrinking back to at most N elements returns to the inline storage.
+  array.remove(0);
+  array.remove(0);
+  array.shrink_to_fit();
+  REQUIRE(array.isInline());
+  REQUIRE(array.getCapacity() == 4);
+  REQUIRE(contents(array) ==
+          std::vector<std::string>{std::string(40, 'c'),
+                                   std::string(40, 'd'), "spill"});
+
+  SmallDynamicArray<std::string, 4> fromList{"x", "y"};
+  REQUIRE(fromList.isInline());
+}
+
+TEST_CASE("SmallDynamicArray moves between inline and heap storage",
+          "[DynamicArray]") {
+  SECTION("move construction from inline storage") {
+    SmallDynamicArray<std::string, 4> source = numbered(3);
+    SmallDynamicArray<std::string, 4> moved(std::move(source));
+    REQUIRE(moved.isInline());
+    REQUIRE(contents(moved) == std::vector<std::string>{"0", "1", "2"});
+    REQUIRE(source.getSize() == 0);
+    REQUIRE(source.isInline());
+  }
+
+  SECTION("move construction steals a heap buffer") {
+    SmallDynamicArray<std::string, 4> source = numbered(6);
+    const std::string *buffer = source.begin();
+    SmallDynamicArray<std::string, 4> moved(std::move(source));
+    REQUIRE(moved.begin() == buffer);
+    REQUIRE(source.getSize() == 0);
+    REQUIRE(source.isInline());
+    source.push_back("reused");
+    REQUIRE(contents(source) == std::vector<std::string>{"reused"});
+  }
+
+  SECTION("move assignment across storage kinds") {
+    SmallDynamicArray<std::string, 4> heap = numbered(8);
+    SmallDynamicArray<std::string, 4> small = numbered(2);
+    heap = std::move(small);
+    REQUIRE(heap.isInline());
+    REQUIRE(contents(heap) == std::vector<std::string>{"0", "1"});
+
+    SmallDynamicArray<std::string, 4> target = numbered(1);
+    target = numbered(7);
+    REQUIRE_FALSE(target.isInline());
+    REQUIRE(target.getSize() == 7);
+    REQUIRE(target.getAt(6) == "6");
+  }
+
+  SECTION("swap") {
+    for (size_t leftSize : {0, 3, 9}) {
+      for (size_t rightSize : {0, 4, 6}) {
+        SmallDynamicArray<std::string, 4> left = numbered(leftSize);
+        SmallDynamicArray<std::string, 4> right = numbered(rightSize);
+        std::vector<std::string> leftBefore = contents(left);
+        std::vector<std::string> rightBefore = contents(right);
+
+        swap(left, right);
+        REQUIRE(contents(left) == rightBefore);
+        REQUIRE(contents(right) == leftBefore);
+        REQUIRE(left.isInline() == (rightSize <= 4));
+        REQUIRE(right.isInline() == (leftSize <= 4));
+      }
+    }
+  }
+}
+
+TEST_CASE("pmr::DynamicArray keeps its own resource when moved into",
+          "[DynamicArray]") {
+  CountingResource left;
+  CountingResource right;
+
+  SECTION("unequal resources move the elements one by one") {
+    pmr::DynamicArray<std::string> target(&left);
+    target.push_back("old");
+    pmr::DynamicArray<std::string> source(&right);
+
+    for (int i = 0; i < 10; ++i) {
+      source.push_back(std::string(30, char('a' + i)));
+    }
+
+    const std::string *sourceBuffer = source.begin();
+    size_t rightBytes = right.outstanding;
+    target = std::move(source);
+
+    REQUIRE(target.getAllocator().resource() == &left);
+    REQUIRE(target.begin() != sourceBuffer);
+    REQUIRE(target.getSize() == 10);
+    REQUIRE(target.getAt(9) == std::string(30, 'j'));
+    REQUIRE(source.getSize() == 0);
+    REQUIRE(source.getAllocator().resource() == &right);
+    REQUIRE(right.outstanding == rightBytes);
+  }
+
+  SECTION("equal resources take over the buffer") {
+    pmr::DynamicArray<std::string> target(&left);
+    target.push_back("old");
+    pmr::DynamicArray<std::string> source(&left);
+    source.push_back("new");
+    const std::string *sourceBuffer = source.begin();
+
+    target = std::move(source);
+    REQUIRE(target.begin() == sourceBuffer);
+    REQUIRE(contents(target) == std::vector<std::string>{"new"});
+  }
+
+  SECTION("copies use the default resource, assignment keeps its own") {
+    pmr::DynamicArray<std::string> original(&left);
+    original.push_back("value");
+
+    pmr::DynamicArray<std::string> copy(original);
+    REQUIRE(copy.getAllocator().resource() ==
+            std::pmr::get_default_resource());
+
+    pmr::DynamicArray<std::string> assigned(&right);
+    assigned = original;
+    REQUIRE(assigned.getAllocator().resource() == &right);
+    REQUIRE(contents(assigned) == std::vector<std::string>{"value"});
+  }
+
+  REQUIRE(left.outstanding == 0);
+  REQUIRE(right.outstanding == 0);
+}
+
+TEST_CASE("Propagating allocators follow the elements", "[DynamicArray]") {
+  using Array = DynamicArray<std::string, NoStats, 0,
+                             PropagatingAllocator<std::string>>;
+
+  Array first{{"a", "b"}, PropagatingAllocator<std::string>(1)};
+  Array second{{"c"}, PropagatingAllocator<std::string>(2)};
+
+  SECTION("copy assignment") {
+    first = second;
+    REQUIRE(first.getAllocator().id == 2);
+    REQUIRE(contents(first) == std::vector<std::string>{"c"});
+  }
+
+  SECTION("move assignment") {
+    const std::string *buffer = second.begin();
+    first = std::move(second);
+    REQUIRE(first.getAllocator().id == 2);
+    REQUIRE(first.begin() == buffer);
+  }
+
+  SECTION("swap") {
+    swap(first, second);
+    REQUIRE(first.getAllocator().id == 2);
+    REQUIRE(second.getAllocator().id == 1);
+    REQUIRE(contents(first) == std::vector<std::string>{"c"});
+    REQUIRE(contents(second) == std::vector<std::string>{"a", "b"});
+  }
+}
+
+TEST_CASE("DynamicArray moves and swaps are noexcept where they can be",
+          "[DynamicArray]") {
+  using Strings = DynamicArray<std::string>;
+  using SmallStrings = SmallDynamicArray<std::string, 4>;
+  using SmallThrowing = SmallDynamicArray<ThrowingMove, 4>;
+  using PmrStrings = pmr::DynamicArray<std::string>;
+
+  static_assert(std::is_nothrow_move_constructible<Strings>::value);
+  static_assert(std::is_nothrow_move_assignable<Strings>::value);
+  static_assert(std::is_nothrow_swappable<Strings>::value);
+  static_assert(std::is_nothrow_move_constructible<SmallStrings>::value);
+  static_assert(std::is_nothrow_swappable<SmallStrings>::value);
+  static_assert(std::is_nothrow_move_constructible<
+                DynamicArray<ThrowingMove>>::value);
+
+  // Inline elements are moved one by one, with T's own guarantee.
+  static_assert(!std::is_nothrow_move_constructible<SmallThrowing>::value);
+  static_assert(!std::is_nothrow_swappable<SmallThrowing>::value);
+
+  // Unequal pmr resources move element by element, which can allocate.
+  static_assert(std::is_nothrow_move_constructible<PmrStrings>::value);
+  static_assert(!std::is_nothrow_move_assignable<PmrStrings>::value);
+
+  // std::vector relocates the arrays by moving, keeping their buffers.
+  std::vector<Strings> arrays(1);
+  arrays[0].push_back("kept");
+  const std::string *buffer = arrays[0].begin();
+
+  for (int i = 0; i < 100; ++i) {
+    arrays.emplace_back();
+  }
+
+  REQUIRE(arrays[0].begin() == buffer);
+}
+
+TEST_CASE("Moved-from and self-assigned DynamicArrays stay usable",
+          "[DynamicArray]") {
+  DynamicArray<std::string> array{"a", "b", "c"};
+  DynamicArray<std::string> moved(std::move(array));
+  REQUIRE(array.getSize() == 0);
+  array.push_back("again");
+  REQUIRE(contents(array) == std::vector<std::string>{"again"});
+
+  DynamicArray<std::string> &alias = moved;
+  moved = std::move(alias);
+  REQUIRE(contents(moved) == std::vector<std::string>{"a", "b", "c"});
+
+  swap(moved, moved);
+  REQUIRE(contents(moved) == std::vector<std::string>{"a", "b", "c"});
+
+  swap(moved, array);
+  REQUIRE(contents(moved) == std::vector<std::string>{"again"});
+  REQUIRE(contents(array) == std::vector<std::string>{"a", "b", "c"});
+
+  DynamicArray<std::string> copy(array);
+  copy.setAt(0, "changed");
+  REQUIRE(array.getAt(0) == "a");
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/sortings/ExternalSort.cpp"
+
+namespace {
+
+// Path of a scratch file in the temporary directory.
+std::string scratchPath(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// A budget of 512-element chunks and 128-element blocks: every few hundred
+// elements spill a run, and more than three runs need a merge pass first.
+ExternalSortOptions tinyBudget() {
+  ExternalSortOptions options;
+  options.memoryBytes = 4096;
+  options.bufferBytes = 512;
+
+  return options;
+}
+
+std::vector<uint32_t> randomValues(size_t count, uint32_t range) {
+  std::mt19937 random(23);
+  std::vector<uint32_t> values(count);
+
+  for (uint32_t &value : values) {
+    value = static_cast<uint32_t>(random() % range);
+  }
+
+  return values;
+}
+
+void writeValues(const std::string &path,
+                 const std::vector<uint32_t> &values) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(values.data()),
+            values.size() * sizeof(uint32_t));
+}
+
+std::vector<uint32_t> readValues(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  std::vector<uint32_t> values(std::filesystem::file_size(path) /
+                               sizeof(uint32_t));
+  in.read(reinterpret_cast<char *>(values.data()),
+          values.size() * sizeof(uint32_t));
+
+  return values;
+}
+
+} // namespace
+
+TEST_CASE("externalSort matches std::sort with spills and merge passes",
+          "[ExternalSort]") {
+  for (size_t count : {0, 1, 511, 512, 513, 3000, 20000}) {
+    for (uint32_t range : {5u, 1000000u}) {
+      std::vector<uint32_t> values = randomValues(count, range);
+      std::vector<uint32_t> expected = values;
+      std::sort(expected.begin(), expected.end());
+
+      size_t maxRuns = 0;
+      ExternalSortOptions options = tinyBudget();
+      options.progress = [&maxRuns](const ExternalSortProgress &progress) {
+        maxRuns = std::max(maxRuns, progress.runs);
+      };
+
+      std::vector<uint32_t> sorted;
+      externalSort(values.begin(), values.end(), std::back_inserter(sorted),
+                   std::less<uint32_t>(), options);
+      REQUIRE(sorted == expected);
+      REQUIRE(maxRuns == (count < 512 ? 0 : (count + 511) / 512));
+    }
+  }
+}
+
+TEST_CASE("externalSort follows the comparator", "[ExternalSort]") {
+  std::vector<uint32_t> values = randomValues(5000, 100);
+  std::vector<uint32_t> expected = values;
+  std::sort(expected.begin(), expected.end(), std::greater<uint32_t>());
+
+  std::vector<uint32_t> sorted;
+  externalSort(values.begin(), values.end(), std::back_inserter(sorted),
+               std::greater<uint32_t>(), tinyBudget());
+  REQUIRE(sorted == expected);
+}
+
+TEST_CASE("externalSortFile sorts a file, also in place", "[ExternalSort]") {
+  std::string input = scratchPath("external_sort_input.bin");
+  std::string output = scratchPath("external_sort_output.bin");
+  std::vector<uint32_t> values = randomValues(10000, 1000000);
+  std::vector<uint32_t> expected = values;
+  std::sort(expected.begin(), expected.end());
+  writeValues(input, values);
+
+  externalSortFile<uint32_t>(input, output, tinyBudget());
+  REQUIRE(readValues(output) == expected);
+  REQUIRE(readValues(input) == values);
+
+  externalSortFile<uint32_t>(input, input, tinyBudget());
+  REQUIRE(readValues(input) == expected);
+  REQUIRE_FALSE(std::filesystem::exists(input + ".tmp"));
+
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+}
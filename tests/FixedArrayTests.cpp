@@ -0,0 +1,113 @@
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/FixedArray.cpp"
+#include "../src/data_structures/array/FixedOrderedArray.cpp"
+#include "../src/sortings/HeapSort.cpp"
+#include "../src/sortings/InsertionSort.cpp"
+
+namespace {
+
+// Squares of 0..N-1, filled by a constexpr function as a generated table
+// would be.
+template <size_t N> constexpr FixedArray<int, N> squares() {
+  FixedArray<int, N> table;
+
+  for (size_t i = 0; i < N; ++i) {
+    table.push_back(static_cast<int>(i * i));
+  }
+
+  return table;
+}
+
+// A FixedArray edited through every mutator during constant evaluation.
+constexpr FixedArray<int, 8> edited() {
+  FixedArray<int, 8> array{1, 2, 4};
+  array.insert(2, 3);
+  array.push_back(5);
+  array.setAt(0, 0);
+  array.remove(1);
+
+  return array; // 0 3 4 5
+}
+
+// A FixedOrderedArray built by single inserts and removals.
+constexpr FixedOrderedArray<int, 8> inserted() {
+  FixedOrderedArray<int, 8> array;
+
+  for (int value : {50, 10, 40, 20, 30, 20}) {
+    array.insert(value);
+  }
+
+  array.remove(array.find(40));
+
+  return array; // 10 20 20 30 50
+}
+
+// The free sorts on a plain array, during constant evaluation.
+template <typename Sort> constexpr bool sortsDigits(Sort sort) {
+  int digits[] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  sort(digits, digits + 10);
+
+  for (size_t i = 1; i < 10; ++i) {
+    if (digits[i] < digits[i - 1]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+constexpr FixedArray<int, 16> table = squares<16>();
+constexpr FixedArray<int, 8> mutated = edited();
+constexpr FixedOrderedArray<int, 4> primes{7, 2, 5, 3};
+constexpr FixedOrderedArray<int, 4, std::greater<int>> descending{7, 2, 5,
+                                                                   3};
+constexpr FixedOrderedArray<int, 8> ordered = inserted();
+
+} // namespace
+
+// Everything below is checked by the compiler.
+static_assert(table.getSize() == 16 && table.isFull());
+static_assert(table.getAt(15) == 225);
+static_assert(table.find(49) == 7);
+static_assert(table.find(50) == FixedArray<int, 16>::npos);
+static_assert(table.view().getSize() == 16);
+
+static_assert(mutated.getSize() == 4);
+static_assert(mutated.getAt(0) == 0 && mutated.getAt(1) == 3 &&
+              mutated.getAt(2) == 4 && mutated.getAt(3) == 5);
+
+static_assert(primes.contains(5));
+static_assert(!primes.contains(4));
+static_assert(primes.get(0) == 2 && primes.get(3) == 7);
+static_assert(primes.find(7) == 3);
+static_assert(primes.lowerBound(4) == 2 && primes.upperBound(5) == 3);
+static_assert(primes.range(3, 7).getSize() == 2);
+
+static_assert(descending.get(0) == 7 && descending.get(3) == 2);
+static_assert(descending.find(2) == 3);
+
+static_assert(ordered.getSize() == 5);
+static_assert(ordered.lowerBound(20) == 1 && ordered.upperBound(20) == 3);
+static_assert(!ordered.contains(40));
+
+static_assert(sortsDigits([](int *first, int *last) {
+  heapSort(first, last, std::less<int>());
+}));
+static_assert(sortsDigits([](int *first, int *last) {
+  insertionSort(first, last, std::less<int>());
+}));
+
+TEST_CASE("Fixed arrays throw when full at run time", "[FixedArray]") {
+  FixedArray<int, 2> array{1, 2};
+  REQUIRE_THROWS_AS(array.push_back(3), std::length_error);
+  REQUIRE_THROWS_AS(array.getAt(2), std::out_of_range);
+
+  FixedOrderedArray<int, 2> ordered{2, 1};
+  REQUIRE_THROWS_AS(ordered.insert(3), std::length_error);
+  REQUIRE(ordered.get(0) == 1);
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/LearnedIndex.cpp"
+#include "../src/data_structures/array/OrderedArray.cpp"
+
+namespace {
+
+// Checks both bounds of every stored key and of `probes` against
+// std::lower_bound and std::upper_bound.
+template <typename T>
+void checkBounds(std::vector<T> keys, const std::vector<T> &probes,
+                 size_t epsilon) {
+  std::sort(keys.begin(), keys.end());
+  LearnedIndex<T> index;
+  index.build(keys.data(), keys.size(), epsilon);
+  auto less = [](const T &a, const T &b) { return a < b; };
+
+  auto check = [&](const T &key) {
+    size_t lower =
+        std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+    size_t upper =
+        std::upper_bound(keys.begin(), keys.end(), key) - keys.begin();
+    REQUIRE(index.bound(keys.data(), keys.size(), key, false, less) == lower);
+    REQUIRE(index.bound(keys.data(), keys.size(), key, true, less) == upper);
+  };
+
+  for (const T &key : keys) {
+    check(key);
+  }
+
+  for (const T &key : probes) {
+    check(key);
+  }
+}
+
+template <typename T> std::vector<T> extremes() {
+  return {std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max(),
+          T(0), T(1)};
+}
+
+} // namespace
+
+TEST_CASE("LearnedIndex bounds match std on uniform keys", "[LearnedIndex]") {
+  std::mt19937_64 random(1);
+  std::vector<uint64_t> keys;
+
+  for (int i = 0; i < 200000; ++i) {
+    keys.push_back(random() % 100000000000ULL);
+  }
+
+  std::vector<uint64_t> probes = extremes<uint64_t>();
+
+  for (int i = 0; i < 20000; ++i) {
+    probes.push_back(random() % 100000000000ULL);
+  }
+
+  for (size_t epsilon : {1, 4, 16, 64}) {
+    checkBounds(keys, probes, epsilon);
+  }
+}
+
+TEST_CASE("LearnedIndex bounds match std on duplicate-heavy keys",
+          "[LearnedIndex]") {
+  std::mt19937_64 random(2);
+  std::vector<int32_t> keys;
+
+  for (int i = 0; i < 50000; ++i) {
+    keys.push_back(static_cast<int32_t>(random() % 20) * 1000);
+  }
+
+  // One key repeated far beyond the window.
+  keys.insert(keys.end(), 10000, 7);
+  std::vector<int32_t> probes = extremes<int32_t>();
+
+  for (int32_t key = -1000; key <= 21000; key += 250) {
+    probes.push_back(key);
+  }
+
+  checkBounds(keys, probes, 2);
+  checkBounds(keys, probes, 16);
+  checkBounds(std::vector<int32_t>(1000, 5), probes, 16);
+}
+
+TEST_CASE("LearnedIndex bounds match std on extreme and skewed keys",
+          "[LearnedIndex]") {
+  std::mt19937_64 random(3);
+  std::vector<int64_t> signedKeys = extremes<int64_t>();
+  std::vector<uint64_t> unsignedKeys = extremes<uint64_t>();
+  std::vector<double> doubleKeys = extremes<double>();
+
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t bits = random();
+    signedKeys.push_back(static_cast<int64_t>(bits));
+    unsignedKeys.push_back(bits >> (bits % 64));
+    doubleKeys.push_back(static_cast<double>(i) * i * i);
+  }
+
+  checkBounds(signedKeys, extremes<int64_t>(), 16);
+  checkBounds(unsignedKeys, extremes<uint64_t>(), 16);
+  checkBounds(doubleKeys, {-0.5, 0.5, 1e300, -1e300}, 8);
+  checkBounds(std::vector<uint64_t>{42}, extremes<uint64_t>(), 16);
+}
+
+TEST_CASE("OrderedArray::freezeLearned keeps lookups exact",
+          "[LearnedIndex][OrderedArray]") {
+  std::mt19937_64 random(4);
+  std::vector<int64_t> keys;
+
+  for (int i = 0; i < 100000; ++i) {
+    keys.push_back(static_cast<int64_t>(random() % 1000000) - 500000);
+  }
+
+  OrderedArray<int64_t> plain;
+  plain.insertRange(keys.begin(), keys.end());
+  OrderedArray<int64_t> learned(plain);
+  learned.freezeLearned();
+  REQUIRE(learned.isFrozen());
+  REQUIRE(learned.getLearnedIndexBytes() > 0);
+  REQUIRE(learned.getLearnedIndexBytes() < keys.size() * sizeof(int64_t) / 10);
+
+  for (int i = 0; i < 20000; ++i) {
+    int64_t key = static_cast<int64_t>(random() % 1100000) - 550000;
+    REQUIRE(learned.lowerBound(key) == plain.lowerBound(key));
+    REQUIRE(learned.upperBound(key) == plain.upperBound(key));
+    REQUIRE(learned.find(key) == plain.find(key));
+  }
+
+  learned.insert(0);
+  REQUIRE_FALSE(learned.isFrozen());
+  REQUIRE(learned.getLearnedIndexBytes() == 0);
+}
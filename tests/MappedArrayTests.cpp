@@ -0,0 +1,147 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/MappedArray.cpp"
+
+namespace {
+
+// Path of a scratch file in the temporary directory.
+std::string scratchPath(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Orders ints by their last decimal digit, with a tag of its own.
+struct ByLastDigit {
+  bool operator()(int a, int b) const { return a % 10 < b % 10; }
+};
+
+} // namespace
+
+template <> struct ArrayFileOrder<ByLastDigit> {
+  static constexpr uint32_t value = arrayFileFirstCustomOrder;
+};
+
+TEST_CASE("MappedArray reads back a saved OrderedArray", "[MappedArray]") {
+  std::string path = scratchPath("mapped_array_ordered.arr");
+  OrderedArray<int> array{5, 3, 9, 1, 7};
+  saveArray(path, array);
+
+  {
+    MappedArray<int> mapped(path);
+    REQUIRE(mapped.isOrdered());
+    REQUIRE(mapped.getSize() == 5);
+
+    for (size_t i = 0; i < 5; ++i) {
+      REQUIRE(mapped.get(i) == array.get(i));
+    }
+
+    REQUIRE(mapped.find(7) == 3);
+    REQUIRE(mapped.find(4) == MappedArray<int>::npos);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("saveArray leaves out tombstoned elements", "[MappedArray]") {
+  std::string path = scratchPath("mapped_array_tombstones.arr");
+  OrderedArray<int> array{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  array.enableTombstones(0.5);
+  array.remove(array.find(3));
+  array.remove(array.find(4));
+  REQUIRE(array.getRemovedCount() == 2);
+  saveArray(path, array);
+
+  {
+    MappedArray<int> mapped(path);
+    REQUIRE(mapped.getSize() == 8);
+    REQUIRE(mapped.find(3) == MappedArray<int>::npos);
+    REQUIRE(mapped.find(4) == MappedArray<int>::npos);
+    REQUIRE(mapped.find(5) == 2);
+    REQUIRE(mapped.get(7) == 10);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("MappedArray rejects files saved in another order",
+          "[MappedArray]") {
+  std::string path = scratchPath("mapped_array_descending.arr");
+  OrderedArray<int, std::greater<int>> array{1, 2, 3, 4, 5};
+  saveArray(path, array);
+
+  REQUIRE_THROWS_AS(MappedArray<int>(path), std::runtime_error);
+  REQUIRE_THROWS_AS((MappedArray<int, ByLastDigit>(path)),
+                    std::runtime_error);
+
+  {
+    MappedArray<int, std::greater<int>> mapped(path);
+    REQUIRE(mapped.find(5) == 0);
+    REQUIRE(mapped.find(1) == 4);
+  }
+
+  {
+    MappedArray<int, std::greater<>> transparent(path);
+    REQUIRE(transparent.find(3) == 2);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("MappedArray checks the tag of custom orders", "[MappedArray]") {
+  std::string path = scratchPath("mapped_array_custom.arr");
+  OrderedArray<int, ByLastDigit> array({13, 21, 45, 32}, ByLastDigit());
+  saveArray(path, array);
+
+  REQUIRE_THROWS_AS(MappedArray<int>(path), std::runtime_error);
+
+  {
+    MappedArray<int, ByLastDigit> mapped(path);
+    REQUIRE(mapped.get(0) == 21);
+    REQUIRE(mapped.find(45) == 3);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("MappedArray rejects version 1 files", "[MappedArray]") {
+  std::string path = scratchPath("mapped_array_version1.arr");
+  saveArray(path, OrderedArray<int>{1, 2, 3});
+
+  {
+    // A version 1 file marked ordered and descending.
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    ArrayFileHeader header;
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    header.version = 1;
+    header.flags = 3;
+    header.order = 0;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+
+  REQUIRE_THROWS_AS(MappedArray<int>(path), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST_CASE("MappedArray maps unordered DynamicArray files with any order",
+          "[MappedArray]") {
+  std::string path = scratchPath("mapped_array_dynamic.arr");
+  DynamicArray<int> array;
+  array.push_back(4);
+  array.push_back(2);
+  array.push_back(9);
+  saveArray(path, array);
+
+  {
+    MappedArray<int, std::greater<int>> mapped(path);
+    REQUIRE_FALSE(mapped.isOrdered());
+    REQUIRE(mapped.find(9) == 2);
+  }
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,124 @@
+#include <cstdio>
+#include <filesystem>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/DynamicArray.cpp"
+#include "../src/data_structures/array/OperationTrace.cpp"
+#include "../src/data_structures/array/OrderedArray.cpp"
+
+namespace {
+
+// Path of a scratch file in the temporary directory.
+std::string scratchPath(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Operations of the events in the trace at `path`.
+std::vector<TraceOp> traceOps(const std::string &path) {
+  MappedArray<TraceEvent> trace(path);
+  std::vector<TraceOp> ops;
+
+  for (const TraceEvent &event : trace) {
+    ops.push_back(event.op);
+  }
+
+  return ops;
+}
+
+} // namespace
+
+TEST_CASE("TracedArray records the starting elements of an OrderedArray",
+          "[OperationTrace]") {
+  std::string path = scratchPath("operation_trace_ordered.trace");
+
+  {
+    TraceWriter writer(path, traceKeyType<int>());
+    TracedArray<OrderedArray<int>> traced(
+        writer, std::initializer_list<int>{3, 1, 2});
+    traced.insert(5);
+    REQUIRE_THROWS_AS(traced.remove(7), std::out_of_range);
+    traced.remove(0);
+    REQUIRE(traced.find(5) == 2);
+    writer.finish();
+  }
+
+  std::vector<TraceOp> expected{
+      TraceOp::Begin,  TraceOp::Insert, TraceOp::Insert, TraceOp::Insert,
+      TraceOp::Insert, TraceOp::Remove, TraceOp::Find};
+  REQUIRE(traceOps(path) == expected);
+
+  // Replaying onto an empty array ends with the traced contents.
+  {
+    MappedArray<TraceEvent> trace(path);
+    OrderedArray<int> replayed;
+
+    for (size_t i = 1; i < trace.getSize(); ++i) {
+      const TraceEvent &event = trace.get(i);
+
+      if (event.op == TraceOp::Insert) {
+        replayed.insert(traceKey<int>(event));
+      } else if (event.op == TraceOp::Remove) {
+        replayed.remove(event.index);
+      }
+    }
+
+    REQUIRE(replayed.getSize() == 3);
+    REQUIRE(replayed.get(0) == 2);
+    REQUIRE(replayed.get(1) == 3);
+    REQUIRE(replayed.get(2) == 5);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("TracedArray records a DynamicArray's contents as push_back",
+          "[OperationTrace]") {
+  std::string path = scratchPath("operation_trace_dynamic.trace");
+
+  {
+    TraceWriter writer(path, traceKeyType<int>());
+    TracedArray<DynamicArray<int>> traced(
+        writer, std::initializer_list<int>{4, 8});
+    REQUIRE_THROWS_AS(traced.setAt(2, 1), std::out_of_range);
+    REQUIRE_THROWS_AS(traced.getAt(5), std::out_of_range);
+    traced.push_back(6);
+    REQUIRE(traced.getAt(2) == 6);
+    writer.finish();
+  }
+
+  std::vector<TraceOp> expected{TraceOp::Begin, TraceOp::PushBack,
+                                TraceOp::PushBack, TraceOp::PushBack,
+                                TraceOp::GetAt};
+  REQUIRE(traceOps(path) == expected);
+
+  {
+    MappedArray<TraceEvent> trace(path);
+    REQUIRE((trace.getFlags() & arrayFileTrace) != 0);
+    REQUIRE(traceKey<int>(trace.get(1)) == 4);
+    REQUIRE(traceKey<int>(trace.get(2)) == 8);
+    REQUIRE(traceKey<int>(trace.get(3)) == 6);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("An array of TraceEvents saved without TraceWriter is not a trace",
+          "[OperationTrace]") {
+  std::string path = scratchPath("operation_trace_plain.trace");
+  TraceEvent begin{};
+  begin.op = TraceOp::Begin;
+  saveArrayFile(path, &begin, 1, 0);
+
+  {
+    MappedArray<TraceEvent> trace(path);
+    REQUIRE(trace.get(0).op == TraceOp::Begin);
+    REQUIRE((trace.getFlags() & arrayFileTrace) == 0);
+  }
+
+  std::remove(path.c_str());
+}
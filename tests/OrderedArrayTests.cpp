@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/OrderedArray.cpp"
+
+namespace {
+
+// Checks every index-based accessor of `array` against the sorted vector
+// `expected` of its live elements.
+void checkAgainst(const OrderedArray<int> &array,
+                  const std::vector<int> &expected) {
+  REQUIRE(array.getSize() == expected.size());
+  REQUIRE(std::vector<int>(array.begin(), array.end()) == expected);
+
+  for (size_t i = 0; i < expected.size(); ++i) {
+    REQUIRE(array.get(i) == expected[i]);
+  }
+
+  REQUIRE_THROWS_AS(array.get(expected.size()), std::out_of_range);
+
+  std::vector<int> keys;
+
+  for (int key = -2; key <= 1002; key += 3) {
+    size_t lower = std::lower_bound(expected.begin(), expected.end(), key) -
+                   expected.begin();
+    size_t upper = std::upper_bound(expected.begin(), expected.end(), key) -
+                   expected.begin();
+    REQUIRE(array.lowerBound(key) == lower);
+    REQUIRE(array.upperBound(key) == upper);
+    REQUIRE(array.equalRange(key) == std::make_pair(lower, upper));
+    REQUIRE(array.find(key) ==
+            (lower < upper ? lower : OrderedArray<int>::npos));
+    keys.push_back(key);
+  }
+
+  std::vector<size_t> found(keys.size());
+  array.findMany(keys.data(), keys.size(), found.data());
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(found[i] == array.find(keys[i]));
+  }
+}
+
+} // namespace
+
+TEST_CASE("Tombstoned elements are invisible to the index-based API",
+          "[OrderedArray]") {
+  std::mt19937 random(1);
+  std::vector<int> expected;
+
+  for (int i = 0; i < 3000; ++i) {
+    expected.push_back(static_cast<int>(random() % 1000));
+  }
+
+  OrderedArray<int> array;
+  array.insertRange(expected.begin(), expected.end());
+  std::sort(expected.begin(), expected.end());
+  array.enableTombstones(0.9);
+
+  SECTION("flat search") {}
+  SECTION("frozen search") { array.freeze(); }
+  SECTION("learned search") { array.freezeLearned(4); }
+
+  for (size_t round = 0; round < 10; ++round) {
+    for (int i = 0; i < 150; ++i) {
+      size_t index = random() % expected.size();
+      array.remove(index);
+      expected.erase(expected.begin() + index);
+    }
+
+    REQUIRE(array.getRemovedCount() == 150 * (round + 1));
+    checkAgainst(array, expected);
+  }
+
+  REQUIRE_THROWS_AS(array.remove(expected.size()), std::out_of_range);
+  REQUIRE_THROWS_AS(array.view(), std::logic_error);
+
+  array.removeRange(100, 400);
+  expected.erase(expected.begin() + 100, expected.begin() + 400);
+  REQUIRE(array.getRemovedCount() == 0);
+  checkAgainst(array, expected);
+  REQUIRE(array.view().getSize() == expected.size());
+}
+
+TEST_CASE("range() and view() refuse to span removed elements",
+          "[OrderedArray]") {
+  OrderedArray<int> array{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  array.enableTombstones(0.5);
+  array.remove(2);
+  array.remove(2);
+
+  checkAgainst(array, {1, 2, 5, 6, 7, 8, 9, 10});
+  REQUIRE(array.range(5, 9).getSize() == 4);
+  REQUIRE_THROWS_AS(array.range(1, 6), std::logic_error);
+
+  array.compact();
+  checkAgainst(array, {1, 2, 5, 6, 7, 8, 9, 10});
+  REQUIRE(array.range(1, 6).getSize() == 3);
+}
+
+TEST_CASE("insert copies a value that refers into the array",
+          "[OrderedArray]") {
+  OrderedArray<int> array{10, 20, 30, 40, 50, 60, 70, 80};
+  array.enableTombstones(0.9);
+  array.remove(0);
+
+  // get(3) is 50; compacting away the removed 10 shifts that slot to 60.
+  array.insert(array.get(3));
+  checkAgainst(array, {20, 30, 40, 50, 50, 60, 70, 80});
+}
+
+TEST_CASE("insert into a full array copies a value that refers into it",
+          "[OrderedArray]") {
+  OrderedArray<std::string> array;
+  array.reserve(4);
+
+  for (const char *word : {"alpha", "bravo", "charlie", "delta"}) {
+    array.insert(word);
+  }
+
+  REQUIRE(array.getSize() == array.getCapacity());
+  array.insert(array.get(1));
+
+  std::vector<std::string> expected{"alpha", "bravo", "bravo", "charlie",
+                                    "delta"};
+  REQUIRE(std::vector<std::string>(array.begin(), array.end()) == expected);
+}
+
+TEST_CASE("OrderedArray moves and swaps in O(1) without throwing",
+          "[OrderedArray]") {
+  static_assert(std::is_nothrow_move_constructible<OrderedArray<int>>::value);
+  static_assert(std::is_nothrow_move_assignable<OrderedArray<int>>::value);
+  static_assert(std::is_nothrow_swappable<OrderedArray<int>>::value);
+
+  OrderedArray<int> array{5, 1, 4, 2, 3};
+  array.enableTombstones(0.9);
+  array.remove(0);
+  array.freeze();
+
+  OrderedArray<int> moved(std::move(array));
+  checkAgainst(moved, {2, 3, 4, 5});
+  checkAgainst(array, {});
+
+  OrderedArray<int> other{7, 8};
+  swap(moved, other);
+  checkAgainst(moved, {7, 8});
+  checkAgainst(other, {2, 3, 4, 5});
+
+  other = std::move(moved);
+  checkAgainst(other, {7, 8});
+  checkAgainst(moved, {});
+  moved.insert(6);
+  checkAgainst(moved, {6});
+
+  OrderedArray<int> copy(other);
+  copy.insert(1);
+  checkAgainst(other, {7, 8});
+}
+
+TEST_CASE("removeIf counts only the elements that matched",
+          "[OrderedArray]") {
+  OrderedArray<int> array{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  array.enableTombstones(0.9);
+  array.remove(0);
+  array.remove(0);
+  REQUIRE(array.getRemovedCount() == 2);
+
+  REQUIRE(array.removeIf([](int x) { return x % 2 == 0; }) == 4);
+  REQUIRE(array.getRemovedCount() == 0);
+  checkAgainst(array, {3, 5, 7, 9});
+  REQUIRE(array.removeIf([](int x) { return x > 100; }) == 0);
+}
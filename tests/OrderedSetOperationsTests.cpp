@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/OrderedSetOperations.cpp"
+
+namespace {
+
+// (key, tag): the tag tells which input and position an element came from.
+using Tagged = std::pair<int, int>;
+
+struct ByKey {
+  bool operator()(const Tagged &a, const Tagged &b) const {
+    return a.first < b.first;
+  }
+};
+
+using TaggedArray = OrderedArray<Tagged, ByKey>;
+
+// `count` sorted elements with keys below `range`, tagged `tag` + position.
+std::vector<Tagged> sortedInput(std::mt19937 &random, size_t count,
+                                int range, int tag) {
+  std::vector<Tagged> values(count);
+
+  for (size_t i = 0; i < count; ++i) {
+    values[i].first = static_cast<int>(random() % range);
+  }
+
+  std::sort(values.begin(), values.end());
+
+  for (size_t i = 0; i < count; ++i) {
+    values[i].second = tag + static_cast<int>(i);
+  }
+
+  return values;
+}
+
+TaggedArray toArray(const std::vector<Tagged> &values) {
+  TaggedArray array;
+  array.insertRange(values.begin(), values.end());
+
+  return array;
+}
+
+std::vector<Tagged> toVector(const TaggedArray &array) {
+  return std::vector<Tagged>(array.begin(), array.end());
+}
+
+// Checks the four operations on `a` and `b` against their std:: versions,
+// including which of equivalent elements are taken.
+void checkOperations(const TaggedArray &a, const TaggedArray &b) {
+  std::vector<Tagged> left = toVector(a);
+  std::vector<Tagged> right = toVector(b);
+  std::vector<Tagged> expected;
+
+  std::merge(left.begin(), left.end(), right.begin(), right.end(),
+             std::back_inserter(expected), ByKey());
+  REQUIRE(toVector(merge(a, b)) == expected);
+
+  expected.clear();
+  std::set_union(left.begin(), left.end(), right.begin(), right.end(),
+                 std::back_inserter(expected), ByKey());
+  REQUIRE(toVector(setUnion(a, b)) == expected);
+
+  expected.clear();
+  std::set_intersection(left.begin(), left.end(), right.begin(), right.end(),
+                        std::back_inserter(expected), ByKey());
+  REQUIRE(toVector(setIntersection(a, b)) == expected);
+
+  expected.clear();
+  std::set_difference(left.begin(), left.end(), right.begin(), right.end(),
+                      std::back_inserter(expected), ByKey());
+  REQUIRE(toVector(setDifference(a, b)) == expected);
+}
+
+} // namespace
+
+TEST_CASE("Set operations match std:: on multisets", "[OrderedSetOperations]") {
+  std::mt19937 random(22);
+
+  // Similar sizes take the linear merges; a 16-fold difference either way
+  // gallops over the longer array.
+  for (auto sizes : {std::pair<size_t, size_t>{300, 280},
+                     std::pair<size_t, size_t>{20, 2000},
+                     std::pair<size_t, size_t>{2000, 20},
+                     std::pair<size_t, size_t>{0, 50},
+                     std::pair<size_t, size_t>{50, 0}}) {
+    for (int range : {10, 100, 100000}) {
+      INFO("sizes " << sizes.first << ", " << sizes.second << ", range "
+                    << range);
+      TaggedArray a = toArray(sortedInput(random, sizes.first, range, 0));
+      TaggedArray b =
+          toArray(sortedInput(random, sizes.second, range, 1000000));
+      checkOperations(a, b);
+    }
+  }
+}
+
+TEST_CASE("Set operations skip tombstoned elements",
+          "[OrderedSetOperations]") {
+  std::mt19937 random(22);
+
+  for (auto sizes : {std::pair<size_t, size_t>{300, 280},
+                     std::pair<size_t, size_t>{40, 2000},
+                     std::pair<size_t, size_t>{2000, 40}}) {
+    TaggedArray a = toArray(sortedInput(random, sizes.first, 50, 0));
+    TaggedArray b = toArray(sortedInput(random, sizes.second, 50, 1000000));
+    a.enableTombstones(0.9);
+    b.enableTombstones(0.9);
+
+    for (int i = 0; i < 10; ++i) {
+      a.remove(random() % a.getSize());
+      b.remove(random() % b.getSize());
+    }
+
+    REQUIRE(a.getRemovedCount() > 0);
+    checkOperations(a, b);
+  }
+}
+
+TEST_CASE("setIntersection of int sets matches std::set_intersection",
+          "[OrderedSetOperations]") {
+  std::mt19937 random(22);
+
+  // Strictly increasing ints take the SIMD kernel, duplicates the scalar
+  // merge.
+  for (int range : {200, 100000}) {
+    std::vector<int> left;
+    std::vector<int> right;
+
+    for (int i = 0; i < 500; ++i) {
+      left.push_back(static_cast<int>(random() % range));
+      right.push_back(static_cast<int>(random() % range));
+    }
+
+    OrderedArray<int> a;
+    OrderedArray<int> b;
+    a.insertRange(left.begin(), left.end());
+    b.insertRange(right.begin(), right.end());
+    std::sort(left.begin(), left.end());
+    std::sort(right.begin(), right.end());
+
+    for (bool unique : {false, true}) {
+      if (unique) {
+        left.erase(std::unique(left.begin(), left.end()), left.end());
+        right.erase(std::unique(right.begin(), right.end()), right.end());
+        a = OrderedArray<int>();
+        b = OrderedArray<int>();
+        a.insertRange(left.begin(), left.end());
+        b.insertRange(right.begin(), right.end());
+      }
+
+      std::vector<int> expected;
+      std::set_intersection(left.begin(), left.end(), right.begin(),
+                            right.end(), std::back_inserter(expected));
+      OrderedArray<int> result = setIntersection(a, b);
+      REQUIRE(std::vector<int>(result.begin(), result.end()) == expected);
+    }
+  }
+}
@@ -0,0 +1,69 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+
+#include <catch2/catch.hpp>
+
+#include "../src/concurrency/ParallelBulk.cpp"
+#include "../src/data_structures/array/DynamicArray.cpp"
+
+TEST_CASE("Parallel transformReduce matches the serial fold",
+          "[ParallelBulk]") {
+  std::mt19937 random(29);
+  DynamicArray<int> array;
+
+  // Large enough to be split across the pool rather than run serially.
+  for (size_t i = 0; i < 1000000; ++i) {
+    array.push_back(static_cast<int>(random() % 1000));
+  }
+
+  ThreadPool pool(4);
+
+  size_t above = array.reduce(
+      size_t(0), [](size_t count, int x) { return count + (x > 500); });
+  REQUIRE(array.transformReduce(size_t(0), std::plus<size_t>(),
+                                [](int x) { return size_t(x > 500); }) ==
+          above);
+  REQUIRE(parallelTransformReduce(array, size_t(0), std::plus<size_t>(),
+                                  [](int x) { return size_t(x > 500); },
+                                  pool) == above);
+
+  uint64_t squares = array.reduce(uint64_t(0), [](uint64_t sum, int x) {
+    return sum + uint64_t(x) * uint64_t(x);
+  });
+  REQUIRE(parallelTransformReduce(
+              array, uint64_t(0), std::plus<uint64_t>(),
+              [](int x) { return uint64_t(x) * uint64_t(x); }, pool) ==
+          squares);
+
+  DynamicArray<int> empty;
+  REQUIRE(parallelTransformReduce(empty, 7, std::plus<int>(),
+                                  [](int x) { return x; }, pool) == 7);
+}
+
+TEST_CASE("Parallel bulk operations over a whole array", "[ParallelBulk]") {
+  DynamicArray<int> array;
+
+  for (int i = 0; i < 1000000; ++i) {
+    array.push_back(i % 1000);
+  }
+
+  ThreadPool pool(4);
+
+  REQUIRE(parallelFind(array, 999, pool) == 999);
+  REQUIRE(parallelFind(array, 1000, pool) == array.getSize());
+  REQUIRE(parallelFindIf(array, [](int x) { return x > 997; }, pool) == 998);
+  REQUIRE(parallelCount(array, 7, pool) == 1000);
+
+  parallelTransform(array, [](int x) { return x + 1; }, pool);
+  REQUIRE(parallelCount(array, 1000, pool) == 1000);
+
+  std::atomic<size_t> visited{0};
+  parallelForEach(array, [&visited](int) { ++visited; }, pool);
+  REQUIRE(visited == array.getSize());
+
+  parallelFill(array, 3, pool);
+  REQUIRE(parallelCount(array, 3, pool) == array.getSize());
+}
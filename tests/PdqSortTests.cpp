@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/sortings/HeapSort.cpp"
+#include "../src/sortings/InsertionSort.cpp"
+#include "../src/sortings/PdqSort.cpp"
+#include "../src/utils/OperationStats.cpp"
+
+namespace {
+
+// Input shapes that exercise pdqsort's partitioning, its pattern breaking
+// and the already-partitioned shortcut.
+std::vector<std::pair<std::string, std::vector<int>>> inputs(size_t size) {
+  std::mt19937 random(6);
+  std::vector<int> shuffled(size);
+  std::vector<int> sorted(size);
+  std::vector<int> reversed(size);
+  std::vector<int> fewUnique(size);
+  std::vector<int> organPipe(size);
+
+  for (size_t i = 0; i < size; ++i) {
+    shuffled[i] = static_cast<int>(random() % 100000);
+    sorted[i] = static_cast<int>(i);
+    reversed[i] = static_cast<int>(size - i);
+    fewUnique[i] = static_cast<int>(random() % 4);
+    organPipe[i] = static_cast<int>(std::min(i, size - i));
+  }
+
+  return {{"random", shuffled},
+          {"sorted", sorted},
+          {"reverse", reversed},
+          {"few unique", fewUnique},
+          {"organ pipe", organPipe}};
+}
+
+} // namespace
+
+TEST_CASE("pdqSort matches std::sort", "[PdqSort]") {
+  for (size_t size : {0, 1, 2, 5, 23, 24, 25, 100, 1000, 20000}) {
+    for (auto &[name, values] : inputs(size)) {
+      INFO(name << ", size " << size);
+      std::vector<int> expected = values;
+      std::sort(expected.begin(), expected.end());
+
+      std::vector<int> ascending = values;
+      pdqSort(ascending.begin(), ascending.end());
+      REQUIRE(ascending == expected);
+
+      std::vector<int> descending = values;
+      pdqSort(descending.begin(), descending.end(), std::greater<int>());
+      REQUIRE(std::equal(descending.begin(), descending.end(),
+                         expected.rbegin()));
+    }
+  }
+}
+
+TEST_CASE("heapSort and insertionSort match std::sort", "[PdqSort]") {
+  for (size_t size : {0, 1, 2, 7, 100, 1000}) {
+    for (auto &[name, values] : inputs(size)) {
+      INFO(name << ", size " << size);
+      std::vector<int> expected = values;
+      std::sort(expected.begin(), expected.end());
+
+      std::vector<int> heap = values;
+      heapSort(heap.begin(), heap.end(), std::less<int>());
+      REQUIRE(heap == expected);
+
+      std::vector<int> insertion = values;
+      insertionSort(insertion.begin(), insertion.end(), std::less<int>());
+      REQUIRE(insertion == expected);
+    }
+  }
+}
+
+TEST_CASE("The Stats overload of pdqSort counts comparisons", "[PdqSort]") {
+  std::vector<int> values = inputs(5000)[0].second;
+  std::vector<int> expected = values;
+  std::sort(expected.begin(), expected.end());
+
+  CountingStats stats;
+  std::vector<int> counted = values;
+  pdqSort(counted.begin(), counted.end(), std::less<int>(), stats);
+  REQUIRE(counted == expected);
+  REQUIRE(stats.stats().comparisons >= values.size() - 1);
+  REQUIRE(stats.stats().comparisons < 5000 * 13 * 3);
+
+  // Sorted input is detected in one linear pass.
+  stats.resetStats();
+  pdqSort(counted.begin(), counted.end(), std::less<int>(), stats);
+  REQUIRE(stats.stats().comparisons < 3 * values.size());
+
+  std::vector<int> uncounted = values;
+  pdqSort(uncounted.begin(), uncounted.end(), std::less<int>(), NoStats());
+  REQUIRE(uncounted == expected);
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/sortings/PowerSort.cpp"
+
+namespace {
+
+using Record = std::pair<int, size_t>; // (key, original position)
+
+bool byKey(const Record &a, const Record &b) { return a.first < b.first; }
+
+// Checks that powerSort by key matches std::stable_sort on `keys` tagged
+// with their positions.
+void checkStable(const std::vector<int> &keys) {
+  std::vector<Record> records(keys.size());
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    records[i] = {keys[i], i};
+  }
+
+  std::vector<Record> expected = records;
+  std::stable_sort(expected.begin(), expected.end(), byKey);
+  powerSort(records.begin(), records.end(), byKey);
+  REQUIRE(records == expected);
+}
+
+} // namespace
+
+TEST_CASE("powerSort is stable", "[PowerSort]") {
+  std::mt19937 random(21);
+
+  for (size_t size : {0, 1, 2, 31, 64, 65, 1000, 20000}) {
+    std::vector<int> fewKeys(size);
+    std::vector<int> runs(size);
+    std::vector<int> descending(size);
+
+    for (size_t i = 0; i < size; ++i) {
+      fewKeys[i] = static_cast<int>(random() % 8);
+      // Ascending runs of 500 with repeated keys across the runs.
+      runs[i] = static_cast<int>(i % 500 / 3);
+      // Non-increasing: equal neighbours end the strictly descending runs.
+      descending[i] = static_cast<int>((size - i) / 4);
+    }
+
+    checkStable(fewKeys);
+    checkStable(runs);
+    checkStable(descending);
+  }
+}
+
+TEST_CASE("powerSort gallops over far-out-of-place elements",
+          "[PowerSort]") {
+  std::mt19937 random(21);
+  std::vector<int> values(100000);
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<int>(2 * i);
+  }
+
+  // A few elements from the front moved to the back and the other way
+  // round, each far from its place.
+  for (int i = 0; i < 8; ++i) {
+    std::swap(values[random() % 100], values[values.size() - 1 - i * 97]);
+  }
+
+  std::vector<int> expected = values;
+  std::sort(expected.begin(), expected.end());
+
+  CountingStats stats;
+  powerSort(values.begin(), values.end(), std::less<int>(), stats);
+  REQUIRE(values == expected);
+  // Merging elementwise would cost about n log2(r) comparisons.
+  REQUIRE(stats.stats().comparisons < 3 * values.size());
+
+  // The same with a long sorted run and a short one that interleaves at a
+  // few points only, through the stable path.
+  std::vector<int> keys;
+
+  for (int i = 0; i < 5000; ++i) {
+    keys.push_back(i);
+  }
+
+  for (int key : {-1, 2500, 2500, 9000}) {
+    keys.push_back(key);
+  }
+
+  checkStable(keys);
+}
+
+TEST_CASE("gallopForward and gallopBackward find the partition point",
+          "[PowerSort]") {
+  std::vector<int> values(200);
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<int>(i);
+  }
+
+  for (int point = 0; point <= 200; ++point) {
+    auto below = [point](int x) { return x < point; };
+    REQUIRE(gallopForward(values.begin(), values.end(), below) -
+                values.begin() ==
+            point);
+    REQUIRE(gallopBackward(values.begin(), values.end(), below) -
+                values.begin() ==
+            point);
+  }
+}
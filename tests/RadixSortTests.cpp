@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/sortings/RadixSort.cpp"
+
+namespace {
+
+// Runs LSD or MSD radix sort, so that every case checks both.
+struct Lsd {
+  template <typename RandomIt> void operator()(RandomIt first, RandomIt last) {
+    radixSort(first, last);
+  }
+
+  template <typename RandomIt, typename KeyOf>
+  void operator()(RandomIt first, RandomIt last, KeyOf keyOf) {
+    radixSort(first, last, keyOf);
+  }
+};
+
+struct Msd {
+  template <typename RandomIt> void operator()(RandomIt first, RandomIt last) {
+    msdRadixSort(first, last);
+  }
+
+  template <typename RandomIt, typename KeyOf>
+  void operator()(RandomIt first, RandomIt last, KeyOf keyOf) {
+    msdRadixSort(first, last, keyOf);
+  }
+};
+
+template <typename Key, typename Sorter>
+void checkAgainstStdSort(std::vector<Key> values, Sorter sorter) {
+  std::vector<Key> expected = values;
+  std::sort(expected.begin(), expected.end());
+  sorter(values.begin(), values.end());
+  REQUIRE(values == expected);
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("radix sorts order signed keys", "[RadixSort]", Lsd,
+                   Msd) {
+  std::mt19937_64 random(8);
+
+  for (size_t size : {0, 1, 2, 64, 65, 1000, 10000}) {
+    std::vector<int32_t> ints(size);
+    std::vector<int64_t> longs(size);
+    std::vector<int8_t> bytes(size);
+
+    for (size_t i = 0; i < size; ++i) {
+      ints[i] = static_cast<int32_t>(random());
+      longs[i] = static_cast<int64_t>(random());
+      bytes[i] = static_cast<int8_t>(random());
+    }
+
+    if (size > 2) {
+      ints[0] = std::numeric_limits<int32_t>::min();
+      ints[1] = std::numeric_limits<int32_t>::max();
+      longs[0] = std::numeric_limits<int64_t>::min();
+      longs[1] = -1;
+    }
+
+    checkAgainstStdSort(ints, TestType());
+    checkAgainstStdSort(longs, TestType());
+    checkAgainstStdSort(bytes, TestType());
+  }
+}
+
+TEMPLATE_TEST_CASE("radix sorts order float and double keys", "[RadixSort]",
+                   Lsd, Msd) {
+  std::mt19937 random(8);
+  std::uniform_real_distribution<double> spread(-1e6, 1e6);
+
+  for (size_t size : {2, 65, 5000}) {
+    std::vector<double> doubles(size);
+    std::vector<float> floats(size);
+
+    for (size_t i = 0; i < size; ++i) {
+      doubles[i] = spread(random);
+      floats[i] = static_cast<float>(spread(random));
+    }
+
+    doubles[0] = -std::numeric_limits<double>::infinity();
+    floats[size - 1] = std::numeric_limits<float>::lowest();
+    checkAgainstStdSort(doubles, TestType());
+    checkAgainstStdSort(floats, TestType());
+  }
+
+  // -0.0 and 0.0 compare equal, but the radix key puts -0.0 first.
+  std::vector<double> zeros{0.0, -0.0, 1.5, -0.0, -2.5, 0.0};
+  TestType()(zeros.begin(), zeros.end());
+  REQUIRE(zeros[0] == -2.5);
+  REQUIRE(std::signbit(zeros[1]));
+  REQUIRE(std::signbit(zeros[2]));
+  REQUIRE_FALSE(std::signbit(zeros[3]));
+  REQUIRE_FALSE(std::signbit(zeros[4]));
+  REQUIRE(zeros[5] == 1.5);
+}
+
+TEMPLATE_TEST_CASE("radix sorts are stable under a key extractor",
+                   "[RadixSort]", Lsd, Msd) {
+  std::mt19937 random(8);
+
+  for (size_t size : {10, 64, 65, 5000}) {
+    // (key, original position): few distinct keys, so most compare equal.
+    std::vector<std::pair<int16_t, size_t>> records(size);
+
+    for (size_t i = 0; i < size; ++i) {
+      int key = static_cast<int>(random() % 20) - 10;
+      records[i] = {static_cast<int16_t>(key), i};
+    }
+
+    std::vector<std::pair<int16_t, size_t>> expected = records;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto &a, const auto &b) {
+                       return a.first < b.first;
+                     });
+
+    TestType()(records.begin(), records.end(),
+               [](const std::pair<int16_t, size_t> &record) {
+                 return record.first;
+               });
+    REQUIRE(records == expected);
+  }
+}
+
+TEMPLATE_TEST_CASE("radix sorts skip bytes every key shares", "[RadixSort]",
+                   Lsd, Msd) {
+  std::mt19937_64 random(8);
+
+  // Only the lowest byte differs, or the lowest and the highest: an odd
+  // and an even number of scatter passes.
+  for (uint64_t high : {uint64_t(0), uint64_t(0x5a) << 56}) {
+    std::vector<uint64_t> values(3000);
+
+    for (uint64_t &value : values) {
+      value = (random() % 256) | (random() % 2 == 0 ? 0 : high);
+    }
+
+    checkAgainstStdSort(values, TestType());
+  }
+
+  // Every byte is shared: no pass runs at all.
+  checkAgainstStdSort(std::vector<uint64_t>(500, 0x0123456789abcdef),
+                      TestType());
+}
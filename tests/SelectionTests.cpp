@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/OrderedTopK.cpp"
+#include "../src/sortings/Selection.cpp"
+
+namespace {
+
+std::vector<std::vector<int>> inputs(size_t size) {
+  std::mt19937 random(24);
+  std::vector<int> shuffled(size);
+  std::vector<int> ascending(size);
+  std::vector<int> descending(size);
+  std::vector<int> fewUnique(size);
+
+  for (size_t i = 0; i < size; ++i) {
+    shuffled[i] = static_cast<int>(random() % 100000);
+    ascending[i] = static_cast<int>(i);
+    descending[i] = static_cast<int>(size - i);
+    fewUnique[i] = static_cast<int>(random() % 3);
+  }
+
+  return {shuffled, ascending, descending, fewUnique};
+}
+
+} // namespace
+
+TEST_CASE("nthElement matches the sorted range", "[Selection]") {
+  for (size_t size : {1, 2, 10, 100, 5000}) {
+    for (const std::vector<int> &values : inputs(size)) {
+      std::vector<int> sorted = values;
+      std::sort(sorted.begin(), sorted.end());
+
+      for (size_t nth : {size_t(0), size / 3, size / 2, size - 1}) {
+        std::vector<int> selected = values;
+        nthElement(selected.begin(), selected.begin() + nth, selected.end());
+        REQUIRE(selected[nth] == sorted[nth]);
+
+        for (size_t i = 0; i < size; ++i) {
+          REQUIRE((i < nth ? selected[i] <= selected[nth]
+                           : selected[i] >= selected[nth]));
+        }
+      }
+    }
+  }
+
+  // Adversarial input for median-of-three: the bad-pivot budget runs out
+  // and the median-of-medians fallback takes over.
+  std::vector<int> organPipe(20000);
+
+  for (size_t i = 0; i < organPipe.size(); ++i) {
+    organPipe[i] = static_cast<int>(std::min(i, organPipe.size() - i));
+  }
+
+  std::vector<int> sorted = organPipe;
+  std::sort(sorted.begin(), sorted.end());
+  CountingStats stats;
+  nthElement(organPipe.begin(), organPipe.begin() + 10000, organPipe.end(),
+             std::less<int>(), stats);
+  REQUIRE(organPipe[10000] == sorted[10000]);
+  REQUIRE(stats.stats().comparisons < 40 * organPipe.size());
+}
+
+TEST_CASE("partialSort matches the sorted prefix", "[Selection]") {
+  for (size_t size : {1, 10, 1000, 20000}) {
+    for (const std::vector<int> &values : inputs(size)) {
+      std::vector<int> sorted = values;
+      std::sort(sorted.begin(), sorted.end());
+
+      // Heap path for k <= n / 64, nthElement path above it.
+      for (size_t k : {size_t(0), size_t(1), size / 64, size / 2, size}) {
+        std::vector<int> partial = values;
+        partialSort(partial.begin(), partial.begin() + k, partial.end());
+        REQUIRE(std::equal(partial.begin(), partial.begin() + k,
+                           sorted.begin()));
+
+        std::vector<int> rest(partial.begin() + k, partial.end());
+        std::sort(rest.begin(), rest.end());
+        REQUIRE(std::equal(rest.begin(), rest.end(), sorted.begin() + k));
+      }
+    }
+  }
+}
+
+TEST_CASE("TopK keeps the first k elements under the comparator",
+          "[Selection]") {
+  for (const std::vector<int> &values : inputs(5000)) {
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t k : {0, 1, 7, 100, 5000, 6000}) {
+      TopK<int> smallest(k);
+      smallest.pushRange(values.begin(), values.end());
+      size_t kept = std::min(k, values.size());
+      REQUIRE(smallest.getSize() == kept);
+      REQUIRE(smallest.sorted() ==
+              std::vector<int>(sorted.begin(), sorted.begin() + kept));
+
+      TopK<int, std::greater<int>> largest(k);
+      largest.pushRange(values.begin(), values.end());
+      REQUIRE(largest.take() ==
+              std::vector<int>(sorted.rbegin(), sorted.rbegin() + kept));
+      REQUIRE(largest.getSize() == 0);
+    }
+  }
+
+  TopK<int> top(3);
+  top.push(5);
+  REQUIRE_THROWS_AS(top.threshold(), std::out_of_range);
+  top.push(1);
+  top.push(9);
+  REQUIRE(top.threshold() == 9);
+  top.push(2);
+  REQUIRE(top.threshold() == 5);
+}
+
+TEST_CASE("TopK keeps one of several equivalent elements", "[Selection]") {
+  using Tagged = std::pair<int, char>;
+  auto byKey = [](const Tagged &a, const Tagged &b) {
+    return a.first < b.first;
+  };
+
+  TopK<Tagged, decltype(byKey)> top(2, byKey);
+  top.push({5, 'a'});
+  top.push({5, 'b'});
+  top.push({1, 'c'});
+
+  // Which 5 survives is unspecified, only that one does.
+  std::vector<Tagged> kept = top.sorted();
+  REQUIRE(kept.size() == 2);
+  REQUIRE(kept[0] == Tagged(1, 'c'));
+  REQUIRE(kept[1].first == 5);
+
+  // An element equivalent to the threshold does not replace it.
+  Tagged threshold = top.threshold();
+  top.push({5, 'd'});
+  REQUIRE(top.threshold() == threshold);
+}
+
+TEST_CASE("orderedTopK builds an OrderedArray of the first k elements",
+          "[Selection]") {
+  std::vector<int> values = inputs(3000)[0];
+  std::vector<int> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+
+  OrderedArray<int> smallest = orderedTopK(values.begin(), values.end(), 50);
+  REQUIRE(std::vector<int>(smallest.begin(), smallest.end()) ==
+          std::vector<int>(sorted.begin(), sorted.begin() + 50));
+
+  OrderedArray<int, std::greater<int>> largest =
+      orderedTopK(values.begin(), values.end(), 50, std::greater<int>());
+  REQUIRE(std::vector<int>(largest.begin(), largest.end()) ==
+          std::vector<int>(sorted.rbegin(), sorted.rbegin() + 50));
+  REQUIRE(largest.find(sorted.back()) == 0);
+}
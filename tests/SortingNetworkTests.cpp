@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/sortings/SortingNetwork.cpp"
+
+namespace {
+
+// Sorts random inputs, some with many duplicates, through a vector
+// iterator and a pointer and compares the results with std::sort.
+template <size_t N, typename T> void checkSortN(std::mt19937 &random) {
+  for (int trial = 0; trial < 2000; ++trial) {
+    int range = trial % 2 == 0 ? 1000000 : 4;
+    std::vector<T> values(N);
+
+    for (T &value : values) {
+      value = static_cast<T>(static_cast<int>(random() % (2 * range)) - range);
+    }
+
+    std::vector<T> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<T> viaIterator = values;
+    sortN<N>(viaIterator.begin());
+    REQUIRE(viaIterator == expected);
+
+    std::vector<T> viaPointer = values;
+    sortN<N>(viaPointer.data(), std::less<T>());
+    REQUIRE(viaPointer == expected);
+
+    std::vector<T> descending = values;
+    sortN<N>(descending.begin(), std::greater<T>());
+    std::reverse(descending.begin(), descending.end());
+    REQUIRE(descending == expected);
+  }
+}
+
+} // namespace
+
+TEST_CASE("sortN<16> matches std::sort", "[SortingNetwork]") {
+  std::mt19937 random(16);
+  checkSortN<16, int32_t>(random);
+  checkSortN<16, float>(random);
+  checkSortN<16, int64_t>(random);
+}
+
+TEST_CASE("sortN<32> matches std::sort", "[SortingNetwork]") {
+  std::mt19937 random(32);
+  checkSortN<32, int32_t>(random);
+  checkSortN<32, float>(random);
+  checkSortN<32, double>(random);
+}
+
+TEST_CASE("sortSmall matches std::sort for every size", "[SortingNetwork]") {
+  std::mt19937 random(0);
+
+  for (size_t size = 0; size <= sortingNetworkMaxSize; ++size) {
+    for (int trial = 0; trial < 200; ++trial) {
+      std::vector<int32_t> values(size);
+
+      for (int32_t &value : values) {
+        value = static_cast<int32_t>(random() % 50);
+      }
+
+      std::vector<int32_t> expected = values;
+      std::sort(expected.begin(), expected.end());
+      sortSmall(values.begin(), values.end());
+      REQUIRE(values == expected);
+    }
+  }
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/data_structures/array/VectorizedSearch.cpp"
+
+namespace {
+
+template <typename T>
+std::vector<T> strictlyIncreasing(std::mt19937 &random, size_t count,
+                                  int range) {
+  std::set<T> values;
+
+  while (values.size() < count) {
+    values.insert(static_cast<T>(static_cast<int>(random() % range) -
+                                 range / 2));
+  }
+
+  return std::vector<T>(values.begin(), values.end());
+}
+
+} // namespace
+
+TEST_CASE("vectorizedIntersect matches std::set_intersection",
+          "[VectorizedSearch]") {
+  std::mt19937 random(1);
+
+  for (int trial = 0; trial < 500; ++trial) {
+    size_t aSize = random() % 200;
+    size_t bSize = random() % 200;
+    int range = trial % 2 == 0 ? 400 : 100000;
+    std::vector<int32_t> a = strictlyIncreasing<int32_t>(random, aSize, range);
+    std::vector<int32_t> b = strictlyIncreasing<int32_t>(random, bSize, range);
+
+    std::vector<int32_t> expected;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(expected));
+
+    std::vector<int32_t> out(std::min(aSize, bSize));
+    out.resize(vectorizedIntersect(a.data(), a.size(), b.data(), b.size(),
+                                   out.data()));
+    REQUIRE(out == expected);
+  }
+}
+
+TEST_CASE("vectorizedFind, count and findAll match a scalar scan",
+          "[VectorizedSearch]") {
+  std::mt19937 random(2);
+
+  for (size_t size : {0, 1, 3, 7, 8, 9, 63, 64, 65, 1000}) {
+    std::vector<int32_t> ints(size);
+    std::vector<double> doubles(size);
+
+    for (size_t i = 0; i < size; ++i) {
+      ints[i] = static_cast<int32_t>(random() % 5);
+      doubles[i] = static_cast<double>(random() % 5);
+    }
+
+    for (int32_t key = 0; key < 6; ++key) {
+      std::vector<size_t> expected;
+
+      for (size_t i = 0; i < size; ++i) {
+        if (ints[i] == key) {
+          expected.push_back(i);
+        }
+      }
+
+      std::vector<size_t> found;
+      vectorizedFindAll(ints.data(), size, key, found);
+      REQUIRE(found == expected);
+      REQUIRE(vectorizedCount(ints.data(), size, key) == expected.size());
+      REQUIRE(vectorizedFind(ints.data(), size, key) ==
+              (expected.empty() ? size : expected.front()));
+
+      size_t firstDouble =
+          std::find(doubles.begin(), doubles.end(), double(key)) -
+          doubles.begin();
+      REQUIRE(vectorizedFind(doubles.data(), size, double(key)) ==
+              firstDouble);
+      REQUIRE(vectorizedFindIf(ints.data(), size, [key](int32_t x) {
+                return x > key;
+              }) == static_cast<size_t>(std::find_if(ints.begin(), ints.end(),
+                                                     [key](int32_t x) {
+                                                       return x > key;
+                                                     }) -
+                                        ints.begin()));
+    }
+  }
+}
@@ -0,0 +1,276 @@
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/data_structures/array/ChunkedOrderedArray.cpp"
+#include "../src/data_structures/array/DynamicArray.cpp"
+#include "../src/data_structures/array/MappedArray.cpp"
+#include "../src/data_structures/array/OperationTrace.cpp"
+#include "../src/data_structures/array/OrderedArray.cpp"
+
+/**
+ * Replays a trace recorded with TracedArray (see OperationTrace.cpp)
+ * against several containers and prints the throughput and the latency
+ * percentiles of each:
+ *
+ *   MyReplay <trace> [container...]
+ *
+ * Containers of ordered traces (insert, find, lowerBound, get, remove):
+ * `ordered` (OrderedArray), `frozen` (OrderedArray refrozen before the
+ * first lookup after a mutation) and `chunked` (ChunkedOrderedArray).
+ * Containers of positional traces (push_back, insert at, getAt, setAt,
+ * find, remove): `dynamic` (DynamicArray) and `vector` (std::vector). By
+ * default every container that supports the trace's operations runs.
+ *
+ * Equal checksums mean the containers returned the same results.
+ */
+
+[[noreturn]] void unsupported(const std::string &container, TraceOp op) {
+  throw std::runtime_error(container + " cannot replay " + traceOpName(op));
+}
+
+/**
+ * Apply an ordered-container event; `Container` has the OrderedArray API.
+ */
+template <typename T, typename Container>
+uint64_t applyOrdered(Container &container, const TraceEvent &event,
+                      const std::string &name) {
+  switch (event.op) {
+  case TraceOp::Insert:
+    container.insert(traceKey<T>(event));
+    return 0;
+  case TraceOp::Find:
+    return container.find(traceKey<T>(event));
+  case TraceOp::LowerBound:
+    return container.lowerBound(traceKey<T>(event));
+  case TraceOp::GetAt:
+    return traceKeyBits(container.get(event.index));
+  case TraceOp::Remove:
+    container.remove(event.index);
+    return 0;
+  default:
+    unsupported(name, event.op);
+  }
+}
+
+/**
+ * Apply a positional event to a DynamicArray.
+ */
+template <typename T>
+uint64_t applyDynamic(DynamicArray<T> &array, const TraceEvent &event) {
+  switch (event.op) {
+  case TraceOp::PushBack:
+    array.push_back(traceKey<T>(event));
+    return 0;
+  case TraceOp::InsertAt:
+    array.insert(event.index, traceKey<T>(event));
+    return 0;
+  case TraceOp::Find:
+    return array.find(traceKey<T>(event));
+  case TraceOp::GetAt:
+    return traceKeyBits(array.getAt(event.index));
+  case TraceOp::SetAt:
+    array.setAt(event.index, traceKey<T>(event));
+    return 0;
+  case TraceOp::Remove:
+    array.remove(event.index);
+    return 0;
+  default:
+    unsupported("dynamic", event.op);
+  }
+}
+
+/**
+ * Apply a positional event to a std::vector, with the same results as
+ * DynamicArray (npos for a failed find).
+ */
+template <typename T>
+uint64_t applyVector(std::vector<T> &vector, const TraceEvent &event) {
+  switch (event.op) {
+  case TraceOp::PushBack:
+    vector.push_back(traceKey<T>(event));
+    return 0;
+  case TraceOp::InsertAt:
+    vector.insert(vector.begin() + event.index, traceKey<T>(event));
+    return 0;
+  case TraceOp::Find: {
+    auto match = std::find(vector.begin(), vector.end(), traceKey<T>(event));
+    return match == vector.end() ? static_cast<uint64_t>(-1)
+                                 : static_cast<uint64_t>(match -
+                                                         vector.begin());
+  }
+  case TraceOp::GetAt:
+    return traceKeyBits(vector.at(event.index));
+  case TraceOp::SetAt:
+    vector.at(event.index) = traceKey<T>(event);
+    return 0;
+  case TraceOp::Remove:
+    vector.erase(vector.begin() + event.index);
+    return 0;
+  default:
+    unsupported("vector", event.op);
+  }
+}
+
+/**
+ * Whether the trace uses positional (DynamicArray) operations.
+ */
+bool isPositional(ArrayView<TraceEvent> events) {
+  for (const TraceEvent &event : events) {
+    if (event.op == TraceOp::PushBack || event.op == TraceOp::InsertAt ||
+        event.op == TraceOp::SetAt) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void printResult(const std::string &name, const ReplayResult &result) {
+  double throughput =
+      result.seconds > 0 ? static_cast<double>(result.operations) /
+                               result.seconds / 1e6
+                         : 0;
+
+  std::printf("%-10s %12zu %10.2f %8" PRIu64 " %8" PRIu64 " %8" PRIu64
+              " %8" PRIu64 " %10" PRIu64 "  %016" PRIx64 "\n",
+              name.c_str(), result.operations, throughput, result.p50,
+              result.p90, result.p99, result.p999, result.max,
+              result.checksum);
+}
+
+template <typename T>
+ReplayResult replayOn(const std::string &name, ArrayView<TraceEvent> events) {
+  if (name == "ordered") {
+    return replayTrace(
+        events, [] { return OrderedArray<T>(); },
+        [](OrderedArray<T> &array, const TraceEvent &event) {
+          return applyOrdered<T>(array, event, "ordered");
+        });
+  }
+
+  if (name == "frozen") {
+    return replayTrace(
+        events, [] { return OrderedArray<T>(); },
+        [](OrderedArray<T> &array, const TraceEvent &event) {
+          bool lookup = event.op == TraceOp::Find ||
+                        event.op == TraceOp::LowerBound;
+
+          if (lookup && !array.isFrozen()) {
+            array.freeze();
+          }
+
+          return applyOrdered<T>(array, event, "frozen");
+        });
+  }
+
+  if (name == "chunked") {
+    return replayTrace(
+        events, [] { return ChunkedOrderedArray<T>(); },
+        [](ChunkedOrderedArray<T> &array, const TraceEvent &event) {
+          return applyOrdered<T>(array, event, "chunked");
+        });
+  }
+
+  if (name == "dynamic") {
+    return replayTrace(events, [] { return DynamicArray<T>(); },
+                       applyDynamic<T>);
+  }
+
+  if (name == "vector") {
+    return replayTrace(events, [] { return std::vector<T>(); },
+                       applyVector<T>);
+  }
+
+  throw std::invalid_argument("Unknown container " + name);
+}
+
+template <typename T>
+void replayAll(ArrayView<TraceEvent> events,
+               std::vector<std::string> containers) {
+  if (containers.empty()) {
+    if (isPositional(events)) {
+      containers = {"dynamic", "vector"};
+    } else {
+      containers = {"ordered", "frozen", "chunked"};
+    }
+  }
+
+  if (!events.isEmpty()) {
+    uint64_t recorded = events.get(events.getSize() - 1).timestamp;
+    std::printf("trace: %zu operations recorded over %.3f s\n",
+                events.getSize(), static_cast<double>(recorded) / 1e9);
+  }
+
+  std::printf("%-10s %12s %10s %8s %8s %8s %8s %10s  %s\n", "container",
+              "operations", "Mops/s", "p50 ns", "p90 ns", "p99 ns",
+              "p99.9 ns", "max ns", "checksum");
+
+  for (const std::string &name : containers) {
+    printResult(name, replayOn<T>(name, events));
+  }
+}
+
+/**
+ * Run replayAll with the key type of the Begin event's descriptor.
+ */
+void replayWithKeyType(uint64_t keyType, ArrayView<TraceEvent> events,
+                       const std::vector<std::string> &containers) {
+  switch (keyType) {
+  case traceKeyType<int8_t>():
+    return replayAll<int8_t>(events, containers);
+  case traceKeyType<uint8_t>():
+    return replayAll<uint8_t>(events, containers);
+  case traceKeyType<int16_t>():
+    return replayAll<int16_t>(events, containers);
+  case traceKeyType<uint16_t>():
+    return replayAll<uint16_t>(events, containers);
+  case traceKeyType<int32_t>():
+    return replayAll<int32_t>(events, containers);
+  case traceKeyType<uint32_t>():
+    return replayAll<uint32_t>(events, containers);
+  case traceKeyType<int64_t>():
+    return replayAll<int64_t>(events, containers);
+  case traceKeyType<uint64_t>():
+    return replayAll<uint64_t>(events, containers);
+  case traceKeyType<float>():
+    return replayAll<float>(events, containers);
+  case traceKeyType<double>():
+    return replayAll<double>(events, containers);
+  default:
+    throw std::runtime_error("Unsupported trace key type " +
+                             std::to_string(keyType));
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <trace> [container...]\n", argv[0]);
+    return 2;
+  }
+
+  try {
+    MappedArray<TraceEvent> trace(argv[1]);
+    ArrayView<TraceEvent> events = trace.view();
+
+    if ((trace.getFlags() & arrayFileTrace) == 0 || events.isEmpty() ||
+        events.get(0).op != TraceOp::Begin) {
+      throw std::runtime_error(std::string(argv[1]) + " is not a trace");
+    }
+
+    std::vector<std::string> containers(argv + 2, argv + argc);
+    replayWithKeyType(
+        events.get(0).key,
+        ArrayView<TraceEvent>(events.begin() + 1, events.getSize() - 1),
+        containers);
+  } catch (const std::exception &error) {
+    std::fprintf(stderr, "%s\n", error.what());
+    return 1;
+  }
+
+  return 0;
+}